@@ -193,6 +193,59 @@
 #  * Mandatory : NO
 #  * Default   : FALSE
 #
+# .. variable:: CPACK_STAGING_MODE
+#
+#  How files are placed in the staging directories that CPack installs
+#  the project into before packaging.  Possible values are:
+#
+#  ``COPY``
+#   Every file is copied.  This is the default.
+#
+#  ``REFLINK``
+#   Files are cloned with copy-on-write reflinks when the build tree and
+#   the staging directory share a file system supporting it (e.g. Btrfs
+#   or XFS on Linux), and copied otherwise.
+#
+#  ``LINK``
+#   Like ``REFLINK`` but falls back to hard links before copying.  Hard
+#   links are only used for files installed with the permissions they
+#   already have, and never when :variable:`CPACK_STRIP_FILES` is set or
+#   the generator post-processes its staging tree (e.g. RPM).  Files whose
+#   RPATH is edited at install time get a private copy first, as do
+#   files that install scripts modify with :command:`file(WRITE)` or
+#   :command:`file(APPEND)`.  Other in-place edits of installed files,
+#   e.g. by tools run from ``install(CODE)``, would also change the
+#   files in the build tree.  See :variable:`CMAKE_INSTALL_STAGING_MODE`.
+#
+#  With ``REFLINK`` or ``LINK``, generators run by the same ``cpack``
+#  invocation that need an identical installation (same install prefix,
+#  components and options) clone the staging tree of the first one
+#  instead of running the installation again.  The installation counts
+#  as identical when all ``CPACK_*`` and ``CMAKE_INSTALL_*`` variables
+#  match, except for :variable:`CPACK_GENERATOR` and the directories and
+#  file names each generator picks for itself.  Install scripts that
+#  embed the staging path in installed files, or that test
+#  :variable:`CPACK_GENERATOR`, should not use this.
+#
+#  * Mandatory : NO
+#  * Default   : COPY
+#
+# .. variable:: CPACK_THREADS
+#
+#  Number of threads used to compress archives created by the TGZ, TBZ2
+#  and TXZ generators (and the matching source package generators).  When
+#  different from 1 the archive is cut into blocks that are compressed in
+#  parallel and stored as consecutive gzip members, bzip2 streams or xz
+#  streams.  Any conforming decompressor reads the result as one stream.
+#  A value of 0 uses one thread per logical processor, and larger values
+#  are limited to that.  Negative and non-numeric values are ignored with
+#  a warning and select one thread.  The archive layout depends only on
+#  whether the value is 1, not on the number of threads.  Other archive
+#  formats ignore this variable.
+#
+#  * Mandatory : NO
+#  * Default   : 1
+#
 # The following CPack variables are specific to source packages, and
 # will not affect binary packages:
 #
@@ -42,6 +42,12 @@ macro(__compiler_gnu lang)
     # internally, as it ought to.  Work around this bug by setting -MT here
     # even though it isn't strictly necessary.
     set(CMAKE_DEPFILE_FLAGS_${lang} "-MD -MT <OBJECT> -MF <DEPFILE>")
+    # Makefile generators include the depfile directly, so add phony
+    # targets for the headers to tolerate their removal.  Fortran needs
+    # the module dependencies only CMake's scanner provides.
+    if("${lang}" MATCHES "^(C|CXX)$")
+      set(CMAKE_MAKE_DEPFILE_FLAGS_${lang} "-MD -MP -MT <OBJECT> -MF <DEPFILE>")
+    endif()
   endif()
 
   # Initial configuration flags.
@@ -197,6 +197,16 @@ Create custom targets to build projects in external trees
   ``USES_TERMINAL_INSTALL 1``
     Give install terminal access.
 
+  The build step can be given access to the jobserver of the parent
+  build tool so that a nested ``make`` shares its job slots instead of
+  running serially or oversubscribing the machine.  With the Makefile
+  generators this marks the step as a recursive make invocation.  The
+  default build command already does this when it uses ``$(MAKE)``.
+  Options are:
+
+  ``BUILD_JOB_SERVER_AWARE 1``
+    Give build jobserver access.
+
   Other options are:
 
   ``STEP_TARGETS <step-target>...``
@@ -280,6 +290,9 @@ Create custom targets to build projects in external trees
     Wrap step in script to log output
   ``USES_TERMINAL 1``
     Give the step direct access to the terminal if possible.
+  ``JOB_SERVER_AWARE 1``
+    Give the step access to the jobserver of the parent build tool
+    if possible.
 
   The command line, comment, working directory, and byproducts of every
   standard and custom step are processed to replace tokens ``<SOURCE_DIR>``,
@@ -1530,6 +1543,15 @@ function(ExternalProject_Add_Step name step)
     set(uses_terminal "")
   endif()
 
+  # Uses the jobserver?
+  get_property(job_server_aware TARGET ${name} PROPERTY
+    _EP_${step}_JOB_SERVER_AWARE)
+  if(job_server_aware)
+    set(job_server_aware JOB_SERVER_AWARE)
+  else()
+    set(job_server_aware "")
+  endif()
+
   # Run every time?
   get_property(always TARGET ${name} PROPERTY _EP_${step}_ALWAYS)
   if(always)
@@ -1573,6 +1595,7 @@ function(ExternalProject_Add_Step name step)
     WORKING_DIRECTORY ${work_dir}
     VERBATIM
     ${uses_terminal}
+    ${job_server_aware}
     )
   set_property(TARGET ${name} APPEND PROPERTY _EP_STEPS ${step})
 
@@ -2309,6 +2332,14 @@ function(_ep_add_build_command name)
     set(uses_terminal "")
   endif()
 
+  get_property(job_server_aware TARGET ${name} PROPERTY
+    _EP_BUILD_JOB_SERVER_AWARE)
+  if(job_server_aware)
+    set(job_server_aware JOB_SERVER_AWARE 1)
+  else()
+    set(job_server_aware "")
+  endif()
+
   get_property(build_always TARGET ${name} PROPERTY _EP_BUILD_ALWAYS)
   if(build_always)
     set(always 1)
@@ -2326,6 +2357,7 @@ function(_ep_add_build_command name)
     ALWAYS ${always}
     ${log}
     ${uses_terminal}
+    ${job_server_aware}
     )
 endfunction()
 
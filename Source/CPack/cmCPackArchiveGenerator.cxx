@@ -18,6 +18,7 @@
 #include "cmMakefile.h"
 #include "cmGeneratedFileStream.h"
 #include "cmCPackLog.h"
+#include "cmWorkerPool.h"
 #include <errno.h>
 
 #include <cmsys/SystemTools.hxx>
@@ -107,7 +108,8 @@ if (!GenerateHeader(&gf)) \
             << ">." << std::endl); \
     return 0; \
   } \
-cmArchiveWrite archive(gf,this->Compress, this->ArchiveFormat); \
+cmArchiveWrite archive(gf,this->Compress, this->ArchiveFormat, \
+                       this->GetThreadCount()); \
 if (!archive) \
   { \
   cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem to create archive < " \
@@ -153,6 +155,10 @@ int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
           // Add the files of this component to the archive
           addOneComponentToArchive(archive,*compIt);
           }
+        if (!this->CloseArchive(archive, packageFileName))
+          {
+          return 0;
+          }
       }
       // add the generated package to package file names list
       packageFileNames.push_back(packageFileName);
@@ -185,6 +191,10 @@ int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
           DECLARE_AND_OPEN_ARCHIVE(packageFileName,archive);
           // Add the files of this component to the archive
           addOneComponentToArchive(archive,&(compIt->second));
+          if (!this->CloseArchive(archive, packageFileName))
+            {
+            return 0;
+            }
         }
         // add the generated package to package file names list
         packageFileNames.push_back(packageFileName);
@@ -212,6 +222,10 @@ int cmCPackArchiveGenerator::PackageComponents(bool ignoreGroup)
         DECLARE_AND_OPEN_ARCHIVE(packageFileName,archive);
         // Add the files of this component to the archive
         addOneComponentToArchive(archive,&(compIt->second));
+        if (!this->CloseArchive(archive, packageFileName))
+          {
+          return 0;
+          }
       }
       // add the generated package to package file names list
       packageFileNames.push_back(packageFileName);
@@ -244,8 +258,7 @@ int cmCPackArchiveGenerator::PackageComponentsAllInOne()
     addOneComponentToArchive(archive,&(compIt->second));
     }
 
-  // archive goes out of scope so it will finalized and closed.
-  return 1;
+  return this->CloseArchive(archive, packageFileNames[0]);
 }
 
 //----------------------------------------------------------------------
@@ -296,10 +309,62 @@ int cmCPackArchiveGenerator::PackageFiles()
       }
     }
   cmSystemTools::ChangeDirectory(dir);
-  // The destructor of cmArchiveWrite will close and finish the write
+  return this->CloseArchive(archive, packageFileNames[0]);
+}
+
+//----------------------------------------------------------------------
+int cmCPackArchiveGenerator::CloseArchive(cmArchiveWrite& archive,
+                                          std::string const& filename)
+{
+  if (!archive.Close())
+    {
+    cmCPackLogger(cmCPackLog::LOG_ERROR, "Problem while closing archive <"
+        << filename
+        << "> .ERROR ="
+        << archive.GetError()
+        << std::endl);
+    return 0;
+    }
   return 1;
 }
 
+//----------------------------------------------------------------------
+int cmCPackArchiveGenerator::GetThreadCount() const
+{
+  const char* threads = this->GetOption("CPACK_THREADS");
+  if (!threads || !*threads)
+    {
+    return 1;
+    }
+  long n = 1;
+  if (!cmSystemTools::StringToLong(threads, &n) || n < 0)
+    {
+    cmCPackLogger(cmCPackLog::LOG_WARNING,
+                  "Ignoring invalid CPACK_THREADS value: "
+                  << threads << std::endl);
+    return 1;
+    }
+  if (n != 1 && !cmArchiveWrite::SupportsThreads(this->Compress))
+    {
+    cmCPackLogger(cmCPackLog::LOG_DEBUG,
+                  "Compression does not support CPACK_THREADS, "
+                  "using one thread." << std::endl);
+    return 1;
+    }
+  // Any value other than one selects the block format, so the archive
+  // layout does not depend on the host.  Zero asks for one thread per
+  // logical processor, which also bounds larger requests.
+  long cpus = static_cast<long>(cmWorkerPool::GetNumberOfProcessors());
+  if (n > cpus)
+    {
+    cmCPackLogger(cmCPackLog::LOG_VERBOSE,
+                  "Limiting CPACK_THREADS=" << threads << " to the "
+                  << cpus << " logical processors." << std::endl);
+    return 0;
+    }
+  return static_cast<int>(n);
+}
+
 //----------------------------------------------------------------------
 int cmCPackArchiveGenerator::GenerateHeader(std::ostream*)
 {
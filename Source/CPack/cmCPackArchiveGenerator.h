@@ -66,6 +66,16 @@ protected:
    * components will be put in a single installer.
    */
   int PackageComponentsAllInOne();
+  /**
+   * Finish writing an archive and report any error, including one
+   * from compressing the last blocks.
+   */
+  int CloseArchive(cmArchiveWrite& archive, std::string const& filename);
+  /**
+   * Number of compression threads requested by CPACK_THREADS.
+   * Returns 1 when unset or when the compression type cannot be split.
+   */
+  int GetThreadCount() const;
   virtual const char* GetOutputExtension() = 0;
   cmArchiveWrite::Compress Compress;
   std::string ArchiveFormat;
@@ -19,6 +19,7 @@
 #include "cmGeneratedFileStream.h"
 #include "cmCPackComponentGroup.h"
 #include "cmXMLSafe.h"
+#include "cmAlgorithms.h"
 
 #include <cmsys/SystemTools.hxx>
 #include <cmsys/Glob.hxx>
@@ -540,6 +541,115 @@ int cmCPackGenerator::InstallProjectViaInstallScript(
   return 1;
 }
 
+//----------------------------------------------------------------------
+// Install trees staged earlier in this cpack run, indexed by a key
+// describing everything that influences the result of the installation.
+// A later generator asking for the same installation gets a linked
+// clone of the earlier tree instead of running the install again.
+struct cmCPackStagedInstall
+{
+  std::string Directory;
+  std::vector<std::string> Files;
+  std::string AbsoluteDestinationFiles;
+};
+static std::map<std::string, cmCPackStagedInstall> cmCPackStagedInstalls;
+
+//----------------------------------------------------------------------
+// Append the CPack and install settings visible to the install scripts
+// to a staging key.  Only the name of the generator and the locations
+// that every generator chooses for itself are left out.
+static void cmCPackAppendStagingSettings(cmMakefile* mf, std::string& key)
+{
+  static const char* ignored[] = {
+    "CPACK_GENERATOR",
+    "CPACK_OUTPUT_FILE_NAME",
+    "CPACK_OUTPUT_FILE_PATH",
+    "CPACK_OUTPUT_FILE_PREFIX",
+    "CPACK_TEMPORARY_DIRECTORY",
+    "CPACK_TEMPORARY_INSTALL_DIRECTORY",
+    "CPACK_TEMPORARY_PACKAGE_FILE_NAME",
+    "CPACK_TOPLEVEL_DIRECTORY",
+    "CPACK_TOPLEVEL_TAG",
+    "CMAKE_INSTALL_PREFIX",
+    "CMAKE_INSTALL_STAGING_MODE",
+    0
+  };
+  std::vector<std::string> names = mf->GetDefinitions();
+  std::sort(names.begin(), names.end());
+  for (std::vector<std::string>::const_iterator i = names.begin();
+       i != names.end(); ++i)
+    {
+    if (!cmHasLiteralPrefix(*i, "CPACK_") &&
+        !cmHasLiteralPrefix(*i, "CMAKE_INSTALL_"))
+      {
+      continue;
+      }
+    bool skip = false;
+    for (const char** n = ignored; *n && !skip; ++n)
+      {
+      skip = *i == *n;
+      }
+    if (!skip)
+      {
+      key += "\n";
+      key += *i;
+      key += "=";
+      key += mf->GetSafeDefinition(*i);
+      }
+    }
+}
+
+//----------------------------------------------------------------------
+static bool cmCPackCloneStagedInstall(cmCPackStagedInstall const& staged,
+                                      std::string const& destination,
+                                      bool hardLinks)
+{
+  // The paths are sorted so that directories come before their content.
+  for (std::vector<std::string>::const_iterator it = staged.Files.begin();
+       it != staged.Files.end(); ++it)
+    {
+    std::string from = staged.Directory + "/" + *it;
+    std::string to = destination + "/" + *it;
+    if (!cmSystemTools::MakeDirectory(
+          cmSystemTools::GetFilenamePath(to).c_str()))
+      {
+      return false;
+      }
+    if (cmSystemTools::FileIsSymlink(from))
+      {
+      std::string target;
+      cmSystemTools::RemoveFile(to);
+      if (!cmSystemTools::ReadSymlink(from, target) ||
+          !cmSystemTools::CreateSymlink(target, to))
+        {
+        return false;
+        }
+      }
+    else if (cmSystemTools::FileIsDirectory(from))
+      {
+      mode_t perm = 0;
+      if (!cmSystemTools::MakeDirectory(to.c_str()) ||
+          (cmSystemTools::GetPermissions(from.c_str(), perm) &&
+           !cmSystemTools::SetPermissions(to.c_str(), perm)))
+        {
+        return false;
+        }
+      }
+    else
+      {
+      cmSystemTools::RemoveFile(to);
+      if (!cmSystemTools::CloneFile(from, to) &&
+          !(hardLinks && cmSystemTools::CreateHardLink(from, to)) &&
+          !(cmSystemTools::CopyFileAlways(from, to) &&
+            cmSystemTools::CopyFileTime(from.c_str(), to.c_str())))
+        {
+        return false;
+        }
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------
 int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
   bool setDestDir, const std::string& baseTempInstallDirectory)
@@ -861,6 +971,27 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
           {
           mf->AddDefinition("CMAKE_INSTALL_DO_STRIP", "1");
           }
+
+        // Let file(INSTALL) share data with the build tree if requested.
+        // Remember how this tree was made so later generators of this
+        // run that need the same installation can reuse it.
+        std::string stagingMode = this->GetStagingMode();
+        std::string stagingKey;
+        if (stagingMode != "COPY")
+          {
+          mf->AddDefinition("CMAKE_INSTALL_STAGING_MODE",
+                            stagingMode.c_str());
+          std::ostringstream key;
+          key << installFile << "\n" << installComponent << "\n"
+              << installSubDirectory << "\n"
+              << this->GetPackagingInstallPrefix() << "\n"
+              << setDestDir << "\n"
+              << (setDestDir ?
+                  mf->GetSafeDefinition("CMAKE_INSTALL_PREFIX") : "")
+              << "\n" << buildConfig << "\n"
+              << mf->GetSafeDefinition("CMAKE_INSTALL_DO_STRIP");
+          stagingKey = key.str();
+          }
         // Remember the list of files before installation
         // of the current component (if we are in component install)
         const char* InstallPrefix = tempInstallDirectory.c_str();
@@ -894,8 +1025,75 @@ int cmCPackGenerator::InstallProjectViaInstallCMakeProjects(
             mf->AddDefinition("CMAKE_ERROR_ON_ABSOLUTE_INSTALL_DESTINATION",
                               "1");
           }
+        if (!stagingKey.empty())
+          {
+          // The install script behaves differently with these set.
+          stagingKey += "\n";
+          stagingKey +=
+            mf->GetSafeDefinition("CMAKE_WARN_ON_ABSOLUTE_INSTALL_DESTINATION");
+          stagingKey += "\n";
+          stagingKey += mf->GetSafeDefinition(
+            "CMAKE_ERROR_ON_ABSOLUTE_INSTALL_DESTINATION");
+          cmCPackAppendStagingSettings(mf.get(), stagingKey);
+          }
+        std::map<std::string, cmCPackStagedInstall>::const_iterator staged =
+          cmCPackStagedInstalls.find(stagingKey);
+        bool reused = false;
+        if (staged != cmCPackStagedInstalls.end() &&
+            staged->second.Directory != tempInstallDirectory &&
+            cmSystemTools::FileIsDirectory(staged->second.Directory))
+          {
+          cmCPackLogger(cmCPackLog::LOG_OUTPUT,
+                        "-   Reuse staged install from: "
+                        << staged->second.Directory << std::endl);
+          reused = cmCPackCloneStagedInstall(staged->second,
+                                             tempInstallDirectory,
+                                             stagingMode == "LINK");
+          if (!reused)
+            {
+            cmCPackLogger(cmCPackLog::LOG_WARNING,
+                          "Could not reuse staged install, "
+                          "installing again." << std::endl);
+            }
+          else if (!staged->second.AbsoluteDestinationFiles.empty())
+            {
+            mf->AddDefinition("CMAKE_ABSOLUTE_DESTINATION_FILES",
+              staged->second.AbsoluteDestinationFiles.c_str());
+            }
+          }
         // do installation
-        int res = mf->ReadListFile(installFile.c_str());
+        int res = 1;
+        if (!reused)
+          {
+          res = mf->ReadListFile(installFile.c_str());
+          }
+        if (!reused && res && !stagingKey.empty() &&
+            !this->MayModifyStagedFiles())
+          {
+          cmCPackStagedInstall& record = cmCPackStagedInstalls[stagingKey];
+          record.Directory = tempInstallDirectory;
+          record.AbsoluteDestinationFiles =
+            mf->GetSafeDefinition("CMAKE_ABSOLUTE_DESTINATION_FILES");
+          cmsys::Glob glS;
+          glS.RecurseOn();
+          glS.SetRecurseListDirs(true);
+          glS.FindFiles(findExpr + (componentInstall ? "" : "/*"));
+          std::vector<std::string> filesStaged = glS.GetFiles();
+          std::sort(filesStaged.begin(), filesStaged.end());
+          record.Files.clear();
+          std::vector<std::string>::iterator fit = filesStaged.begin();
+          for (; fit != filesStaged.end(); ++fit)
+            {
+            if (componentInstall &&
+                std::binary_search(filesBefore.begin(), filesBefore.end(),
+                                   *fit))
+              {
+              continue;
+              }
+            record.Files.push_back(
+              cmSystemTools::RelativePath(InstallPrefix, fit->c_str()));
+            }
+          }
         // forward definition of CMAKE_ABSOLUTE_DESTINATION_FILES
         // to CPack (may be used by generators like CPack RPM or DEB)
         // in order to transparently handle ABSOLUTE PATH
@@ -1505,6 +1703,42 @@ bool cmCPackGenerator::SupportsComponentInstallation() const
   return false;
 }
 
+//----------------------------------------------------------------------
+bool cmCPackGenerator::MayModifyStagedFiles() const
+{
+  return false;
+}
+
+//----------------------------------------------------------------------
+std::string cmCPackGenerator::GetStagingMode() const
+{
+  std::string mode =
+    cmSystemTools::UpperCase(this->GetOption("CPACK_STAGING_MODE") ?
+                             this->GetOption("CPACK_STAGING_MODE") : "");
+  if (mode == "LINK")
+    {
+    // Stripping and generator post-processing may rewrite files in
+    // place, which would show through a hard link.
+    if (this->MayModifyStagedFiles() ||
+        !cmSystemTools::IsOff(this->GetOption("CPACK_STRIP_FILES")))
+      {
+      return "REFLINK";
+      }
+    return mode;
+    }
+  if (mode == "REFLINK")
+    {
+    return mode;
+    }
+  if (!mode.empty() && mode != "COPY")
+    {
+    cmCPackLogger(cmCPackLog::LOG_WARNING,
+                  "Unknown CPACK_STAGING_MODE value \"" << mode
+                  << "\", using COPY." << std::endl);
+    }
+  return "COPY";
+}
+
 //----------------------------------------------------------------------
 bool cmCPackGenerator::WantsComponentInstallation() const
 {
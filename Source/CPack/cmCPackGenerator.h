@@ -242,6 +242,23 @@ protected:
    * @return true if supported, false otherwise
    */
   virtual bool SupportsComponentInstallation() const;
+
+  /**
+   * Does the CPack generator (or the tool it drives) modify the files
+   * of the staging tree in place after installation?
+   * Such a generator must not share file data with the build tree or
+   * with the staging trees of other generators through hard links.
+   * @return true if staged files may be modified, false otherwise
+   */
+  virtual bool MayModifyStagedFiles() const;
+
+  /**
+   * How installed files share data with their source, as selected by
+   * CPACK_STAGING_MODE and restricted by what the generator allows.
+   * @return one of "COPY", "REFLINK" or "LINK"
+   */
+  std::string GetStagingMode() const;
+
   /**
    * Does the currently running generator want a component installation.
    * The generator may support component installation but he may
@@ -258,6 +258,13 @@ bool cmCPackRPMGenerator::SupportsComponentInstallation() const
     }
   }
 
+bool cmCPackRPMGenerator::MayModifyStagedFiles() const
+  {
+  // rpmbuild uses the staging tree as its buildroot and its
+  // post-install scripts may strip or compress files there.
+  return true;
+  }
+
 std::string cmCPackRPMGenerator::GetComponentInstallDirNameSuffix(
     const std::string& componentName)
   {
@@ -69,6 +69,7 @@ protected:
   int PackageComponentsAllInOne();
   virtual const char* GetOutputExtension() { return ".rpm"; }
   virtual bool SupportsComponentInstallation() const;
+  virtual bool MayModifyStagedFiles() const;
   virtual std::string GetComponentInstallDirNameSuffix(
       const std::string& componentName);
 
@@ -400,8 +400,11 @@ int cmCTestBuildHandler::ProcessHandler()
   // Pre-compile regular expressions objects for all regular expressions
   std::vector<std::string>::iterator it;
 
-#define cmCTestBuildHandlerPopulateRegexVector(strings, regexes) \
+  this->ScrapeLiterals.clear();
+
+#define cmCTestBuildHandlerPopulateRegexVector(strings, regexes, literals) \
   regexes.clear(); \
+  literals.clear(); \
     cmCTestOptionalLog(this->CTest, DEBUG, this << "Add " #regexes \
     << std::endl, this->Quiet); \
   for ( it = strings.begin(); it != strings.end(); ++it ) \
@@ -409,15 +412,21 @@ int cmCTestBuildHandler::ProcessHandler()
     cmCTestOptionalLog(this->CTest, DEBUG, "Add " #strings ": " \
     << *it << std::endl, this->Quiet); \
     regexes.push_back(it->c_str()); \
+    literals.push_back(this->AddScrapeLiteral(*it)); \
     }
   cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomErrorMatches, this->ErrorMatchRegex);
+    this->CustomErrorMatches, this->ErrorMatchRegex,
+    this->ErrorMatchLiterals);
   cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomErrorExceptions, this->ErrorExceptionRegex);
+    this->CustomErrorExceptions, this->ErrorExceptionRegex,
+    this->ErrorExceptionLiterals);
   cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomWarningMatches, this->WarningMatchRegex);
+    this->CustomWarningMatches, this->WarningMatchRegex,
+    this->WarningMatchLiterals);
   cmCTestBuildHandlerPopulateRegexVector(
-    this->CustomWarningExceptions, this->WarningExceptionRegex);
+    this->CustomWarningExceptions, this->WarningExceptionRegex,
+    this->WarningExceptionLiterals);
+  this->ScrapeLiteralsFound.resize(this->ScrapeLiterals.size());
 
 
   // Determine source and binary tree substitutions to simplify the output.
@@ -1197,6 +1206,137 @@ void cmCTestBuildHandler::ProcessBuffer(const char* data, int length,
   ofs << cmCTestLogWrite(data, length);
 }
 
+//----------------------------------------------------------------------
+int cmCTestBuildHandler::AddScrapeLiteral(std::string const& regex)
+{
+  // Find the longest run of literal characters outside of groups that
+  // every match of the expression must contain.  Give up on top-level
+  // alternatives.
+  std::string best;
+  std::string run;
+  int depth = 0;
+  for(std::string::size_type i = 0; i < regex.size(); ++i)
+    {
+    char c = regex[i];
+    bool literal = false;
+    switch(c)
+      {
+      case '|':
+        if(depth == 0)
+          {
+          return -1;
+          }
+        break;
+      case '\\':
+        if(i+1 < regex.size())
+          {
+          c = regex[++i];
+          literal = true;
+          }
+        break;
+      case '[':
+        // Skip the bracket expression.  A ']' right after the opening
+        // '[' or '[^' is part of the set.
+        ++i;
+        if(i < regex.size() && regex[i] == '^')
+          {
+          ++i;
+          }
+        if(i < regex.size() && regex[i] == ']')
+          {
+          ++i;
+          }
+        while(i < regex.size() && regex[i] != ']')
+          {
+          ++i;
+          }
+        break;
+      case '(':
+        ++depth;
+        break;
+      case ')':
+        --depth;
+        break;
+      case '*':
+      case '?':
+        // The previous character is optional.
+        if(!run.empty())
+          {
+          run.erase(run.size()-1);
+          }
+        break;
+      case '+':
+      case '^':
+      case '$':
+      case '.':
+        break;
+      default:
+        literal = true;
+        break;
+      }
+    if(literal && depth == 0)
+      {
+      run += c;
+      }
+    else
+      {
+      if(run.size() > best.size())
+        {
+        best = run;
+        }
+      run = "";
+      }
+    }
+  if(run.size() > best.size())
+    {
+    best = run;
+    }
+  if(best.empty())
+    {
+    return -1;
+    }
+
+  // Share the literal with other expressions that need it.
+  std::vector<std::string>::iterator l =
+    std::find(this->ScrapeLiterals.begin(), this->ScrapeLiterals.end(), best);
+  if(l == this->ScrapeLiterals.end())
+    {
+    this->ScrapeLiterals.push_back(best);
+    return static_cast<int>(this->ScrapeLiterals.size()) - 1;
+    }
+  return static_cast<int>(l - this->ScrapeLiterals.begin());
+}
+
+//----------------------------------------------------------------------
+int cmCTestBuildHandler::FindScrapeMatch(const char* data,
+  std::vector<cmsys::RegularExpression>& regexps,
+  std::vector<int> const& literals)
+{
+  for(std::vector<cmsys::RegularExpression>::size_type i = 0;
+      i < regexps.size(); ++i)
+    {
+    // Skip the expression if the line lacks text it requires.
+    int l = literals[i];
+    if(l >= 0)
+      {
+      char& found = this->ScrapeLiteralsFound[l];
+      if(!found)
+        {
+        found = strstr(data, this->ScrapeLiterals[l].c_str())? 1 : 2;
+        }
+      if(found != 1)
+        {
+        continue;
+        }
+      }
+    if(regexps[i].find(data))
+      {
+      return static_cast<int>(i);
+      }
+    }
+  return -1;
+}
+
 //----------------------------------------------------------------------
 int cmCTestBuildHandler::ProcessSingleLine(const char* data)
 {
@@ -1209,83 +1349,63 @@ int cmCTestBuildHandler::ProcessSingleLine(const char* data)
   cmCTestOptionalLog(this->CTest, DEBUG, "Line: [" << data << "]" <<
     std::endl, this->Quiet);
 
-  std::vector<cmsys::RegularExpression>::iterator it;
-
   int warningLine = 0;
   int errorLine = 0;
 
+  // Each distinct literal is searched for at most once per line.
+  std::fill(this->ScrapeLiteralsFound.begin(),
+            this->ScrapeLiteralsFound.end(), 0);
+
   // Check for regular expressions
 
   if ( !this->ErrorQuotaReached )
     {
     // Errors
-    int wrxCnt = 0;
-    for ( it = this->ErrorMatchRegex.begin();
-      it != this->ErrorMatchRegex.end();
-      ++ it )
-      {
-      if ( it->find(data) )
-        {
-        errorLine = 1;
-        cmCTestOptionalLog(this->CTest, DEBUG, "  Error Line: " << data
-          << " (matches: " << this->CustomErrorMatches[wrxCnt] << ")"
-          << std::endl, this->Quiet);
-        break;
-        }
-      wrxCnt ++;
-      }
-    // Error exceptions
-    wrxCnt = 0;
-    for ( it = this->ErrorExceptionRegex.begin();
-      it != this->ErrorExceptionRegex.end();
-      ++ it )
+    int wrxCnt = this->FindScrapeMatch(data, this->ErrorMatchRegex,
+                                       this->ErrorMatchLiterals);
+    if ( wrxCnt >= 0 )
       {
-      if ( it->find(data) )
+      errorLine = 1;
+      cmCTestOptionalLog(this->CTest, DEBUG, "  Error Line: " << data
+        << " (matches: " << this->CustomErrorMatches[wrxCnt] << ")"
+        << std::endl, this->Quiet);
+
+      // Error exceptions
+      wrxCnt = this->FindScrapeMatch(data, this->ErrorExceptionRegex,
+                                     this->ErrorExceptionLiterals);
+      if ( wrxCnt >= 0 )
         {
         errorLine = 0;
         cmCTestOptionalLog(this->CTest, DEBUG, "  Not an error Line: " << data
           << " (matches: " << this->CustomErrorExceptions[wrxCnt] << ")"
           << std::endl, this->Quiet);
-        break;
         }
-      wrxCnt ++;
       }
     }
-  if ( !this->WarningQuotaReached )
+  if ( !errorLine && !this->WarningQuotaReached )
     {
     // Warnings
-    int wrxCnt = 0;
-    for ( it = this->WarningMatchRegex.begin();
-      it != this->WarningMatchRegex.end();
-      ++ it )
+    int wrxCnt = this->FindScrapeMatch(data, this->WarningMatchRegex,
+                                       this->WarningMatchLiterals);
+    if ( wrxCnt >= 0 )
       {
-      if ( it->find(data) )
-        {
-        warningLine = 1;
-        cmCTestOptionalLog(this->CTest, DEBUG,
-          "  Warning Line: " << data
-          << " (matches: " << this->CustomWarningMatches[wrxCnt] << ")"
-          << std::endl, this->Quiet);
-        break;
-        }
-      wrxCnt ++;
-      }
-
-    wrxCnt = 0;
-    // Warning exceptions
-    for ( it = this->WarningExceptionRegex.begin();
-      it != this->WarningExceptionRegex.end();
-      ++ it )
-      {
-      if ( it->find(data) )
+      warningLine = 1;
+      cmCTestOptionalLog(this->CTest, DEBUG,
+        "  Warning Line: " << data
+        << " (matches: " << this->CustomWarningMatches[wrxCnt] << ")"
+        << std::endl, this->Quiet);
+
+      // Warning exceptions
+      wrxCnt = this->FindScrapeMatch(data, this->WarningExceptionRegex,
+                                     this->WarningExceptionLiterals);
+      if ( wrxCnt >= 0 )
         {
         warningLine = 0;
-        cmCTestOptionalLog(this->CTest, DEBUG, "  Not a warning Line: " << data
+        cmCTestOptionalLog(this->CTest, DEBUG, "  Not a warning Line: "
+          << data
           << " (matches: " << this->CustomWarningExceptions[wrxCnt] << ")"
           << std::endl, this->Quiet);
-        break;
         }
-      wrxCnt ++;
       }
     }
   if ( errorLine )
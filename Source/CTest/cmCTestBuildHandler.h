@@ -112,6 +112,20 @@ private:
   std::vector<cmsys::RegularExpression> WarningMatchRegex;
   std::vector<cmsys::RegularExpression> WarningExceptionRegex;
 
+  // Literal text a line must contain for each of the above expressions
+  // to match, as an index into ScrapeLiterals or -1 if there is none.
+  // A line is searched for each distinct literal at most once.
+  std::vector<std::string> ScrapeLiterals;
+  std::vector<char> ScrapeLiteralsFound;
+  std::vector<int> ErrorMatchLiterals;
+  std::vector<int> ErrorExceptionLiterals;
+  std::vector<int> WarningMatchLiterals;
+  std::vector<int> WarningExceptionLiterals;
+  int AddScrapeLiteral(std::string const& regex);
+  int FindScrapeMatch(const char* data,
+                      std::vector<cmsys::RegularExpression>& regexps,
+                      std::vector<int> const& literals);
+
   typedef std::deque<char> t_BuildProcessingQueueType;
 
   void ProcessBuffer(const char* data, int length, size_t& tick,
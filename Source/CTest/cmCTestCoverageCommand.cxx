@@ -41,6 +41,12 @@ cmCTestGenericHandler* cmCTestCoverageCommand::InitializeHandler()
     handler->SetLabelFilter(this->Labels);
     }
 
+  // If a PARALLEL_LEVEL option was given, run that many gcov processes.
+  if(!this->ParallelLevel.empty())
+    {
+    handler->SetOption("ParallelLevel", this->ParallelLevel.c_str());
+    }
+
   handler->SetQuiet(this->Quiet);
   return handler;
 }
@@ -55,6 +61,11 @@ bool cmCTestCoverageCommand::CheckArgumentKeyword(std::string const& arg)
     this->LabelsMentioned = true;
     return true;
     }
+  if(arg == "PARALLEL_LEVEL")
+    {
+    this->ArgumentDoing = ArgumentDoingParallelLevel;
+    return true;
+    }
 
   // Look for other arguments.
   return this->Superclass::CheckArgumentKeyword(arg);
@@ -69,6 +80,12 @@ bool cmCTestCoverageCommand::CheckArgumentValue(std::string const& arg)
     this->Labels.insert(arg);
     return true;
     }
+  if(this->ArgumentDoing == ArgumentDoingParallelLevel)
+    {
+    this->ParallelLevel = arg;
+    this->ArgumentDoing = ArgumentDoingNone;
+    return true;
+    }
 
   // Look for other arguments.
   return this->Superclass::CheckArgumentValue(arg);
@@ -52,11 +52,13 @@ protected:
   enum
   {
     ArgumentDoingLabels = Superclass::ArgumentDoingLast1,
+    ArgumentDoingParallelLevel,
     ArgumentDoingLast2
   };
 
   bool LabelsMentioned;
   std::set<std::string> Labels;
+  std::string ParallelLevel;
 };
 
 
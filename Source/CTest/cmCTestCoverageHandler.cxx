@@ -122,9 +122,61 @@ public:
       return this->PipeState;
     }
   int GetProcessState() { return this->PipeState;}
+  // Store output available within the timeout (none to block).
+  // Returns false once the process has closed its pipes.
+  bool ReadOutput(double* timeout)
+    {
+      char* data;
+      int length;
+      for(;;)
+        {
+        int p = cmsysProcess_WaitForData(this->Process, &data, &length,
+                                         timeout);
+        if(p == cmsysProcess_Pipe_STDOUT)
+          {
+          this->Output.append(data, length);
+          }
+        else if(p == cmsysProcess_Pipe_STDERR)
+          {
+          this->Errors.append(data, length);
+          }
+        else
+          {
+          return p == cmsysProcess_Pipe_Timeout;
+          }
+        }
+    }
+  std::string const& GetOutput() const { return this->Output; }
+  std::string const& GetErrors() const { return this->Errors; }
+  // Wait for exit.  Returns true with the exit code if the process ran
+  // to completion, or false with a description of the failure appended.
+  bool Finish(int& exitValue, std::string& errors)
+    {
+      this->WaitForExit();
+      switch(cmsysProcess_GetState(this->Process))
+        {
+        case cmsysProcess_State_Exited:
+          exitValue = cmsysProcess_GetExitValue(this->Process);
+          return true;
+        case cmsysProcess_State_Exception:
+          errors += cmsysProcess_GetExceptionString(this->Process);
+          break;
+        case cmsysProcess_State_Error:
+          errors += cmsysProcess_GetErrorString(this->Process);
+          break;
+        case cmsysProcess_State_Expired:
+          errors += "Process terminated due to timeout";
+          break;
+        default:
+          break;
+        }
+      return false;
+    }
 private:
   int PipeState;
   cmsysProcess* Process;
+  std::string Output;
+  std::string Errors;
   std::vector<std::string> CommandLineStrings;
   std::string WorkingDirectory;
   double TimeOut;
@@ -1050,6 +1102,45 @@ int cmCTestCoverageHandler::HandleBlanketJSCoverage(
     }
   return static_cast<int>(cont->TotalCoverage.size());
   }
+//----------------------------------------------------------------------
+// One gcov invocation, possibly running concurrently with others.
+struct cmCTestCoverageHandlerGCovRun
+{
+  std::string DataFile;
+  std::string Directory;
+  std::string Command;
+  cmCTestRunProcess Process;
+};
+
+//----------------------------------------------------------------------
+// The expressions matching the lines of gcov output, compiled once for
+// all gcov runs.
+struct cmCTestCoverageHandlerGCovRegex
+{
+  cmCTestCoverageHandlerGCovRegex():
+    // Style 1
+    st1re1("[0-9]+\\.[0-9]+% of [0-9]+ (source |)lines executed in file "
+           "(.*)$"),
+    st1re2("^Creating (.*\\.gcov)\\."),
+    // Style 2
+    st2re1("^File *[`'](.*)'$"),
+    st2re2("Lines executed: *[0-9]+\\.[0-9]+% of [0-9]+$"),
+    st2re3("^(.*)reating [`'](.*\\.gcov)'"),
+    st2re4("^(.*):unexpected EOF *$"),
+    st2re5("^(.*):cannot open source file*$"),
+    st2re6("^(.*):source file is newer than graph file `(.*)'$")
+    {
+    }
+  cmsys::RegularExpression st1re1;
+  cmsys::RegularExpression st1re2;
+  cmsys::RegularExpression st2re1;
+  cmsys::RegularExpression st2re2;
+  cmsys::RegularExpression st2re3;
+  cmsys::RegularExpression st2re4;
+  cmsys::RegularExpression st2re5;
+  cmsys::RegularExpression st2re6;
+};
+
 //----------------------------------------------------------------------
 int cmCTestCoverageHandler::HandleGCovCoverage(
   cmCTestCoverageHandlerContainer* cont)
@@ -1072,30 +1163,6 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
     return 0;
     }
 
-  // Style 1
-  std::string st1gcovOutputRex1
-    = "[0-9]+\\.[0-9]+% of [0-9]+ (source |)lines executed in file (.*)$";
-  std::string st1gcovOutputRex2 = "^Creating (.*\\.gcov)\\.";
-  cmsys::RegularExpression st1re1(st1gcovOutputRex1.c_str());
-  cmsys::RegularExpression st1re2(st1gcovOutputRex2.c_str());
-
-
-  // Style 2
-  std::string st2gcovOutputRex1 = "^File *[`'](.*)'$";
-  std::string st2gcovOutputRex2
-    = "Lines executed: *[0-9]+\\.[0-9]+% of [0-9]+$";
-  std::string st2gcovOutputRex3 = "^(.*)reating [`'](.*\\.gcov)'";
-  std::string st2gcovOutputRex4 = "^(.*):unexpected EOF *$";
-  std::string st2gcovOutputRex5 = "^(.*):cannot open source file*$";
-  std::string st2gcovOutputRex6
-    = "^(.*):source file is newer than graph file `(.*)'$";
-  cmsys::RegularExpression st2re1(st2gcovOutputRex1.c_str());
-  cmsys::RegularExpression st2re2(st2gcovOutputRex2.c_str());
-  cmsys::RegularExpression st2re3(st2gcovOutputRex3.c_str());
-  cmsys::RegularExpression st2re4(st2gcovOutputRex4.c_str());
-  cmsys::RegularExpression st2re5(st2gcovOutputRex5.c_str());
-  cmsys::RegularExpression st2re6(st2gcovOutputRex6.c_str());
-
   std::vector<std::string> files;
   this->FindGCovFiles(files);
   std::vector<std::string>::iterator it;
@@ -1115,11 +1182,42 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
   cmSystemTools::MakeDirectory(tempDir.c_str());
   cmSystemTools::ChangeDirectory(tempDir);
 
+  // Several gcov processes may run at once.  Each one gets a private
+  // working directory because gcov names its output after the source
+  // file, so two data files using the same header would collide.
+  int parallelLevel = this->CTest->GetParallelLevel();
+  if(const char* level = this->GetOption("ParallelLevel"))
+    {
+    parallelLevel = atoi(level);
+    }
+  if(parallelLevel < 1)
+    {
+    parallelLevel = 1;
+    }
+  std::vector<std::string> freeDirectories;
+  if(parallelLevel == 1)
+    {
+    freeDirectories.push_back(tempDir);
+    }
+  else
+    {
+    for(int i = parallelLevel; i > 0; --i)
+      {
+      std::ostringstream dir;
+      dir << tempDir << "/gcov" << i;
+      cmSystemTools::MakeDirectory(dir.str().c_str());
+      freeDirectories.push_back(dir.str());
+      }
+    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+      "   Running up to " << parallelLevel << " gcov processes at once"
+      << std::endl, this->Quiet);
+    }
+
   int gcovStyle = 0;
+  cmCTestCoverageHandlerGCovRegex re;
 
   std::set<std::string> missingFiles;
 
-  std::string actualSourceFile = "";
   cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT,
     "   Processing coverage (each . represents one file):" << std::endl,
     this->Quiet);
@@ -1134,362 +1232,429 @@ int cmCTestCoverageHandler::HandleGCovCoverage(
   // These are binary files that you give as input to gcov so that it will
   // give us text output we can analyze to summarize coverage.
   //
-  for ( it = files.begin(); it != files.end(); ++ it )
+  std::vector<cmCTestCoverageHandlerGCovRun*> running;
+  it = files.begin();
+  while ( it != files.end() || !running.empty() )
     {
-    cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "." << std::flush,
-      this->Quiet);
-
-    // Call gcov to get coverage data for this *.gcda file:
+    // Call gcov to get coverage data for as many *.gcda files as there
+    // are free working directories:
     //
-    std::string fileDir = cmSystemTools::GetFilenamePath(*it);
-    std::string command = "\"" + gcovCommand + "\" " +
-      gcovExtraFlags + " " +
-      "-o \"" + fileDir + "\" " +
-      "\"" + *it + "\"";
+    for ( ; it != files.end() && !freeDirectories.empty(); ++ it )
+      {
+      std::string fileDir = cmSystemTools::GetFilenamePath(*it);
+      std::string command = "\"" + gcovCommand + "\" " +
+        gcovExtraFlags + " " +
+        "-o \"" + fileDir + "\" " +
+        "\"" + *it + "\"";
 
-    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT, command.c_str()
-      << std::endl, this->Quiet);
+      cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT, command.c_str()
+        << std::endl, this->Quiet);
 
-    std::string output = "";
-    std::string errors = "";
-    int retVal = 0;
-    *cont->OFS << "* Run coverage for: " << fileDir << std::endl;
-    *cont->OFS << "  Command: " << command << std::endl;
-    int res = this->CTest->RunCommand(command.c_str(), &output, &errors,
-      &retVal, tempDir.c_str(), 0 /*this->TimeOut*/);
+      cmCTestCoverageHandlerGCovRun* run = new cmCTestCoverageHandlerGCovRun;
+      run->DataFile = *it;
+      run->Directory = freeDirectories.back();
+      run->Command = command;
+      freeDirectories.pop_back();
 
-    *cont->OFS << "  Output: " << output << std::endl;
-    *cont->OFS << "  Errors: " << errors << std::endl;
-    if ( ! res )
-      {
-      cmCTestLog(this->CTest, ERROR_MESSAGE,
-        "Problem running coverage on file: " << *it << std::endl);
-      cmCTestLog(this->CTest, ERROR_MESSAGE,
-        "Command produced error: " << errors << std::endl);
-      cont->Error ++;
-      continue;
+      std::vector<std::string> args =
+        cmSystemTools::ParseArguments(command.c_str());
+      for(std::vector<std::string>::const_iterator a = args.begin();
+          a != args.end(); ++a)
+        {
+        run->Process.AddArgument(a->c_str());
+        }
+      run->Process.SetWorkingDirectory(run->Directory.c_str());
+      run->Process.StartProcess();
+      running.push_back(run);
       }
-    if ( retVal != 0 )
+
+    // Collect output.  Block on the only running process, otherwise
+    // poll each of them briefly so that no pipe fills up.
+    std::vector<cmCTestCoverageHandlerGCovRun*> stillRunning;
+    for(std::vector<cmCTestCoverageHandlerGCovRun*>::iterator ri =
+          running.begin(); ri != running.end(); ++ri)
       {
-      cmCTestLog(this->CTest, ERROR_MESSAGE, "Coverage command returned: "
-        << retVal << " while processing: " << *it << std::endl);
-      cmCTestLog(this->CTest, ERROR_MESSAGE,
-        "Command produced error: " << cont->Error << std::endl);
+      cmCTestCoverageHandlerGCovRun* run = *ri;
+      double timeout = 0.01;
+      if(run->Process.ReadOutput(running.size() == 1? 0 : &timeout))
+        {
+        stillRunning.push_back(run);
+        continue;
+        }
+
+      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "." << std::flush,
+        this->Quiet);
+      this->ProcessGCovRun(cont, *run, re, gcovStyle, missingFiles);
+      freeDirectories.push_back(run->Directory);
+      delete run;
+
+      file_count++;
+
+      if ( file_count % 50 == 0 )
+        {
+        cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, " processed: "
+          << file_count
+          << " out of " << files.size() << std::endl, this->Quiet);
+        cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
+        }
       }
-    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-      "--------------------------------------------------------------"
-      << std::endl
-      << output << std::endl
-      << "--------------------------------------------------------------"
-      << std::endl, this->Quiet);
+    running.swap(stillRunning);
+    }
 
-    std::vector<std::string> lines;
-    std::vector<std::string>::iterator line;
+  cmSystemTools::ChangeDirectory(currentDirectory);
+  return file_count;
+}
 
-    cmSystemTools::Split(output.c_str(), lines);
+//----------------------------------------------------------------------
+void cmCTestCoverageHandler::ProcessGCovRun(
+  cmCTestCoverageHandlerContainer* cont,
+  cmCTestCoverageHandlerGCovRun& run,
+  cmCTestCoverageHandlerGCovRegex& re,
+  int& gcovStyle, std::set<std::string>& missingFiles)
+{
+  std::string fileDir = cmSystemTools::GetFilenamePath(run.DataFile);
+  std::string const& output = run.Process.GetOutput();
+  std::string errors = run.Process.GetErrors();
+  int retVal = 0;
+  bool res = run.Process.Finish(retVal, errors);
+
+  *cont->OFS << "* Run coverage for: " << fileDir << std::endl;
+  *cont->OFS << "  Command: " << run.Command << std::endl;
+  *cont->OFS << "  Output: " << output << std::endl;
+  *cont->OFS << "  Errors: " << errors << std::endl;
+  if ( ! res )
+    {
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+      "Problem running coverage on file: " << run.DataFile << std::endl);
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+      "Command produced error: " << errors << std::endl);
+    cont->Error ++;
+    return;
+    }
+  if ( retVal != 0 )
+    {
+    cmCTestLog(this->CTest, ERROR_MESSAGE, "Coverage command returned: "
+      << retVal << " while processing: " << run.DataFile << std::endl);
+    cmCTestLog(this->CTest, ERROR_MESSAGE,
+      "Command produced error: " << cont->Error << std::endl);
+    }
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+    "--------------------------------------------------------------"
+    << std::endl
+    << output << std::endl
+    << "--------------------------------------------------------------"
+    << std::endl, this->Quiet);
 
-    for ( line = lines.begin(); line != lines.end(); ++line)
-      {
-      std::string sourceFile;
-      std::string gcovFile;
+  this->ParseGCovOutput(cont, output, run.Directory, re,
+                        gcovStyle, missingFiles);
+}
 
-      cmCTestOptionalLog(this->CTest, DEBUG, "Line: [" << *line << "]"
-        << std::endl, this->Quiet);
+//----------------------------------------------------------------------
+void cmCTestCoverageHandler::ParseGCovOutput(
+  cmCTestCoverageHandlerContainer* cont,
+  std::string const& output, std::string const& gcovDir,
+  cmCTestCoverageHandlerGCovRegex& re,
+  int& gcovStyle, std::set<std::string>& missingFiles)
+{
+  std::string actualSourceFile = "";
 
-      if (line->empty())
+  std::vector<std::string> lines;
+  std::vector<std::string>::iterator line;
+
+  cmSystemTools::Split(output.c_str(), lines);
+
+  for ( line = lines.begin(); line != lines.end(); ++line)
+    {
+    std::string sourceFile;
+    std::string gcovFile;
+
+    cmCTestOptionalLog(this->CTest, DEBUG, "Line: [" << *line << "]"
+      << std::endl, this->Quiet);
+
+    if (line->empty())
+      {
+      // Ignore empty line; probably style 2
+      }
+    else if ( re.st1re1.find(line->c_str()) )
+      {
+      if ( gcovStyle == 0 )
         {
-        // Ignore empty line; probably style 2
+        gcovStyle = 1;
         }
-      else if ( st1re1.find(line->c_str()) )
+      if ( gcovStyle != 1 )
         {
-        if ( gcovStyle == 0 )
-          {
-          gcovStyle = 1;
-          }
-        if ( gcovStyle != 1 )
-          {
-          cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e1"
-            << std::endl);
-          cont->Error ++;
-          break;
-          }
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e1"
+          << std::endl);
+        cont->Error ++;
+        break;
+        }
 
-        actualSourceFile = "";
-        sourceFile = st1re1.match(2);
+      actualSourceFile = "";
+      sourceFile = re.st1re1.match(2);
+      }
+    else if ( re.st1re2.find(line->c_str() ) )
+      {
+      if ( gcovStyle == 0 )
+        {
+        gcovStyle = 1;
         }
-      else if ( st1re2.find(line->c_str() ) )
+      if ( gcovStyle != 1 )
         {
-        if ( gcovStyle == 0 )
-          {
-          gcovStyle = 1;
-          }
-        if ( gcovStyle != 1 )
-          {
-          cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e2"
-            << std::endl);
-          cont->Error ++;
-          break;
-          }
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e2"
+          << std::endl);
+        cont->Error ++;
+        break;
+        }
 
-        gcovFile = st1re2.match(1);
+      gcovFile = re.st1re2.match(1);
+      }
+    else if ( re.st2re1.find(line->c_str() ) )
+      {
+      if ( gcovStyle == 0 )
+        {
+        gcovStyle = 2;
         }
-      else if ( st2re1.find(line->c_str() ) )
+      if ( gcovStyle != 2 )
         {
-        if ( gcovStyle == 0 )
-          {
-          gcovStyle = 2;
-          }
-        if ( gcovStyle != 2 )
-          {
-          cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e3"
-            << std::endl);
-          cont->Error ++;
-          break;
-          }
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e3"
+          << std::endl);
+        cont->Error ++;
+        break;
+        }
 
-        actualSourceFile = "";
-        sourceFile = st2re1.match(1);
+      actualSourceFile = "";
+      sourceFile = re.st2re1.match(1);
+      }
+    else if ( re.st2re2.find(line->c_str() ) )
+      {
+      if ( gcovStyle == 0 )
+        {
+        gcovStyle = 2;
         }
-      else if ( st2re2.find(line->c_str() ) )
+      if ( gcovStyle != 2 )
         {
-        if ( gcovStyle == 0 )
-          {
-          gcovStyle = 2;
-          }
-        if ( gcovStyle != 2 )
-          {
-          cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e4"
-            << std::endl);
-          cont->Error ++;
-          break;
-          }
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e4"
+          << std::endl);
+        cont->Error ++;
+        break;
         }
-      else if ( st2re3.find(line->c_str() ) )
+      }
+    else if ( re.st2re3.find(line->c_str() ) )
+      {
+      if ( gcovStyle == 0 )
         {
-        if ( gcovStyle == 0 )
-          {
-          gcovStyle = 2;
-          }
-        if ( gcovStyle != 2 )
-          {
-          cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e5"
-            << std::endl);
-          cont->Error ++;
-          break;
-          }
-
-        gcovFile = st2re3.match(2);
+        gcovStyle = 2;
         }
-      else if ( st2re4.find(line->c_str() ) )
+      if ( gcovStyle != 2 )
         {
-        if ( gcovStyle == 0 )
-          {
-          gcovStyle = 2;
-          }
-        if ( gcovStyle != 2 )
-          {
-          cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e6"
-            << std::endl);
-          cont->Error ++;
-          break;
-          }
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e5"
+          << std::endl);
+        cont->Error ++;
+        break;
+        }
 
-        cmCTestOptionalLog(this->CTest, WARNING, "Warning: " << st2re4.match(1)
-          << " had unexpected EOF" << std::endl, this->Quiet);
+      gcovFile = re.st2re3.match(2);
+      }
+    else if ( re.st2re4.find(line->c_str() ) )
+      {
+      if ( gcovStyle == 0 )
+        {
+        gcovStyle = 2;
         }
-      else if ( st2re5.find(line->c_str() ) )
+      if ( gcovStyle != 2 )
         {
-        if ( gcovStyle == 0 )
-          {
-          gcovStyle = 2;
-          }
-        if ( gcovStyle != 2 )
-          {
-          cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e7"
-            << std::endl);
-          cont->Error ++;
-          break;
-          }
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e6"
+          << std::endl);
+        cont->Error ++;
+        break;
+        }
 
-        cmCTestOptionalLog(this->CTest, WARNING, "Warning: Cannot open file: "
-          << st2re5.match(1) << std::endl, this->Quiet);
+      cmCTestOptionalLog(this->CTest, WARNING, "Warning: " << re.st2re4.match(1)
+        << " had unexpected EOF" << std::endl, this->Quiet);
+      }
+    else if ( re.st2re5.find(line->c_str() ) )
+      {
+      if ( gcovStyle == 0 )
+        {
+        gcovStyle = 2;
         }
-      else if ( st2re6.find(line->c_str() ) )
+      if ( gcovStyle != 2 )
         {
-        if ( gcovStyle == 0 )
-          {
-          gcovStyle = 2;
-          }
-        if ( gcovStyle != 2 )
-          {
-          cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e8"
-            << std::endl);
-          cont->Error ++;
-          break;
-          }
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e7"
+          << std::endl);
+        cont->Error ++;
+        break;
+        }
 
-        cmCTestOptionalLog(this->CTest, WARNING, "Warning: File: "
-          << st2re6.match(1)
-          << " is newer than " << st2re6.match(2) << std::endl, this->Quiet);
+      cmCTestOptionalLog(this->CTest, WARNING, "Warning: Cannot open file: "
+        << re.st2re5.match(1) << std::endl, this->Quiet);
+      }
+    else if ( re.st2re6.find(line->c_str() ) )
+      {
+      if ( gcovStyle == 0 )
+        {
+        gcovStyle = 2;
         }
-      else
+      if ( gcovStyle != 2 )
         {
-        // gcov 4.7 can have output lines saying "No executable lines" and
-        // "Removing 'filename.gcov'"... Don't log those as "errors."
-        if(*line != "No executable lines" &&
-           !cmSystemTools::StringStartsWith(line->c_str(), "Removing "))
-          {
-          cmCTestLog(this->CTest, ERROR_MESSAGE,
-            "Unknown gcov output line: [" << *line << "]"
-            << std::endl);
-          cont->Error ++;
-          //abort();
-          }
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Unknown gcov output style e8"
+          << std::endl);
+        cont->Error ++;
+        break;
         }
 
-
-      // If the last line of gcov output gave us a valid value for gcovFile,
-      // and we have an actualSourceFile, then insert a (or add to existing)
-      // SingleFileCoverageVector for actualSourceFile:
-      //
-      if ( !gcovFile.empty() && !actualSourceFile.empty() )
+      cmCTestOptionalLog(this->CTest, WARNING, "Warning: File: "
+        << re.st2re6.match(1)
+        << " is newer than " << re.st2re6.match(2) << std::endl, this->Quiet);
+      }
+    else
+      {
+      // gcov 4.7 can have output lines saying "No executable lines" and
+      // "Removing 'filename.gcov'"... Don't log those as "errors."
+      if(*line != "No executable lines" &&
+         !cmSystemTools::StringStartsWith(line->c_str(), "Removing "))
         {
-        cmCTestCoverageHandlerContainer::SingleFileCoverageVector& vec
-          = cont->TotalCoverage[actualSourceFile];
+        cmCTestLog(this->CTest, ERROR_MESSAGE,
+          "Unknown gcov output line: [" << *line << "]"
+          << std::endl);
+        cont->Error ++;
+        //abort();
+        }
+      }
 
-        cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-          "   in gcovFile: " << gcovFile << std::endl, this->Quiet);
 
-        cmsys::ifstream ifile(gcovFile.c_str());
-        if ( ! ifile )
-          {
-          cmCTestLog(this->CTest, ERROR_MESSAGE, "Cannot open file: "
-            << gcovFile << std::endl);
-          }
-        else
+    // If the last line of gcov output gave us a valid value for gcovFile,
+    // and we have an actualSourceFile, then insert a (or add to existing)
+    // SingleFileCoverageVector for actualSourceFile:
+    //
+    if ( !gcovFile.empty() && !actualSourceFile.empty() )
+      {
+      cmCTestCoverageHandlerContainer::SingleFileCoverageVector& vec
+        = cont->TotalCoverage[actualSourceFile];
+
+      cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+        "   in gcovFile: " << gcovFile << std::endl, this->Quiet);
+
+      std::string gcovPath =
+        cmSystemTools::CollapseFullPath(gcovFile, gcovDir);
+      cmsys::ifstream ifile(gcovPath.c_str());
+      if ( ! ifile )
+        {
+        cmCTestLog(this->CTest, ERROR_MESSAGE, "Cannot open file: "
+          << gcovFile << std::endl);
+        }
+      else
+        {
+        long cnt = -1;
+        std::string nl;
+        while ( cmSystemTools::GetLineFromStream(ifile, nl) )
           {
-          long cnt = -1;
-          std::string nl;
-          while ( cmSystemTools::GetLineFromStream(ifile, nl) )
-            {
-            cnt ++;
+          cnt ++;
 
-            //TODO: Handle gcov 3.0 non-coverage lines
+          //TODO: Handle gcov 3.0 non-coverage lines
 
-            // Skip empty lines
-            if (nl.empty())
-              {
-              continue;
-              }
+          // Skip empty lines
+          if (nl.empty())
+            {
+            continue;
+            }
 
-            // Skip unused lines
-            if ( nl.size() < 12 )
-              {
-              continue;
-              }
+          // Skip unused lines
+          if ( nl.size() < 12 )
+            {
+            continue;
+            }
 
-            // Read the coverage count from the beginning of the gcov output
-            // line
-            std::string prefix = nl.substr(0, 12);
-            int cov = atoi(prefix.c_str());
+          // Read the coverage count from the beginning of the gcov output
+          // line
+          std::string prefix = nl.substr(0, 12);
+          int cov = atoi(prefix.c_str());
 
-            // Read the line number starting at the 10th character of the gcov
-            // output line
-            std::string lineNumber = nl.substr(10, 5);
+          // Read the line number starting at the 10th character of the gcov
+          // output line
+          std::string lineNumber = nl.substr(10, 5);
 
-            int lineIdx = atoi(lineNumber.c_str())-1;
-            if ( lineIdx >= 0 )
+          int lineIdx = atoi(lineNumber.c_str())-1;
+          if ( lineIdx >= 0 )
+            {
+            while ( vec.size() <= static_cast<size_t>(lineIdx) )
               {
-              while ( vec.size() <= static_cast<size_t>(lineIdx) )
-                {
-                vec.push_back(-1);
-                }
+              vec.push_back(-1);
+              }
 
-              // Initially all entries are -1 (not used). If we get coverage
-              // information, increment it to 0 first.
-              if ( vec[lineIdx] < 0 )
+            // Initially all entries are -1 (not used). If we get coverage
+            // information, increment it to 0 first.
+            if ( vec[lineIdx] < 0 )
+              {
+              if ( cov > 0 || prefix.find("#") != prefix.npos )
                 {
-                if ( cov > 0 || prefix.find("#") != prefix.npos )
-                  {
-                  vec[lineIdx] = 0;
-                  }
+                vec[lineIdx] = 0;
                 }
-
-              vec[lineIdx] += cov;
               }
+
+            vec[lineIdx] += cov;
             }
           }
-
-        actualSourceFile = "";
         }
 
+      actualSourceFile = "";
+      }
+
 
-      if ( !sourceFile.empty() && actualSourceFile.empty() )
+    if ( !sourceFile.empty() && actualSourceFile.empty() )
+      {
+      gcovFile = "";
+
+      // Relative names are relative to the directory gcov ran in.
+      std::string fullSourceFile =
+        cmSystemTools::CollapseFullPath(sourceFile, gcovDir);
+
+      // Is it in the source dir or the binary dir?
+      //
+      if ( IsFileInDir(fullSourceFile, cont->SourceDir) )
         {
-        gcovFile = "";
+        cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+          "   produced s: " << sourceFile << std::endl, this->Quiet);
+        *cont->OFS << "  produced in source dir: " << sourceFile
+          << std::endl;
+        actualSourceFile = fullSourceFile;
+        }
+      else if ( IsFileInDir(fullSourceFile, cont->BinaryDir) )
+        {
+        cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+          "   produced b: " << sourceFile << std::endl, this->Quiet);
+        *cont->OFS << "  produced in binary dir: " << sourceFile
+          << std::endl;
+        actualSourceFile = fullSourceFile;
+        }
 
-        // Is it in the source dir or the binary dir?
-        //
-        if ( IsFileInDir(sourceFile, cont->SourceDir) )
+      if ( actualSourceFile.empty() )
+        {
+        if ( missingFiles.find(sourceFile) == missingFiles.end() )
           {
           cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-            "   produced s: " << sourceFile << std::endl, this->Quiet);
-          *cont->OFS << "  produced in source dir: " << sourceFile
-            << std::endl;
-          actualSourceFile
-            = cmSystemTools::CollapseFullPath(sourceFile);
-          }
-        else if ( IsFileInDir(sourceFile, cont->BinaryDir) )
-          {
+            "Something went wrong" << std::endl, this->Quiet);
           cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-            "   produced b: " << sourceFile << std::endl, this->Quiet);
-          *cont->OFS << "  produced in binary dir: " << sourceFile
-            << std::endl;
-          actualSourceFile
-            = cmSystemTools::CollapseFullPath(sourceFile);
-          }
-
-        if ( actualSourceFile.empty() )
-          {
-          if ( missingFiles.find(sourceFile) == missingFiles.end() )
-            {
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-              "Something went wrong" << std::endl, this->Quiet);
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-              "Cannot find file: ["
-              << sourceFile << "]" << std::endl, this->Quiet);
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-              " in source dir: ["
-              << cont->SourceDir << "]"
-              << std::endl, this->Quiet);
-            cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
-              " or binary dir: ["
-              << cont->BinaryDir.size() << "]"
-              << std::endl, this->Quiet);
-            *cont->OFS << "  Something went wrong. Cannot find file: "
-              << sourceFile
-              << " in source dir: " << cont->SourceDir
-              << " or binary dir: " << cont->BinaryDir << std::endl;
-
-            missingFiles.insert(sourceFile);
-            }
+            "Cannot find file: ["
+            << sourceFile << "]" << std::endl, this->Quiet);
+          cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+            " in source dir: ["
+            << cont->SourceDir << "]"
+            << std::endl, this->Quiet);
+          cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+            " or binary dir: ["
+            << cont->BinaryDir.size() << "]"
+            << std::endl, this->Quiet);
+          *cont->OFS << "  Something went wrong. Cannot find file: "
+            << sourceFile
+            << " in source dir: " << cont->SourceDir
+            << " or binary dir: " << cont->BinaryDir << std::endl;
+
+          missingFiles.insert(sourceFile);
           }
         }
       }
-
-    file_count++;
-
-    if ( file_count % 50 == 0 )
-      {
-      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, " processed: "
-        << file_count
-        << " out of " << files.size() << std::endl, this->Quiet);
-      cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "    ", this->Quiet);
-      }
     }
-
-  cmSystemTools::ChangeDirectory(currentDirectory);
-  return file_count;
 }
 
 //----------------------------------------------------------------------
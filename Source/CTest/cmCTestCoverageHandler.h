@@ -21,6 +21,8 @@
 
 class cmGeneratedFileStream;
 class cmXMLWriter;
+struct cmCTestCoverageHandlerGCovRun;
+struct cmCTestCoverageHandlerGCovRegex;
 class cmCTestCoverageHandlerContainer
 {
 public:
@@ -72,6 +74,14 @@ private:
   //! Handle coverage using GCC's GCov
   int HandleGCovCoverage(cmCTestCoverageHandlerContainer* cont);
   void FindGCovFiles(std::vector<std::string>& files);
+  void ProcessGCovRun(cmCTestCoverageHandlerContainer* cont,
+                      cmCTestCoverageHandlerGCovRun& run,
+                      cmCTestCoverageHandlerGCovRegex& re,
+                      int& gcovStyle, std::set<std::string>& missingFiles);
+  void ParseGCovOutput(cmCTestCoverageHandlerContainer* cont,
+                       std::string const& output, std::string const& gcovDir,
+                       cmCTestCoverageHandlerGCovRegex& re,
+                       int& gcovStyle, std::set<std::string>& missingFiles);
 
   //! Handle coverage using Intel's LCov
   int HandleLCovCoverage(cmCTestCoverageHandlerContainer* cont);
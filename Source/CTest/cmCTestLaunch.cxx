@@ -43,8 +43,6 @@ cmCTestLaunch::cmCTestLaunch(int argc, const char* const* argv)
   this->ComputeFileNames();
 
   this->ScrapeRulesLoaded = false;
-  this->HaveOut = false;
-  this->HaveErr = false;
   this->Process = cmsysProcess_New();
 }
 
@@ -52,11 +50,6 @@ cmCTestLaunch::cmCTestLaunch(int argc, const char* const* argv)
 cmCTestLaunch::~cmCTestLaunch()
 {
   cmsysProcess_Delete(this->Process);
-  if(!this->Passthru)
-    {
-    cmSystemTools::RemoveFile(this->LogOut);
-    cmSystemTools::RemoveFile(this->LogErr);
-    }
 }
 
 //----------------------------------------------------------------------------
@@ -209,7 +202,7 @@ void cmCTestLaunch::ComputeFileNames()
   this->LogDir += "/";
 
   // We hash the input command working dir and command line to obtain
-  // a repeatable and (probably) unique name for log files.
+  // a repeatable and (probably) unique name for the report file.
   char hash[32];
   cmsysMD5* md5 = cmsysMD5_New();
   cmsysMD5_Initialize(md5);
@@ -222,16 +215,6 @@ void cmCTestLaunch::ComputeFileNames()
   cmsysMD5_FinalizeHex(md5, hash);
   cmsysMD5_Delete(md5);
   this->LogHash.assign(hash, 32);
-
-  // We store stdout and stderr in temporary log files.
-  this->LogOut = this->LogDir;
-  this->LogOut += "launch-";
-  this->LogOut += this->LogHash;
-  this->LogOut += "-out.txt";
-  this->LogErr = this->LogDir;
-  this->LogErr += "launch-";
-  this->LogErr += this->LogHash;
-  this->LogErr += "-err.txt";
 }
 
 //----------------------------------------------------------------------------
@@ -248,22 +231,12 @@ void cmCTestLaunch::RunChild()
   cmsysProcess* cp = this->Process;
   cmsysProcess_SetCommand(cp, this->RealArgV);
 
-  cmsys::ofstream fout;
-  cmsys::ofstream ferr;
   if(this->Passthru)
     {
     // In passthru mode we just share the output pipes.
     cmsysProcess_SetPipeShared(cp, cmsysProcess_Pipe_STDOUT, 1);
     cmsysProcess_SetPipeShared(cp, cmsysProcess_Pipe_STDERR, 1);
     }
-  else
-    {
-    // In full mode we record the child output pipes to log files.
-    fout.open(this->LogOut.c_str(),
-              std::ios::out | std::ios::binary);
-    ferr.open(this->LogErr.c_str(),
-              std::ios::out | std::ios::binary);
-    }
 
 #ifdef _WIN32
   // Do this so that newline transformation is not done when writing to cout
@@ -275,7 +248,8 @@ void cmCTestLaunch::RunChild()
   // Run the real command.
   cmsysProcess_Execute(cp);
 
-  // Record child stdout and stderr if necessary.
+  // Record child stdout and stderr if necessary.  Compiler output is
+  // small, so keep it in memory rather than in temporary files.
   if(!this->Passthru)
     {
     char* data = 0;
@@ -284,15 +258,13 @@ void cmCTestLaunch::RunChild()
       {
       if(p == cmsysProcess_Pipe_STDOUT)
         {
-        fout.write(data, length);
+        this->LogOut.append(data, length);
         std::cout.write(data, length);
-        this->HaveOut = true;
         }
       else if(p == cmsysProcess_Pipe_STDERR)
         {
-        ferr.write(data, length);
+        this->LogErr.append(data, length);
         std::cerr.write(data, length);
-        this->HaveErr = true;
         }
       }
     }
@@ -518,12 +490,12 @@ void cmCTestLaunch::WriteXMLResult(cmXMLWriter& xml)
 
   // StdOut
   xml.StartElement("StdOut");
-  this->DumpFileToXML(xml, this->LogOut);
+  this->DumpLogToXML(xml, this->LogOut);
   xml.EndElement(); // StdOut
 
   // StdErr
   xml.StartElement("StdErr");
-  this->DumpFileToXML(xml, this->LogErr);
+  this->DumpLogToXML(xml, this->LogErr);
   xml.EndElement(); // StdErr
 
   // ExitCondition
@@ -574,10 +546,10 @@ void cmCTestLaunch::WriteXMLLabels(cmXMLWriter& xml)
 }
 
 //----------------------------------------------------------------------------
-void cmCTestLaunch::DumpFileToXML(cmXMLWriter& xml,
-                                  std::string const& fname)
+void cmCTestLaunch::DumpLogToXML(cmXMLWriter& xml,
+                                 std::string const& log)
 {
-  cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  std::istringstream fin(log);
 
   std::string line;
   const char* sep = "";
@@ -611,8 +583,8 @@ bool cmCTestLaunch::CheckResults()
     }
 
   // Scrape the output logs to look for warnings.
-  if((this->HaveErr && this->ScrapeLog(this->LogErr)) ||
-     (this->HaveOut && this->ScrapeLog(this->LogOut)))
+  if((!this->LogErr.empty() && this->ScrapeLog(this->LogErr)) ||
+     (!this->LogOut.empty() && this->ScrapeLog(this->LogOut)))
     {
     return false;
     }
@@ -663,13 +635,13 @@ cmCTestLaunch
 }
 
 //----------------------------------------------------------------------------
-bool cmCTestLaunch::ScrapeLog(std::string const& fname)
+bool cmCTestLaunch::ScrapeLog(std::string const& log)
 {
   this->LoadScrapeRules();
 
-  // Look for log file lines matching warning expressions but not
+  // Look for log lines matching warning expressions but not
   // suppression expressions.
-  cmsys::ifstream fin(fname.c_str(), std::ios::in | std::ios::binary);
+  std::istringstream fin(log);
   std::string line;
   while(cmSystemTools::GetLineFromStream(fin, line))
     {
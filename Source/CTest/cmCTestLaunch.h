@@ -67,12 +67,10 @@ private:
   struct cmsysProcess_s* Process;
   int ExitCode;
 
-  // Temporary log files for stdout and stderr of real command.
+  // Directory of build logs and stdout and stderr of real command.
   std::string LogDir;
   std::string LogOut;
   std::string LogErr;
-  bool HaveOut;
-  bool HaveErr;
 
   // Labels associated with the build rule.
   std::set<std::string> Labels;
@@ -87,7 +85,7 @@ private:
   void LoadScrapeRules();
   void LoadScrapeRules(const char* purpose,
                        std::vector<cmsys::RegularExpression>& regexps);
-  bool ScrapeLog(std::string const& fname);
+  bool ScrapeLog(std::string const& log);
   bool Match(std::string const& line,
              std::vector<cmsys::RegularExpression>& regexps);
   bool MatchesFilterPrefix(std::string const& line) const;
@@ -98,7 +96,7 @@ private:
   void WriteXMLCommand(cmXMLWriter& xml);
   void WriteXMLResult(cmXMLWriter& xml);
   void WriteXMLLabels(cmXMLWriter& xml);
-  void DumpFileToXML(cmXMLWriter& xml, std::string const& fname);
+  void DumpLogToXML(cmXMLWriter& xml, std::string const& log);
 
   // Configuration
   void LoadConfig();
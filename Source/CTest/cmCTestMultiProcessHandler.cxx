@@ -40,6 +40,23 @@ private:
   cmCTestMultiProcessHandler* Handler;
 };
 
+class TestCriticalPathComparator
+{
+public:
+  TestCriticalPathComparator(std::map<int, float> const& criticalPaths)
+    : CriticalPaths(criticalPaths) {}
+
+  // Sorts tests in descending order of critical path cost
+  bool operator() (int index1, int index2) const
+    {
+    return this->CriticalPaths.find(index1)->second >
+      this->CriticalPaths.find(index2)->second;
+    }
+
+private:
+  std::map<int, float> const& CriticalPaths;
+};
+
 cmCTestMultiProcessHandler::cmCTestMultiProcessHandler()
 {
   this->ParallelLevel = 1;
@@ -49,6 +66,8 @@ cmCTestMultiProcessHandler::cmCTestMultiProcessHandler()
   this->StopTimePassed = false;
   this->HasCycles = false;
   this->SerialTestRunning = false;
+  this->PredictedMakespan = 0;
+  this->LongestCriticalPath = -1;
 }
 
 cmCTestMultiProcessHandler::~cmCTestMultiProcessHandler()
@@ -93,6 +112,13 @@ void cmCTestMultiProcessHandler::SetTestLoad(unsigned long load)
   this->TestLoad = load;
 }
 
+void cmCTestMultiProcessHandler::SetResourcePool(
+  std::map<std::string, unsigned long> const& pool)
+{
+  this->ResourcePool = pool;
+  this->ResourcesAvailable = pool;
+}
+
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::RunTests()
 {
@@ -102,6 +128,13 @@ void cmCTestMultiProcessHandler::RunTests()
     return;
     }
   this->TestHandler->SetMaxIndex(this->FindMaxIndex());
+  if(this->ParallelLevel > 1 && this->Jobserver.Connect())
+    {
+    cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
+      "Sharing job slots with the make jobserver in MAKEFLAGS"
+      << std::endl, this->Quiet);
+    }
+  double startTime = cmSystemTools::GetTime();
   this->StartNextTests();
   while(!this->Tests.empty())
     {
@@ -116,8 +149,31 @@ void cmCTestMultiProcessHandler::RunTests()
   while(this->CheckOutput())
     {
     }
+  this->Jobserver.ReleaseAll();
   this->MarkFinished();
   this->UpdateCostData();
+  this->ReportMakespan(cmSystemTools::GetTime() - startTime);
+}
+
+//---------------------------------------------------------
+void cmCTestMultiProcessHandler::ReportMakespan(double actual)
+{
+  // Without cost data there is nothing to compare against.
+  if(this->PredictedMakespan <= 0)
+    {
+    return;
+    }
+  cmCTestOptionalLog(this->CTest, HANDLER_VERBOSE_OUTPUT, std::endl
+    << "Test schedule with " << this->ParallelLevel << " slots:"
+    << std::endl
+    << "  Longest critical path: "
+    << this->Properties[this->LongestCriticalPath]->Name << " ("
+    << this->CriticalPaths[this->LongestCriticalPath] << " sec)"
+    << std::endl
+    << "  Predicted duration:    " << this->PredictedMakespan << " sec"
+    << std::endl
+    << "  Actual duration:       " << actual << " sec" << std::endl,
+    this->Quiet);
 }
 
 //---------------------------------------------------------
@@ -169,8 +225,15 @@ void cmCTestMultiProcessHandler::StartTestProcess(int test)
     this->TestFinishMap[test] = true;
     this->TestRunningMap[test] = false;
     this->RunningCount -= GetProcessorsUsed(test);
-    testRun->EndTest(this->Completed, this->Total, false);
-    this->Failed->push_back(this->Properties[test]->Name);
+    // A test skipped because of a cached result still passes.
+    if(testRun->EndTest(this->Completed, this->Total, false))
+      {
+      this->Passed->push_back(this->Properties[test]->Name);
+      }
+    else
+      {
+      this->Failed->push_back(this->Properties[test]->Name);
+      }
     delete testRun;
     }
   cmSystemTools::ChangeDirectory(current_dir);
@@ -183,6 +246,19 @@ void cmCTestMultiProcessHandler::LockResources(int index)
       this->Properties[index]->LockedResources.begin(),
       this->Properties[index]->LockedResources.end());
 
+  std::map<std::string, unsigned long> const& resources =
+    this->Properties[index]->Resources;
+  for(std::map<std::string, unsigned long>::const_iterator i =
+      resources.begin(); i != resources.end(); ++i)
+    {
+    std::map<std::string, unsigned long>::iterator avail =
+      this->ResourcesAvailable.find(i->first);
+    if(avail != this->ResourcesAvailable.end())
+      {
+      avail->second -= this->GetResourceUsed(index, i->first);
+      }
+    }
+
   if (this->Properties[index]->RunSerial)
     {
     this->SerialTestRunning = true;
@@ -198,12 +274,42 @@ void cmCTestMultiProcessHandler::UnlockResources(int index)
     {
     this->LockedResources.erase(*i);
     }
+  std::map<std::string, unsigned long> const& resources =
+    this->Properties[index]->Resources;
+  for(std::map<std::string, unsigned long>::const_iterator i =
+      resources.begin(); i != resources.end(); ++i)
+    {
+    std::map<std::string, unsigned long>::iterator avail =
+      this->ResourcesAvailable.find(i->first);
+    if(avail != this->ResourcesAvailable.end())
+      {
+      avail->second += this->GetResourceUsed(index, i->first);
+      }
+    }
   if (this->Properties[index]->RunSerial)
     {
     this->SerialTestRunning = false;
     }
 }
 
+//---------------------------------------------------------
+unsigned long
+cmCTestMultiProcessHandler::GetResourceUsed(int index,
+                                            std::string const& name)
+{
+  // Resources missing from the pool are not limited.
+  std::map<std::string, unsigned long>::const_iterator total =
+    this->ResourcePool.find(name);
+  if(total == this->ResourcePool.end())
+    {
+    return 0;
+    }
+  unsigned long used = this->Properties[index]->Resources[name];
+  //If a test needs more than the pool holds, it takes the whole pool
+  //so that it can still run on its own.
+  return used > total->second ? total->second : used;
+}
+
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::EraseTest(int test)
 {
@@ -245,6 +351,21 @@ bool cmCTestMultiProcessHandler::StartTest(int test)
       }
     }
 
+  //Check for enough of each pooled resource
+  std::map<std::string, unsigned long> const& resources =
+    this->Properties[test]->Resources;
+  for(std::map<std::string, unsigned long>::const_iterator i =
+      resources.begin(); i != resources.end(); ++i)
+    {
+    std::map<std::string, unsigned long>::const_iterator avail =
+      this->ResourcesAvailable.find(i->first);
+    if(avail != this->ResourcesAvailable.end() &&
+       avail->second < this->GetResourceUsed(test, i->first))
+      {
+      return false;
+      }
+    }
+
   // if there are no depends left then run this test
   if(this->Tests[test].empty())
     {
@@ -277,6 +398,23 @@ void cmCTestMultiProcessHandler::StartNextTests()
     return;
     }
 
+  // Within an enclosing "make -j" every slot beyond the implicit one
+  // needs a token from the jobserver.
+  if(this->Jobserver.IsConnected())
+    {
+    size_t wanted = this->RunningCount + numToStart;
+    while(1 + this->Jobserver.GetNumberOfTokens() < wanted &&
+          this->Jobserver.TryAcquire())
+      {
+      }
+    size_t slots = 1 + this->Jobserver.GetNumberOfTokens();
+    numToStart = slots > this->RunningCount ? slots - this->RunningCount : 0;
+    if(numToStart == 0)
+      {
+      return;
+      }
+    }
+
   bool allTestsFailedTestLoadCheck = false;
   bool usedFakeLoadForTesting = false;
   size_t minProcessorsRequired = this->ParallelLevel;
@@ -356,6 +494,14 @@ void cmCTestMultiProcessHandler::StartNextTests()
       testWithMinProcessors = GetName(*test);
       }
 
+    // With nothing running, do not wait for more jobserver tokens
+    // than we could get; run the test in the slots we have.
+    if(this->Jobserver.IsConnected() && this->RunningCount == 0 &&
+       processors > numToStart)
+      {
+      processors = numToStart;
+      }
+
     if(testLoadOk && processors <= numToStart && this->StartTest(*test))
       {
       if(this->StopTimePassed)
@@ -457,9 +603,21 @@ bool cmCTestMultiProcessHandler::CheckOutput()
     this->RunningCount -= GetProcessorsUsed(test);
     delete p;
     }
+  this->ReleaseJobserverTokens();
   return true;
 }
 
+//---------------------------------------------------------
+void cmCTestMultiProcessHandler::ReleaseJobserverTokens()
+{
+  // The implicit slot covers one running test processor.
+  while(this->Jobserver.GetNumberOfTokens() > 0 &&
+        this->Jobserver.GetNumberOfTokens() >= this->RunningCount)
+    {
+    this->Jobserver.Release();
+    }
+}
+
 //---------------------------------------------------------
 void cmCTestMultiProcessHandler::UpdateCostData()
 {
@@ -525,55 +683,72 @@ void cmCTestMultiProcessHandler::UpdateCostData()
 }
 
 //---------------------------------------------------------
-void cmCTestMultiProcessHandler::ReadCostData()
+bool cmCTestMultiProcessHandler::ReadCostDataFile(
+  std::string const& fname, std::vector<CostEntry>& entries,
+  std::vector<std::string>& failed)
 {
-  std::string fname = this->CTest->GetCostDataFile();
-
-  if(cmSystemTools::FileExists(fname.c_str(), true))
+  if(!cmSystemTools::FileExists(fname.c_str(), true))
     {
-    cmsys::ifstream fin;
-    fin.open(fname.c_str());
-    std::string line;
-    while(std::getline(fin, line))
-      {
-      if(line == "---") break;
+    return true;
+    }
+  cmsys::ifstream fin;
+  fin.open(fname.c_str());
+  std::string line;
+  while(std::getline(fin, line))
+    {
+    if(line == "---") break;
 
-      std::vector<cmsys::String> parts =
-        cmSystemTools::SplitString(line, ' ');
+    std::vector<cmsys::String> parts =
+      cmSystemTools::SplitString(line, ' ');
 
-      // Probably an older version of the file, will be fixed next run
-      if(parts.size() < 3)
-        {
-        fin.close();
-        return;
-        }
+    //Format: <name> <previous_runs> <avg_cost>
+    // Probably an older version of the file, will be fixed next run
+    if(parts.size() < 3)
+      {
+      return false;
+      }
 
-      std::string name = parts[0];
-      int prev = atoi(parts[1].c_str());
-      float cost = static_cast<float>(atof(parts[2].c_str()));
+    CostEntry entry;
+    entry.Name = parts[0];
+    entry.PreviousRuns = atoi(parts[1].c_str());
+    entry.Cost = static_cast<float>(atof(parts[2].c_str()));
+    entries.push_back(entry);
+    }
+  // Next part of the file is the failed tests
+  while(std::getline(fin, line))
+    {
+    if(line != "")
+      {
+      failed.push_back(line);
+      }
+    }
+  return true;
+}
 
-      int index = this->SearchByName(name);
-      if(index == -1) continue;
+//---------------------------------------------------------
+void cmCTestMultiProcessHandler::ReadCostData()
+{
+  std::vector<CostEntry> entries;
+  std::vector<std::string> failed;
+  ReadCostDataFile(this->CTest->GetCostDataFile(), entries, failed);
 
-      this->Properties[index]->PreviousRuns = prev;
-      // When not running in parallel mode, don't use cost data
-      if(this->ParallelLevel > 1 &&
-         this->Properties[index] &&
-         this->Properties[index]->Cost == 0)
-        {
-        this->Properties[index]->Cost = cost;
-        }
-      }
-    // Next part of the file is the failed tests
-    while(std::getline(fin, line))
+  for(std::vector<CostEntry>::const_iterator e = entries.begin();
+      e != entries.end(); ++e)
+    {
+    int index = this->SearchByName(e->Name);
+    if(index == -1) continue;
+
+    this->Properties[index]->PreviousRuns = e->PreviousRuns;
+    // When not running in parallel mode, don't use cost data
+    if(this->ParallelLevel > 1 &&
+       this->Properties[index] &&
+       this->Properties[index]->Cost == 0)
       {
-      if(line != "")
-        {
-        this->LastTestsFailed.push_back(line);
-        }
+      this->Properties[index]->Cost = e->Cost;
       }
-    fin.close();
     }
+  this->LastTestsFailed.insert(this->LastTestsFailed.end(),
+                               failed.begin(), failed.end());
 }
 
 //---------------------------------------------------------
@@ -683,6 +858,157 @@ void cmCTestMultiProcessHandler::CreateParallelTestCostList()
         }
       }
     }
+
+  // Tests heading a long chain of dependent tests have to start early or
+  // the run ends with that chain on a single processor.  Order the tests
+  // not failed last time by the total cost of the longest chain they
+  // head.  Without cost data all chains cost nothing and the level
+  // order above is kept.
+  this->ComputeCriticalPaths();
+  TestList::iterator firstNotFailed = this->SortedTests.begin();
+  while(firstNotFailed != this->SortedTests.end() &&
+        std::find(this->LastTestsFailed.begin(), this->LastTestsFailed.end(),
+                  this->Properties[*firstNotFailed]->Name) !=
+        this->LastTestsFailed.end())
+    {
+    ++firstNotFailed;
+    }
+  TestCriticalPathComparator pathComp(this->CriticalPaths);
+  std::stable_sort(firstNotFailed, this->SortedTests.end(), pathComp);
+
+  // The prediction is only shown in verbose output.
+  if(this->CTest->GetExtraVerbose())
+    {
+    this->PredictedMakespan = this->PredictMakespan();
+    }
+}
+
+//---------------------------------------------------------
+void cmCTestMultiProcessHandler::ComputeCriticalPaths()
+{
+  // Invert the dependency map to find the tests waiting on each test.
+  TestMap& dependents = this->Dependents;
+  dependents.clear();
+  for(TestMap::const_iterator i = this->Tests.begin();
+    i != this->Tests.end(); ++i)
+    {
+    dependents[i->first];
+    for(TestSet::const_iterator j = i->second.begin();
+      j != i->second.end(); ++j)
+      {
+      dependents[*j].insert(i->first);
+      }
+    }
+
+  this->CriticalPaths.clear();
+  this->LongestCriticalPath = -1;
+  for(TestMap::const_iterator i = this->Tests.begin();
+    i != this->Tests.end(); ++i)
+    {
+    float cost = this->GetCriticalPathCost(i->first, dependents);
+    if(this->LongestCriticalPath == -1 ||
+       cost > this->CriticalPaths[this->LongestCriticalPath])
+      {
+      this->LongestCriticalPath = i->first;
+      }
+    }
+}
+
+//---------------------------------------------------------
+float cmCTestMultiProcessHandler::GetCriticalPathCost(int test,
+                                                      TestMap& dependents)
+{
+  std::map<int, float>::const_iterator known = this->CriticalPaths.find(test);
+  if(known != this->CriticalPaths.end())
+    {
+    return known->second;
+    }
+
+  // The graph has no cycles, this was checked before sorting.
+  float longest = 0;
+  TestSet const& waiting = dependents[test];
+  for(TestSet::const_iterator i = waiting.begin(); i != waiting.end(); ++i)
+    {
+    float cost = this->GetCriticalPathCost(*i, dependents);
+    if(cost > longest)
+      {
+      longest = cost;
+      }
+    }
+  float cost = this->Properties[test]->Cost + longest;
+  this->CriticalPaths[test] = cost;
+  return cost;
+}
+
+//---------------------------------------------------------
+double cmCTestMultiProcessHandler::PredictMakespan()
+{
+  // Replay the schedule StartNextTests will follow, assuming every test
+  // takes its recorded cost.  Load limits, resource locks and pools, and
+  // RUN_SERIAL are not modeled so this is an estimate.
+  //
+  // Tests become ready when their last dependency finishes and start in
+  // the order of the sorted list, so keep the ready tests keyed by their
+  // position in that list.
+  std::map<int, size_t> position;
+  std::map<int, size_t> unfinished;
+  std::set<std::pair<size_t, int> > ready;
+  size_t n = 0;
+  for(TestList::const_iterator i = this->SortedTests.begin();
+      i != this->SortedTests.end(); ++i, ++n)
+    {
+    position[*i] = n;
+    unfinished[*i] = this->Tests[*i].size();
+    if(unfinished[*i] == 0)
+      {
+      ready.insert(std::make_pair(n, *i));
+      }
+    }
+
+  std::multimap<double, int> running;
+  size_t freeSlots = this->ParallelLevel;
+  double now = 0;
+  while(!ready.empty() || !running.empty())
+    {
+    for(std::set<std::pair<size_t, int> >::iterator i = ready.begin();
+        i != ready.end() && freeSlots > 0;)
+      {
+      size_t processors = this->GetProcessorsUsed(i->second);
+      if(processors <= freeSlots)
+        {
+        running.insert(std::make_pair(
+          now + this->Properties[i->second]->Cost, i->second));
+        freeSlots -= processors;
+        ready.erase(i++);
+        }
+      else
+        {
+        ++i;
+        }
+      }
+    if(running.empty())
+      {
+      // Remaining tests depend on tests that were not selected.
+      break;
+      }
+    std::multimap<double, int>::iterator next = running.begin();
+    now = next->first;
+    int test = next->second;
+    running.erase(next);
+    freeSlots += this->GetProcessorsUsed(test);
+
+    // Only the tests waiting on this one can become ready.
+    TestSet const& waiting = this->Dependents[test];
+    for(TestSet::const_iterator j = waiting.begin(); j != waiting.end(); ++j)
+      {
+      std::map<int, size_t>::iterator u = unfinished.find(*j);
+      if(u != unfinished.end() && --u->second == 0)
+        {
+        ready.insert(std::make_pair(position[*j], *j));
+        }
+      }
+    }
+  return now;
 }
 
 //---------------------------------------------------------
@@ -15,6 +15,7 @@
 #include <cmStandardIncludes.h>
 #include <cmCTestTestHandler.h>
 #include <cmCTestRunTest.h>
+#include <cmJobserverClient.h>
 
 /** \class cmCTestMultiProcessHandler
  * \brief run parallel ctest
@@ -38,6 +39,8 @@ public:
   // Set the max number of tests that can be run at the same time.
   void SetParallelLevel(size_t);
   void SetTestLoad(unsigned long load);
+  // Set the amount available of each countable resource
+  void SetResourcePool(std::map<std::string, unsigned long> const& pool);
   virtual void RunTests();
   void PrintTestList();
   void PrintLabels();
@@ -60,6 +63,20 @@ public:
   { return this->TestHandler; }
 
   void SetQuiet(bool b) { this->Quiet = b; }
+
+  // One test recorded in the cost data file
+  struct CostEntry
+  {
+    std::string Name;
+    int PreviousRuns;
+    float Cost;
+  };
+  // Read the tests and the failed tests recorded in a cost data file.
+  // Returns false when the file has an older format, in which case only
+  // the entries before the first unreadable line are returned.
+  static bool ReadCostDataFile(std::string const& fname,
+                               std::vector<CostEntry>& entries,
+                               std::vector<std::string>& failed);
 protected:
   // Start the next test or tests as many as are allowed by
   // ParallelLevel
@@ -81,6 +98,14 @@ protected:
 
   void CreateParallelTestCostList();
 
+  // Compute for each test the cost of the longest chain of tests
+  // depending on it, including itself
+  void ComputeCriticalPaths();
+  float GetCriticalPathCost(int test, TestMap& dependents);
+  // Estimate how long the sorted tests take with ParallelLevel slots
+  double PredictMakespan();
+  void ReportMakespan(double actual);
+
   // Removes the checkpoint file
   void MarkFinished();
   void EraseTest(int index);
@@ -96,11 +121,22 @@ protected:
   inline size_t GetProcessorsUsed(int index);
   std::string GetName(int index);
 
+  // Return jobserver tokens not needed by the running tests
+  void ReleaseJobserverTokens();
+
   void LockResources(int index);
   void UnlockResources(int index);
+  // Amount of a pooled resource the test takes, at most the whole pool
+  unsigned long GetResourceUsed(int index, std::string const& name);
   // map from test number to set of depend tests
   TestMap Tests;
   TestList SortedTests;
+  // critical path cost of each test, see ComputeCriticalPaths
+  std::map<int, float> CriticalPaths;
+  // map from test number to set of tests depending on it
+  TestMap Dependents;
+  int LongestCriticalPath;
+  double PredictedMakespan;
   //Total number of tests we'll be running
   size_t Total;
   //Number of tests that are complete
@@ -116,8 +152,13 @@ protected:
   std::vector<std::string>* Failed;
   std::vector<std::string> LastTestsFailed;
   std::set<std::string> LockedResources;
+  // total and currently free amount of each countable resource
+  std::map<std::string, unsigned long> ResourcePool;
+  std::map<std::string, unsigned long> ResourcesAvailable;
   std::vector<cmCTestTestHandler::cmCTestTestResult>* TestResults;
   size_t ParallelLevel; // max number of process that can be run at once
+  // job slots shared with an enclosing "make -j", if any
+  cmJobserverClient Jobserver;
   unsigned long TestLoad;
   std::set<cmCTestRunTest*> RunningTests;  // current running tests
   cmCTestTestHandler * TestHandler;
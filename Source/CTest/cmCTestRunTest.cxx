@@ -30,9 +30,18 @@ cmCTestRunTest::cmCTestRunTest(cmCTestTestHandler* handler)
   this->TestResult.TestCount = 0;
   this->TestResult.Properties = 0;
   this->ProcessOutput = "";
+  this->InMeasurement = false;
+  this->OutputWindow = 0;
+  this->OutputSize = 0;
+  this->OutputSpilled = false;
+  this->FullOutputRequested = false;
+  this->RequiredRegexFound = false;
+  this->ErrorRegexIndex = static_cast<size_t>(-1);
+  this->CompressStream = 0;
   this->CompressedOutput = "";
   this->CompressionRatio = 2;
   this->StopTimePassed = false;
+  this->CachedResult = false;
   this->NumberOfRunsLeft = 1; // default to 1 run of the test
   this->RunUntilFail = false; // default to run the test once
   this->RunAgain = false;   // default to not having to run again
@@ -40,6 +49,38 @@ cmCTestRunTest::cmCTestRunTest(cmCTestTestHandler* handler)
 
 cmCTestRunTest::~cmCTestRunTest()
 {
+  this->EndCompression();
+}
+
+//----------------------------------------------------------------------------
+// Once the output has been spilled the pass and fail expressions are
+// matched against this much of its end, so a match may span lines.
+static const size_t cmCTestRunTestSearchWindow = 4096;
+
+//----------------------------------------------------------------------------
+// Drop the front of the text so that at most size bytes remain, starting
+// at a line boundary when there is one.
+static void cmCTestRunTestTrimFront(std::string& text, size_t size)
+{
+  if(text.size() <= size)
+    {
+    return;
+    }
+  std::string::size_type cut = text.size() - size;
+  std::string::size_type eol = text.find('\n', cut);
+  if(eol != std::string::npos && eol + 1 < text.size())
+    {
+    cut = eol + 1;
+    }
+  text.erase(0, cut);
+}
+
+//----------------------------------------------------------------------------
+// An expression anchored with '^' matches only the start of the output,
+// which has been searched before the output was spilled.
+static bool cmCTestRunTestIsAnchored(std::string const& regex)
+{
+  return !regex.empty() && regex[0] == '^';
 }
 
 //----------------------------------------------------------------------------
@@ -62,19 +103,27 @@ bool cmCTestRunTest::CheckOutput()
       // Store this line of output.
       cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                  this->GetIndex() << ": " << line << std::endl);
-      this->ProcessOutput += line;
-      this->ProcessOutput += "\n";
+      line += "\n";
+      this->AppendOutput(line);
 
       // Check for TIMEOUT_AFTER_MATCH property.
       if (!this->TestProperties->TimeoutRegularExpressions.empty())
         {
+        // Once the output has been spilled only its recent end is searched.
+        std::string const& output =
+          this->OutputSpilled ? this->OutputSearchText : this->ProcessOutput;
         std::vector<std::pair<cmsys::RegularExpression,
           std::string> >::iterator regIt;
         for ( regIt = this->TestProperties->TimeoutRegularExpressions.begin();
               regIt != this->TestProperties->TimeoutRegularExpressions.end();
               ++ regIt )
           {
-          if ( regIt->first.find(this->ProcessOutput.c_str()) )
+          if ( this->OutputSpilled &&
+               cmCTestRunTestIsAnchored(regIt->second) )
+            {
+            continue;
+            }
+          if ( regIt->first.find(output.c_str()) )
             {
             cmCTestLog(this->CTest, HANDLER_VERBOSE_OUTPUT,
                        this->GetIndex() << ": " <<
@@ -97,79 +146,277 @@ bool cmCTestRunTest::CheckOutput()
   return true;
 }
 
-//---------------------------------------------------------
-// Streamed compression of test output.  The compressed data
-// is appended to this->CompressedOutput
-void cmCTestRunTest::CompressOutput()
+//----------------------------------------------------------------------------
+void cmCTestRunTest::StartOutputCapture()
 {
-  int ret;
-  z_stream strm;
-
-  unsigned char* in =
-    reinterpret_cast<unsigned char*>(
-    const_cast<char*>(this->ProcessOutput.c_str()));
-  //zlib makes the guarantee that this is the maximum output size
-  int outSize = static_cast<int>(
-    static_cast<double>(this->ProcessOutput.size()) * 1.001 + 13.0);
-  unsigned char* out = new unsigned char[outSize];
-
-  strm.zalloc = Z_NULL;
-  strm.zfree = Z_NULL;
-  strm.opaque = Z_NULL;
-  ret = deflateInit(&strm, -1); //default compression level
-  if (ret != Z_OK)
-    {
-    delete[] out;
-    return;
+  this->EndCompression();
+  this->ProcessOutput = "";
+  this->ProcessOutputTail = "";
+  this->OutputMeasurements = "";
+  this->InMeasurement = false;
+  this->OutputSize = 0;
+  this->OutputSearchText = "";
+  this->OutputSpilled = false;
+  this->FullOutputRequested = false;
+  this->OutputFileName = "";
+  this->RequiredRegexFound = false;
+  this->ErrorRegexIndex =
+    this->TestProperties->ErrorRegularExpressions.size();
+  this->CompressedOutput = "";
+  this->CompressionRatio = 2;
+
+  // Only the head of the output can reach the test results, so a test
+  // that writes more than twice the largest output limit has its output
+  // spilled to a file.  MemCheck parses all of the output.
+  this->OutputWindow = 0;
+  int passedSize = this->TestHandler->CustomMaximumPassedTestOutputSize;
+  int failedSize = this->TestHandler->CustomMaximumFailedTestOutputSize;
+  if(!this->TestHandler->MemCheck && passedSize > 0 && failedSize > 0)
+    {
+    // One byte more than the limit so that truncation is still detected.
+    this->OutputWindow =
+      static_cast<size_t>(passedSize > failedSize ? passedSize : failedSize)
+      + 1;
     }
 
-  strm.avail_in = static_cast<uInt>(this->ProcessOutput.size());
-  strm.next_in = in;
-  strm.avail_out = outSize;
-  strm.next_out = out;
-  ret = deflate(&strm, Z_FINISH);
+  // The compressed output holds all of the output, so compress it as it
+  // arrives instead of holding it until the test ends.
+  if(!this->TestHandler->MemCheck && this->CTest->ShouldCompressTestOutput())
+    {
+    this->CompressStream = new z_stream;
+    this->CompressStream->zalloc = Z_NULL;
+    this->CompressStream->zfree = Z_NULL;
+    this->CompressStream->opaque = Z_NULL;
+    if(deflateInit(this->CompressStream, -1) != Z_OK) //default level
+      {
+      delete this->CompressStream;
+      this->CompressStream = 0;
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::AppendOutput(std::string const& line)
+{
+  this->OutputSize += line.size();
+  if(this->CompressStream)
+    {
+    this->CompressOutput(line.c_str(), line.size(), Z_NO_FLUSH);
+    }
+  if(line.find("CTEST_FULL_OUTPUT") != line.npos)
+    {
+    this->FullOutputRequested = true;
+    }
+  // Keep measurements apart so that they survive spilling.
+  std::string::size_type open = line.rfind("<DartMeasurement");
+  std::string::size_type close = line.rfind("</DartMeasurement");
+  if(this->InMeasurement || open != line.npos)
+    {
+    this->OutputMeasurements += line;
+    if(open != line.npos)
+      {
+      this->InMeasurement = close == line.npos || close < open;
+      }
+    else
+      {
+      this->InMeasurement = close == line.npos;
+      }
+    }
 
-  if(ret == Z_STREAM_ERROR || ret != Z_STREAM_END)
+  if(!this->OutputSpilled)
     {
-    cmCTestLog(this->CTest, ERROR_MESSAGE, "Error during output "
-      "compression. Sending uncompressed output." << std::endl);
-    delete[] out;
+    this->ProcessOutput += line;
+    if(this->OutputWindow &&
+       this->ProcessOutput.size() > 2 * this->OutputWindow &&
+       !this->SpillOutput())
+      {
+      // Without a file to spill to keep everything in memory.
+      this->OutputWindow = 0;
+      }
     return;
     }
 
-  (void)deflateEnd(&strm);
+  this->OutputFile.write(line.c_str(), line.size());
+  this->OutputSearchText += line;
+  cmCTestRunTestTrimFront(this->OutputSearchText, cmCTestRunTestSearchWindow);
+  this->MatchOutputRegularExpressions(this->OutputSearchText, true);
+  this->ProcessOutputTail += line;
+  if(this->ProcessOutputTail.size() > 2 * this->OutputWindow)
+    {
+    this->TrimOutputTail();
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::TrimOutputTail()
+{
+  cmCTestRunTestTrimFront(this->ProcessOutputTail, this->OutputWindow);
+}
 
-  unsigned char *encoded_buffer
-    = new unsigned char[static_cast<int>(outSize * 1.5)];
+//----------------------------------------------------------------------------
+bool cmCTestRunTest::SpillOutput()
+{
+  std::ostringstream name;
+  name << this->CTest->GetBinaryDir() << "/Testing/Temporary/TestOutput_"
+       << this->Index << ".log";
+  this->OutputFileName = name.str();
+  this->OutputFile.open(this->OutputFileName.c_str(),
+                        std::ios::out | std::ios::binary);
+  if(!this->OutputFile)
+    {
+    this->OutputFile.clear();
+    this->OutputFileName = "";
+    return false;
+    }
+  this->OutputFile.write(this->ProcessOutput.c_str(),
+                         this->ProcessOutput.size());
+
+  // Search what is about to be dropped.  The lines that follow are
+  // searched together with the end of the output before them.
+  this->MatchOutputRegularExpressions(this->ProcessOutput, false);
+  this->OutputSearchText = this->ProcessOutput;
+  cmCTestRunTestTrimFront(this->OutputSearchText, cmCTestRunTestSearchWindow);
+
+  this->ProcessOutputTail = this->ProcessOutput.substr(this->OutputWindow);
+  this->TrimOutputTail();
+  std::string head = this->ProcessOutput.substr(0, this->OutputWindow);
+  this->ProcessOutput.swap(head);
+  this->OutputSpilled = true;
+  return true;
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::MatchOutputRegularExpressions(std::string const& text,
+                                                  bool window)
+{
+  std::vector<std::pair<cmsys::RegularExpression,
+    std::string> >& required =
+    this->TestProperties->RequiredRegularExpressions;
+  for(size_t i = 0; !this->RequiredRegexFound && i < required.size(); ++i)
+    {
+    if(window && cmCTestRunTestIsAnchored(required[i].second))
+      {
+      continue;
+      }
+    if(required[i].first.find(text.c_str()))
+      {
+      this->RequiredRegexFound = true;
+      }
+    }
+
+  // Report the first expression in the list that matches anywhere.
+  std::vector<std::pair<cmsys::RegularExpression,
+    std::string> >& error = this->TestProperties->ErrorRegularExpressions;
+  for(size_t i = 0; i < this->ErrorRegexIndex && i < error.size(); ++i)
+    {
+    if(window && cmCTestRunTestIsAnchored(error[i].second))
+      {
+      continue;
+      }
+    if(error[i].first.find(text.c_str()))
+      {
+      this->ErrorRegexIndex = i;
+      break;
+      }
+    }
+}
 
-  size_t rlen
-    = cmsysBase64_Encode(out, strm.total_out, encoded_buffer, 1);
+//----------------------------------------------------------------------------
+void cmCTestRunTest::FinishOutputCapture()
+{
+  if(this->OutputFile.is_open())
+    {
+    this->OutputFile.close();
+    }
 
-  for(size_t i = 0; i < rlen; i++)
+  // A test that asks for its full output gets it back in memory.
+  if(this->OutputSpilled && this->FullOutputRequested)
     {
-    this->CompressedOutput += encoded_buffer[i];
+    cmsys::ifstream fin(this->OutputFileName.c_str(),
+                        std::ios::in | std::ios::binary);
+    std::ostringstream output;
+    output << fin.rdbuf();
+    this->ProcessOutput = output.str();
+    this->ProcessOutputTail = "";
+    this->OutputSpilled = false;
     }
 
-  if(strm.total_in)
+  if(!this->CompressStream)
+    {
+    return;
+    }
+  this->CompressOutput(0, 0, Z_FINISH);
+  if(!this->CompressStream)
     {
-    this->CompressionRatio = static_cast<double>(strm.total_out) /
-                             static_cast<double>(strm.total_in);
+    return;
     }
 
+  uLong totalIn = this->CompressStream->total_in;
+  uLong totalOut = this->CompressStream->total_out;
+  this->EndCompression();
+
+  unsigned char* encoded_buffer =
+    new unsigned char[(this->CompressedOutput.size() + 2) / 3 * 4 + 1];
+  size_t rlen = cmsysBase64_Encode(
+    reinterpret_cast<const unsigned char*>(this->CompressedOutput.c_str()),
+    this->CompressedOutput.size(), encoded_buffer, 1);
+  this->CompressedOutput.assign(reinterpret_cast<char*>(encoded_buffer),
+                                rlen);
   delete [] encoded_buffer;
-  delete [] out;
+
+  if(totalIn)
+    {
+    this->CompressionRatio = static_cast<double>(totalOut) /
+                             static_cast<double>(totalIn);
+    }
 }
 
 //---------------------------------------------------------
-bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
+// Streamed compression of test output.  The compressed data
+// is appended to this->CompressedOutput
+void cmCTestRunTest::CompressOutput(const char* data, size_t length,
+                                    int flush)
 {
-  if ((!this->TestHandler->MemCheck &&
-      this->CTest->ShouldCompressTestOutput()) ||
-      (this->TestHandler->MemCheck &&
-      this->CTest->ShouldCompressMemCheckOutput()))
+  unsigned char out[16384];
+  z_stream* strm = this->CompressStream;
+  strm->next_in =
+    reinterpret_cast<unsigned char*>(const_cast<char*>(data));
+  strm->avail_in = static_cast<uInt>(length);
+  do
     {
-    this->CompressOutput();
+    strm->next_out = out;
+    strm->avail_out = sizeof(out);
+    int ret = deflate(strm, flush);
+    if(ret == Z_STREAM_ERROR ||
+       (flush == Z_FINISH && ret != Z_STREAM_END && strm->avail_out))
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE, "Error during output "
+        "compression. Sending uncompressed output." << std::endl);
+      this->EndCompression();
+      this->CompressedOutput = "";
+      return;
+      }
+    this->CompressedOutput.append(reinterpret_cast<char*>(out),
+                                  sizeof(out) - strm->avail_out);
     }
+  while(strm->avail_out == 0);
+}
+
+//----------------------------------------------------------------------------
+void cmCTestRunTest::EndCompression()
+{
+  if(this->CompressStream)
+    {
+    (void)deflateEnd(this->CompressStream);
+    delete this->CompressStream;
+    this->CompressStream = 0;
+    }
+}
+
+//---------------------------------------------------------
+bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
+{
+  this->FinishOutputCapture();
 
   this->WriteLogOutputTop(completed, total);
   std::string reason;
@@ -181,21 +428,17 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
     std::string> >::iterator passIt;
   bool forceFail = false;
   bool outputTestErrorsToConsole = false;
+  if (!this->OutputSpilled)
+    {
+    this->MatchOutputRegularExpressions(this->ProcessOutput, false);
+    }
   if (!this->TestProperties->RequiredRegularExpressions.empty())
     {
-    bool found = false;
-    for ( passIt = this->TestProperties->RequiredRegularExpressions.begin();
-          passIt != this->TestProperties->RequiredRegularExpressions.end();
-          ++ passIt )
+    if ( this->RequiredRegexFound )
       {
-      if ( passIt->first.find(this->ProcessOutput.c_str()) )
-        {
-        found = true;
-        reason = "Required regular expression found.";
-        break;
-        }
+      reason = "Required regular expression found.";
       }
-    if ( !found )
+    else
       {
       reason = "Required regular expression not found.";
       forceFail = true;
@@ -210,24 +453,22 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
       }
     reason += "]";
     }
-  if (!this->TestProperties->ErrorRegularExpressions.empty())
+  if (this->ErrorRegexIndex <
+      this->TestProperties->ErrorRegularExpressions.size())
     {
-    for ( passIt = this->TestProperties->ErrorRegularExpressions.begin();
-          passIt != this->TestProperties->ErrorRegularExpressions.end();
-          ++ passIt )
-      {
-      if ( passIt->first.find(this->ProcessOutput.c_str()) )
-        {
-        reason = "Error regular expression found in output.";
-        reason += " Regex=[";
-        reason += passIt->second;
-        reason += "]";
-        forceFail = true;
-        break;
-        }
-      }
+    reason = "Error regular expression found in output.";
+    reason += " Regex=[";
+    reason += this->TestProperties->ErrorRegularExpressions[
+      this->ErrorRegexIndex].second;
+    reason += "]";
+    forceFail = true;
+    }
+  if (this->CachedResult)
+    {
+    reason = "";
+    cmCTestLog(this->CTest, HANDLER_OUTPUT, "   Passed (cached) " );
     }
-  if (res == cmsysProcess_State_Exited)
+  else if (res == cmsysProcess_State_Exited)
     {
     bool success =
       !forceFail &&  (retVal == 0 ||
@@ -296,7 +537,21 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
 
   if ( outputTestErrorsToConsole )
     {
-    cmCTestLog(this->CTest, HANDLER_OUTPUT, this->ProcessOutput << std::endl );
+    if ( this->OutputSpilled )
+      {
+      cmCTestLog(this->CTest, HANDLER_OUTPUT, this->ProcessOutput
+        << "\n...\n"
+        << (this->OutputSize - this->ProcessOutput.size() -
+            this->ProcessOutputTail.size())
+        << " bytes of output omitted.  The full output is in\n  "
+        << this->OutputFileName << "\n...\n"
+        << this->ProcessOutputTail << std::endl );
+      }
+    else
+      {
+      cmCTestLog(this->CTest, HANDLER_OUTPUT,
+                 this->ProcessOutput << std::endl );
+      }
     }
 
   if ( this->TestHandler->LogFile )
@@ -382,6 +637,15 @@ bool cmCTestRunTest::EndTest(size_t completed, size_t total, bool started)
     this->TestResult.ExecutionTime = this->TestProcess->GetTotalTime();
     this->MemCheckPostProcess();
     this->ComputeWeightedCost();
+    this->TestHandler->RecordResult(this->TestProperties->Name,
+      this->ResultCacheKey,
+      this->TestResult.Status == cmCTestTestHandler::COMPLETED);
+    }
+  // Keep the spilled output of tests that did not pass.
+  if(!this->OutputFileName.empty() &&
+     this->TestResult.Status == cmCTestTestHandler::COMPLETED)
+    {
+    cmSystemTools::RemoveFile(this->OutputFileName);
     }
   // If the test does not need to rerun push the current TestResult onto the
   // TestHandler vector
@@ -464,6 +728,7 @@ void cmCTestRunTest::MemCheckPostProcess()
 bool cmCTestRunTest::StartTest(size_t total)
 {
   this->TotalNumberOfTests = total; // save for rerun case
+  this->CachedResult = false;
   cmCTestLog(this->CTest, HANDLER_OUTPUT, std::setw(2*getNumWidth(total) + 8)
     << "Start "
     << std::setw(getNumWidth(this->TestHandler->GetMaxIndex()))
@@ -480,6 +745,7 @@ bool cmCTestRunTest::StartTest(size_t total)
   this->TestResult.TestCount = this->TestProperties->Index;
   this->TestResult.Name = this->TestProperties->Name;
   this->TestResult.Path = this->TestProperties->Directory.c_str();
+  this->StartOutputCapture();
 
   if(args.size() >= 2 && args[1] == "NOT_AVAILABLE")
     {
@@ -543,6 +809,25 @@ bool cmCTestRunTest::StartTest(size_t total)
     this->TestResult.Status = cmCTestTestHandler::NOT_RUN;
     return false;
     }
+
+  // Skip the test if it passed before with the same inputs, unless it
+  // is to be repeated.
+  this->ResultCacheKey = this->TestHandler->ComputeResultCacheKey(
+    this->TestProperties, this->TestResult.FullCommandLine);
+  if(!this->RunUntilFail &&
+     this->TestHandler->IsResultCached(this->TestProperties->Name,
+                                       this->ResultCacheKey))
+    {
+    this->TestProcess = new cmProcess;
+    this->TestResult.Output = "Test passed before with the same inputs, "
+      "command line and environment.";
+    this->TestResult.ReturnValue = 0;
+    this->TestResult.CompletionStatus = "Cached";
+    this->TestResult.Status = cmCTestTestHandler::COMPLETED;
+    this->CachedResult = true;
+    return false;
+    }
+
   this->StartTime = this->CTest->CurrentTime();
 
   double timeout = this->ResolveTimeout();
@@ -622,22 +907,35 @@ void cmCTestRunTest::ComputeArguments()
     }
 }
 
+//----------------------------------------------------------------------
+static void cmCTestRunTestRemoveMeasurements(cmsys::RegularExpression& re,
+                                             std::string& output)
+{
+  while (re.find(output.c_str()))
+    {
+    // replace the exact match for the string
+    cmSystemTools::ReplaceString(output, re.match(1).c_str(), "");
+    }
+}
+
 //----------------------------------------------------------------------
 void cmCTestRunTest::DartProcessing()
 {
-  if (!this->ProcessOutput.empty() &&
-     this->ProcessOutput.find("<DartMeasurement") != this->ProcessOutput.npos)
+  // Spilled output may have lost measurements, so use the ones that
+  // were collected while it streamed by.
+  std::string const& output =
+    this->OutputSpilled ? this->OutputMeasurements : this->ProcessOutput;
+  if (!output.empty() &&
+     output.find("<DartMeasurement") != output.npos)
     {
-    if (this->TestHandler->DartStuff.find(this->ProcessOutput.c_str()))
+    if (this->TestHandler->DartStuff.find(output.c_str()))
       {
       this->TestResult.DartString = this->TestHandler->DartStuff.match(1);
       // keep searching and replacing until none are left
-      while (this->TestHandler->DartStuff1.find(this->ProcessOutput.c_str()))
-        {
-        // replace the exact match for the string
-        cmSystemTools::ReplaceString(this->ProcessOutput,
-                         this->TestHandler->DartStuff1.match(1).c_str(), "");
-        }
+      cmCTestRunTestRemoveMeasurements(this->TestHandler->DartStuff1,
+                                       this->ProcessOutput);
+      cmCTestRunTestRemoveMeasurements(this->TestHandler->DartStuff1,
+                                       this->ProcessOutputTail);
       }
     }
 }
@@ -824,8 +1122,20 @@ void cmCTestRunTest::WriteLogOutputTop(size_t completed, size_t total)
     << "Output:" << std::endl
     << "----------------------------------------------------------"
     << std::endl;
-  *this->TestHandler->LogFile
-    << this->ProcessOutput << "<end of output>" << std::endl;
+  if(this->OutputSpilled)
+    {
+    cmsys::ifstream fin(this->OutputFileName.c_str(),
+                        std::ios::in | std::ios::binary);
+    if(fin && fin.peek() != EOF)
+      {
+      *this->TestHandler->LogFile << fin.rdbuf();
+      }
+    }
+  else
+    {
+    *this->TestHandler->LogFile << this->ProcessOutput;
+    }
+  *this->TestHandler->LogFile << "<end of output>" << std::endl;
 
   cmCTestLog(this->CTest, HANDLER_OUTPUT, outname.c_str());
   cmCTestLog(this->CTest, DEBUG, "Testing "
@@ -16,6 +16,10 @@
 #include <cmCTestTestHandler.h>
 #include <cmProcess.h>
 
+#include <cmsys/FStream.hxx>
+
+struct z_stream_s;
+
 /** \class cmRunTest
  * \brief represents a single test to be run
  *
@@ -49,9 +53,6 @@ public:
   // Read and store output.  Returns true if it must be called again.
   bool CheckOutput();
 
-  // Compresses the output, writing to CompressedOutput
-  void CompressOutput();
-
   //launch the test process, return whether it started correctly
   bool StartTest(size_t total);
   //capture and report the test results
@@ -66,6 +67,21 @@ private:
   bool NeedsToRerun();
   void DartProcessing();
   void ExeNotFound(std::string exe);
+  // Reset the output state for a new run of the test.
+  void StartOutputCapture();
+  // Store one line of output, spilling to disk once it grows too large.
+  void AppendOutput(std::string const& line);
+  // Move the output to a file and keep only its head and tail.
+  bool SpillOutput();
+  void TrimOutputTail();
+  // Record which pass and fail regular expressions match the text.  A
+  // window of recent output is not searched by anchored expressions.
+  void MatchOutputRegularExpressions(std::string const& text, bool window);
+  // Close the spill file and finish the compressed output.
+  void FinishOutputCapture();
+  // Compresses the output, appending to CompressedOutput
+  void CompressOutput(const char* data, size_t length, int flush);
+  void EndCompression();
   // Figures out a final timeout which is min(STOP_TIME, NOW+TIMEOUT)
   double ResolveTimeout();
   bool ForkProcess(double testTimeOut, bool explicitTimeout,
@@ -87,7 +103,26 @@ private:
   bool UsePrefixCommand;
   std::string PrefixCommand;
 
+  // The whole output, or only its head once it has been spilled.
   std::string ProcessOutput;
+  // The tail of the output once it has been spilled.
+  std::string ProcessOutputTail;
+  // Measurements seen in the output, kept in case they are spilled.
+  std::string OutputMeasurements;
+  bool InMeasurement;
+  // The end of the output searched by regular expressions once spilled.
+  std::string OutputSearchText;
+  // Size of the head and tail windows, or 0 to keep all output in memory.
+  size_t OutputWindow;
+  size_t OutputSize;
+  bool OutputSpilled;
+  bool FullOutputRequested;
+  std::string OutputFileName;
+  cmsys::ofstream OutputFile;
+  // Matches of the pass and fail regular expressions found so far.
+  bool RequiredRegexFound;
+  size_t ErrorRegexIndex;
+  z_stream_s* CompressStream;
   std::string CompressedOutput;
   double CompressionRatio;
   //The test results
@@ -97,6 +132,9 @@ private:
   std::string ActualCommand;
   std::vector<std::string> Arguments;
   bool StopTimePassed;
+  // Key of this run in the result cache, empty if it is not cached.
+  std::string ResultCacheKey;
+  bool CachedResult;
   bool RunUntilFail;
   int NumberOfRunsLeft;
   bool RunAgain;
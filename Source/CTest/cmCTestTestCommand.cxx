@@ -27,6 +27,9 @@ cmCTestTestCommand::cmCTestTestCommand()
   this->Arguments[ctt_SCHEDULE_RANDOM] = "SCHEDULE_RANDOM";
   this->Arguments[ctt_STOP_TIME] = "STOP_TIME";
   this->Arguments[ctt_TEST_LOAD] = "TEST_LOAD";
+  this->Arguments[ctt_RESOURCE_POOL] = "RESOURCE_POOL";
+  this->Arguments[ctt_SHARD] = "SHARD";
+  this->Arguments[ctt_CACHE_RESULTS] = "CACHE_RESULTS";
   this->Arguments[ctt_LAST] = 0;
   this->Last = ctt_LAST;
 }
@@ -104,6 +107,19 @@ cmCTestGenericHandler* cmCTestTestCommand::InitializeHandler()
     {
     this->CTest->SetStopTime(this->Values[ctt_STOP_TIME]);
     }
+  if(this->Values[ctt_RESOURCE_POOL])
+    {
+    handler->SetOption("ResourcePool",
+                       this->Values[ctt_RESOURCE_POOL]);
+    }
+  if(this->Values[ctt_SHARD])
+    {
+    handler->SetOption("Shard", this->Values[ctt_SHARD]);
+    }
+  if(this->Values[ctt_CACHE_RESULTS])
+    {
+    handler->SetOption("CacheResults", this->Values[ctt_CACHE_RESULTS]);
+    }
 
   // Test load is determined by: TEST_LOAD argument,
   // or CTEST_TEST_LOAD script variable, or ctest --test-load
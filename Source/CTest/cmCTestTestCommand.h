@@ -61,6 +61,9 @@ protected:
     ctt_SCHEDULE_RANDOM,
     ctt_STOP_TIME,
     ctt_TEST_LOAD,
+    ctt_RESOURCE_POOL,
+    ctt_SHARD,
+    ctt_CACHE_RESULTS,
     ctt_LAST
   };
 };
@@ -25,6 +25,7 @@
 #include "cmMakefile.h"
 #include "cmGlobalGenerator.h"
 #include "cmCommand.h"
+#include "cmCryptoHash.h"
 #include "cmSystemTools.h"
 #include "cmXMLWriter.h"
 #include "cm_utf8.h"
@@ -388,6 +389,7 @@ cmCTestTestHandler::cmCTestTestHandler()
   this->CustomMaximumFailedTestOutputSize = 300 * 1024;
 
   this->MemCheck = false;
+  this->UseResultCache = false;
 
   this->LogFile = 0;
 
@@ -432,6 +434,10 @@ void cmCTestTestHandler::Initialize()
   TestsToRunString = "";
   this->UseUnion = false;
   this->TestList.clear();
+
+  this->UseResultCache = false;
+  this->InputHashes.clear();
+  this->ResultCache.clear();
 }
 
 //----------------------------------------------------------------------
@@ -481,6 +487,13 @@ int cmCTestTestHandler::PostProcessHandler()
 //functions and commented...
 int cmCTestTestHandler::ProcessHandler()
 {
+  if(const char* shards = this->GetOption("MergeShards"))
+    {
+    std::vector<std::string> dirs;
+    cmSystemTools::ExpandListArgument(shards, dirs);
+    return this->MergeShards(dirs);
+    }
+
   // Update internal data structure from generic one
   this->SetTestsToRunInformation(this->GetOption("TestsToRunInformation"));
   this->SetUseUnion(cmSystemTools::IsOn(this->GetOption("UseUnion")));
@@ -519,6 +532,8 @@ int cmCTestTestHandler::ProcessHandler()
     this->SetExcludeRegExp(val);
     }
   this->SetRerunFailed(cmSystemTools::IsOn(this->GetOption("RerunFailed")));
+  this->UseResultCache = !this->MemCheck &&
+    cmSystemTools::IsOn(this->GetOption("CacheResults"));
 
   this->TestResults.clear();
 
@@ -921,6 +936,517 @@ void cmCTestTestHandler::ComputeTestListForRerunFailed()
   this->UpdateMaxTestNameWidth();
 }
 
+//----------------------------------------------------------------------
+bool cmCTestTestHandler::ParseShard(std::string const& spec,
+                                    unsigned long& index,
+                                    unsigned long& count)
+{
+  std::string::size_type slash = spec.find('/');
+  return slash != spec.npos &&
+    cmSystemTools::StringToULong(spec.substr(0, slash).c_str(), &index) &&
+    cmSystemTools::StringToULong(spec.substr(slash + 1).c_str(), &count) &&
+    index >= 1 && index <= count;
+}
+
+//----------------------------------------------------------------------
+struct cmCTestTestShardEntry
+{
+  double Cost;
+  std::string Name;
+  size_t Position;
+  bool operator<(cmCTestTestShardEntry const& r) const
+    {
+    if(this->Cost != r.Cost)
+      {
+      return this->Cost > r.Cost;
+      }
+    if(this->Name != r.Name)
+      {
+      return this->Name < r.Name;
+      }
+    return this->Position < r.Position;
+    }
+};
+
+//----------------------------------------------------------------------
+void cmCTestTestHandler::ComputeShard()
+{
+  const char* shard = this->GetOption("Shard");
+  if(!shard || !*shard)
+    {
+    return;
+    }
+  unsigned long index;
+  unsigned long count;
+  if(!cmCTestTestHandler::ParseShard(shard, index, count))
+    {
+    cmCTestLog(this->CTest, WARNING, "Invalid value for 'Shard' : "
+               << shard << std::endl);
+    return;
+    }
+
+  // Read the average cost of each test from previous runs.  All shards
+  // must see the same cost data to agree on the assignment.
+  std::vector<cmCTestMultiProcessHandler::CostEntry> costData;
+  std::vector<std::string> failed;
+  cmCTestMultiProcessHandler::ReadCostDataFile(
+    this->CTest->GetCostDataFile(), costData, failed);
+  std::map<std::string, double> costs;
+  for(std::vector<cmCTestMultiProcessHandler::CostEntry>::const_iterator
+        e = costData.begin(); e != costData.end(); ++e)
+    {
+    costs[e->Name] = e->Cost;
+    }
+
+  // Tests without a recorded cost count as an average test.
+  double knownCost = 0;
+  size_t numKnown = 0;
+  std::vector<cmCTestTestShardEntry> entries;
+  for(ListOfTests::iterator it = this->TestList.begin();
+      it != this->TestList.end(); ++it)
+    {
+    cmCTestTestShardEntry entry;
+    std::map<std::string, double>::const_iterator c = costs.find(it->Name);
+    entry.Cost = c != costs.end() && c->second > 0 ? c->second : -1;
+    entry.Name = it->Name;
+    entry.Position = entries.size();
+    entries.push_back(entry);
+    if(entry.Cost > 0)
+      {
+      knownCost += entry.Cost;
+      ++numKnown;
+      }
+    }
+  double defaultCost = numKnown ? knownCost / static_cast<double>(numKnown)
+                                : 1;
+  for(std::vector<cmCTestTestShardEntry>::iterator e = entries.begin();
+      e != entries.end(); ++e)
+    {
+    if(e->Cost < 0)
+      {
+      e->Cost = defaultCost;
+      }
+    }
+
+  // Assign the most expensive tests first, each to the shard with the
+  // least total cost so far.  Ties go to the shard with fewer tests and
+  // then to the lower shard number.
+  std::sort(entries.begin(), entries.end());
+  std::vector<double> shardCost(count, 0);
+  std::vector<size_t> shardTests(count, 0);
+  std::vector<unsigned long> assignment(entries.size(), 0);
+  for(std::vector<cmCTestTestShardEntry>::const_iterator e = entries.begin();
+      e != entries.end(); ++e)
+    {
+    unsigned long best = 0;
+    for(unsigned long s = 1; s < count; ++s)
+      {
+      if(shardCost[s] < shardCost[best] ||
+         (shardCost[s] == shardCost[best] &&
+          shardTests[s] < shardTests[best]))
+        {
+        best = s;
+        }
+      }
+    shardCost[best] += e->Cost;
+    ++shardTests[best];
+    assignment[e->Position] = best;
+    }
+
+  ListOfTests finalList;
+  for(size_t i = 0; i < this->TestList.size(); ++i)
+    {
+    if(assignment[i] == index - 1)
+      {
+      finalList.push_back(this->TestList[i]);
+      }
+    }
+  cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "Running shard " << index
+    << " of " << count << ": " << finalList.size() << " of "
+    << this->TestList.size() << " tests" << std::endl, this->Quiet);
+  this->TestList = finalList;
+}
+
+//----------------------------------------------------------------------
+static bool cmCTestTestHandlerGetElement(std::string const& line,
+                                         const char* name,
+                                         std::string& value)
+{
+  std::string open = "<";
+  open += name;
+  open += ">";
+  std::string::size_type start = line.find_first_not_of(" \t");
+  if(start == line.npos || line.compare(start, open.size(), open) != 0)
+    {
+    return false;
+    }
+  start += open.size();
+  std::string::size_type end = line.find("</", start);
+  value = line.substr(start, end == line.npos ? end : end - start);
+  return true;
+}
+
+//----------------------------------------------------------------------
+int cmCTestTestHandler::MergeShards(std::vector<std::string> const& dirs)
+{
+  cmCTestOptionalLog(this->CTest, HANDLER_OUTPUT, "Merging test results of "
+    << dirs.size() << " shards" << std::endl, this->Quiet);
+
+  std::string startDateTime;
+  std::string endDateTime;
+  unsigned long startTestTime = 0;
+  unsigned long endTestTime = 0;
+  std::string testList;
+  std::string tests;
+  size_t total = 0;
+  std::vector<std::string> failed;
+
+  // For each test keep the cost entry of the shard that ran it, which
+  // is the one that counts the most previous runs.
+  std::map<std::string, cmCTestMultiProcessHandler::CostEntry> costs;
+  std::vector<std::string> costOrder;
+  std::vector<std::string> lastFailed;
+  std::set<std::string> merged;
+
+  for(std::vector<std::string>::const_iterator d = dirs.begin();
+      d != dirs.end(); ++d)
+    {
+    std::string testingDir = *d + "/Testing";
+    std::string tagfile = testingDir + "/TAG";
+    cmsys::ifstream tfin(tagfile.c_str());
+    std::string tag;
+    if(!tfin || !cmSystemTools::GetLineFromStream(tfin, tag) || tag.empty())
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+        "Cannot read existing TAG file in " << testingDir << std::endl);
+      return -1;
+      }
+    std::string xmlfile = testingDir + "/" + tag + "/Test.xml";
+    cmsys::ifstream fin(xmlfile.c_str());
+    if(!fin)
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+        "Cannot read test results " << xmlfile << std::endl);
+      return -1;
+      }
+
+    // The XML writer escapes all content, so every line that starts
+    // with an element of interest is markup.
+    enum { Header, Body, List, Test } state = Header;
+    std::string line;
+    std::string value;
+    std::string name;
+    std::string date;
+    bool passed = false;
+    while(cmSystemTools::GetLineFromStream(fin, line))
+      {
+      switch(state)
+        {
+        case Header:
+          if(cmCTestTestHandlerGetElement(line, "Testing", value))
+            {
+            state = Body;
+            }
+          break;
+        case List:
+          if(line.find("</TestList>") != line.npos)
+            {
+            state = Body;
+            }
+          else
+            {
+            testList += "\n" + line;
+            }
+          break;
+        case Test:
+          tests += "\n" + line;
+          if(name.empty() && cmCTestTestHandlerGetElement(line, "Name", value))
+            {
+            name = value;
+            // A test counted twice would skew the totals.
+            if(!merged.insert(name).second)
+              {
+              cmCTestLog(this->CTest, ERROR_MESSAGE,
+                "Test " << name << " in " << xmlfile
+                << " has already been merged from another shard"
+                << std::endl);
+              return -1;
+              }
+            }
+          else if(cmCTestTestHandlerGetElement(line, "/Test", value))
+            {
+            state = Body;
+            ++total;
+            if(!passed)
+              {
+              failed.push_back(name);
+              }
+            }
+          break;
+        case Body:
+          if(cmCTestTestHandlerGetElement(line, "TestList", value))
+            {
+            state = List;
+            }
+          else if(line.find("<Test Status=") != line.npos)
+            {
+            state = Test;
+            tests += "\n" + line;
+            name = "";
+            passed = line.find("Status=\"passed\"") != line.npos;
+            }
+          else if(cmCTestTestHandlerGetElement(line, "StartTestTime", value))
+            {
+            unsigned long t = strtoul(value.c_str(), 0, 10);
+            if(startDateTime.empty() || t < startTestTime)
+              {
+              startTestTime = t;
+              startDateTime = date;
+              }
+            }
+          else if(cmCTestTestHandlerGetElement(line, "EndTestTime", value))
+            {
+            unsigned long t = strtoul(value.c_str(), 0, 10);
+            if(endDateTime.empty() || t > endTestTime)
+              {
+              endTestTime = t;
+              endDateTime = date;
+              }
+            }
+          else if(cmCTestTestHandlerGetElement(line, "StartDateTime", value) ||
+                  cmCTestTestHandlerGetElement(line, "EndDateTime", value))
+            {
+            // Remember the date until its time stamp follows.
+            date = value;
+            }
+          break;
+        }
+      }
+
+    std::string costfile = testingDir + "/Temporary/CTestCostData.txt";
+    std::vector<cmCTestMultiProcessHandler::CostEntry> costData;
+    std::vector<std::string> costFailed;
+    cmCTestMultiProcessHandler::ReadCostDataFile(costfile, costData,
+                                                 costFailed);
+    for(std::vector<std::string>::const_iterator f = costFailed.begin();
+        f != costFailed.end(); ++f)
+      {
+      if(std::find(lastFailed.begin(), lastFailed.end(), *f) ==
+         lastFailed.end())
+        {
+        lastFailed.push_back(*f);
+        }
+      }
+    for(std::vector<cmCTestMultiProcessHandler::CostEntry>::const_iterator
+          e = costData.begin(); e != costData.end(); ++e)
+      {
+      std::map<std::string, cmCTestMultiProcessHandler::CostEntry>::iterator
+        c = costs.find(e->Name);
+      if(c == costs.end())
+        {
+        costs[e->Name] = *e;
+        costOrder.push_back(e->Name);
+        }
+      else if(e->PreviousRuns > c->second.PreviousRuns)
+        {
+        c->second = *e;
+        }
+      }
+    }
+
+  if(!costOrder.empty())
+    {
+    std::string fname = this->CTest->GetCostDataFile();
+    cmSystemTools::MakeDirectory(
+      cmSystemTools::GetFilenamePath(fname).c_str());
+    cmsys::ofstream fout(fname.c_str());
+    for(std::vector<std::string>::const_iterator i = costOrder.begin();
+        i != costOrder.end(); ++i)
+      {
+      cmCTestMultiProcessHandler::CostEntry const& e = costs[*i];
+      fout << e.Name << " " << e.PreviousRuns << " " << e.Cost << "\n";
+      }
+    fout << "---\n";
+    for(std::vector<std::string>::const_iterator i = lastFailed.begin();
+        i != lastFailed.end(); ++i)
+      {
+      fout << *i << "\n";
+      }
+    }
+
+  if(this->CTest->GetProduceXML())
+    {
+    cmGeneratedFileStream xmlfile;
+    if(!this->StartResultingXML(cmCTest::PartTest, "Test", xmlfile))
+      {
+      cmCTestLog(this->CTest, ERROR_MESSAGE,
+        "Cannot create testing XML file" << std::endl);
+      return 1;
+      }
+    cmXMLWriter xml(xmlfile);
+    this->CTest->StartXML(xml, this->AppendXML);
+    xml.StartElement("Testing");
+    xml.Element("StartDateTime", startDateTime);
+    xml.Element("StartTestTime", startTestTime);
+    xml.StartElement("TestList");
+    xml.Fragment(testList);
+    xml.EndElement(); // TestList
+    xml.Fragment(tests);
+    xml.Element("EndDateTime", endDateTime);
+    xml.Element("EndTestTime", endTestTime);
+    xml.Element("ElapsedMinutes",
+      static_cast<int>((endTestTime - startTestTime) / 6) / 10.0);
+    xml.EndElement(); // Testing
+    this->CTest->EndXML(xml);
+    }
+
+  if(total == 0)
+    {
+    cmCTestLog(this->CTest, ERROR_MESSAGE, "No tests were found!!!"
+      << std::endl);
+    return 0;
+    }
+  float percent = float(total - failed.size()) * 100.0f / float(total);
+  if (!failed.empty() && percent > 99)
+    {
+    percent = 99;
+    }
+  cmCTestLog(this->CTest, HANDLER_OUTPUT, std::endl
+             << static_cast<int>(percent + .5f) << "% tests passed, "
+             << failed.size() << " tests failed out of "
+             << total << std::endl);
+  if(failed.empty())
+    {
+    return 0;
+    }
+  cmCTestLog(this->CTest, HANDLER_OUTPUT, std::endl
+             << "The following tests FAILED:" << std::endl);
+  for(std::vector<std::string>::const_iterator i = failed.begin();
+      i != failed.end(); ++i)
+    {
+    cmCTestLog(this->CTest, HANDLER_OUTPUT, "\t" << *i << std::endl);
+    }
+  return -1;
+}
+
+//----------------------------------------------------------------------
+void cmCTestTestHandler::LoadResultCache()
+{
+  this->ResultCache.clear();
+  this->InputHashes.clear();
+  std::string fname = this->CTest->GetBinaryDir()
+    + "/Testing/Temporary/CTestResultCache.txt";
+  cmsys::ifstream fin(fname.c_str());
+  std::string line;
+  while(fin && std::getline(fin, line))
+    {
+    std::string::size_type pos = line.find(' ');
+    if(pos != std::string::npos)
+      {
+      this->ResultCache[line.substr(pos + 1)] = line.substr(0, pos);
+      }
+    }
+
+  // Hash every input once, even if many tests share it.
+  std::set<std::string> unique;
+  for(ListOfTests::const_iterator it = this->TestList.begin();
+      it != this->TestList.end(); ++it)
+    {
+    unique.insert(it->Inputs.begin(), it->Inputs.end());
+    }
+  std::vector<std::string> files(unique.begin(), unique.end());
+  std::vector<std::string> hashes;
+  cmCryptoHash::HashFiles("SHA256", files, hashes);
+  for(size_t i = 0; i < files.size() && i < hashes.size(); ++i)
+    {
+    this->InputHashes[files[i]] = hashes[i];
+    }
+}
+
+//----------------------------------------------------------------------
+void cmCTestTestHandler::SaveResultCache()
+{
+  std::string fname = this->CTest->GetBinaryDir()
+    + "/Testing/Temporary/CTestResultCache.txt";
+  cmGeneratedFileStream fout(fname.c_str());
+  for(std::map<std::string, std::string>::const_iterator i =
+      this->ResultCache.begin(); i != this->ResultCache.end(); ++i)
+    {
+    fout << i->second << " " << i->first << "\n";
+    }
+}
+
+//----------------------------------------------------------------------
+std::string
+cmCTestTestHandler::ComputeResultCacheKey(cmCTestTestProperties* props,
+                                          std::string const& commandLine)
+{
+  // A test that does not name its inputs always runs.
+  if(!this->UseResultCache || props->Inputs.empty())
+    {
+    return "";
+    }
+  std::ostringstream key;
+  key << "command " << commandLine << "\n"
+      << "directory " << props->Directory << "\n"
+      << "config " << this->CTest->GetConfigType() << "\n"
+      << "will_fail " << props->WillFail << "\n"
+      << "skip_return_code " << props->SkipReturnCode << "\n";
+  for(std::vector<std::string>::const_iterator i =
+      props->Environment.begin(); i != props->Environment.end(); ++i)
+    {
+    key << "environment " << *i << "\n";
+    }
+  for(size_t i = 0; i < props->RequiredRegularExpressions.size(); ++i)
+    {
+    key << "pass_regex " << props->RequiredRegularExpressions[i].second
+        << "\n";
+    }
+  for(size_t i = 0; i < props->ErrorRegularExpressions.size(); ++i)
+    {
+    key << "fail_regex " << props->ErrorRegularExpressions[i].second
+        << "\n";
+    }
+  for(std::vector<std::string>::const_iterator i = props->Inputs.begin();
+      i != props->Inputs.end(); ++i)
+    {
+    std::map<std::string, std::string>::const_iterator h =
+      this->InputHashes.find(*i);
+    if(h == this->InputHashes.end() || h->second.empty())
+      {
+      // An input that cannot be read never matches an earlier run.
+      return "";
+      }
+    key << "input " << *i << " " << h->second << "\n";
+    }
+  cmsys::auto_ptr<cmCryptoHash> hasher(cmCryptoHash::New("SHA256"));
+  return hasher->HashString(key.str());
+}
+
+//----------------------------------------------------------------------
+bool cmCTestTestHandler::IsResultCached(std::string const& name,
+                                        std::string const& key)
+{
+  std::map<std::string, std::string>::const_iterator i =
+    this->ResultCache.find(name);
+  return !key.empty() && i != this->ResultCache.end() && i->second == key;
+}
+
+//----------------------------------------------------------------------
+void cmCTestTestHandler::RecordResult(std::string const& name,
+                                      std::string const& key, bool passed)
+{
+  if(passed && !key.empty())
+    {
+    this->ResultCache[name] = key;
+    }
+  else
+    {
+    this->ResultCache.erase(name);
+    }
+}
+
+//----------------------------------------------------------------------
 void cmCTestTestHandler::UpdateMaxTestNameWidth()
 {
   std::string::size_type max = this->CTest->GetMaxTestNameWidth();
@@ -1064,6 +1590,13 @@ void cmCTestTestHandler::ProcessDirectory(std::vector<std::string> &passed,
                                          std::vector<std::string> &failed)
 {
   this->ComputeTestList();
+  this->ComputeShard();
+  bool runTests = !this->CTest->ShouldPrintLabels() &&
+    !this->CTest->GetShowOnly();
+  if(this->UseResultCache && runTests)
+    {
+    this->LoadResultCache();
+    }
   this->StartTest = this->CTest->CurrentTime();
   this->StartTestTime = static_cast<unsigned int>(cmSystemTools::GetTime());
   double elapsed_time_start = cmSystemTools::GetTime();
@@ -1074,6 +1607,20 @@ void cmCTestTestHandler::ProcessDirectory(std::vector<std::string> &passed,
   parallel->SetParallelLevel(this->CTest->GetParallelLevel());
   parallel->SetTestHandler(this);
   parallel->SetQuiet(this->Quiet);
+  parallel->SetResourcePool(this->CTest->GetResourcePool());
+  if(const char* pool = this->GetOption("ResourcePool"))
+    {
+    cmCTest::ResourcePoolType resourcePool;
+    std::string errormsg;
+    if(cmCTest::ParseResourcePool(pool, resourcePool, errormsg))
+      {
+      parallel->SetResourcePool(resourcePool);
+      }
+    else
+      {
+      cmCTestLog(this->CTest, WARNING, errormsg << std::endl);
+      }
+    }
   if(this->TestLoad > 0)
     {
     parallel->SetTestLoad(this->TestLoad);
@@ -1150,6 +1697,10 @@ void cmCTestTestHandler::ProcessDirectory(std::vector<std::string> &passed,
     parallel->RunTests();
     }
   delete parallel;
+  if(this->UseResultCache && runTests)
+    {
+    this->SaveResultCache();
+    }
   this->EndTest = this->CTest->CurrentTime();
   this->EndTestTime = static_cast<unsigned int>(cmSystemTools::GetTime());
   this->ElapsedTestingTime = cmSystemTools::GetTime() - elapsed_time_start;
@@ -2165,6 +2716,29 @@ bool cmCTestTestHandler::SetTestsProperties(
 
             rtit->LockedResources.insert(lval.begin(), lval.end());
             }
+          if ( key == "RESOURCES" )
+            {
+            std::vector<std::string> lval;
+            cmSystemTools::ExpandListArgument(val, lval);
+
+            for(std::vector<std::string>::const_iterator ri = lval.begin();
+                ri != lval.end(); ++ri)
+              {
+              // Each entry is "<name>[:<amount>]".
+              std::string::size_type pos = ri->find(':');
+              unsigned long amount = 1;
+              if(pos != ri->npos &&
+                 !cmSystemTools::StringToULong(ri->substr(pos+1).c_str(),
+                                               &amount))
+                {
+                cmCTestLog(this->CTest, WARNING,
+                  "Invalid RESOURCES entry for test " << rtit->Name
+                  << ": " << *ri << std::endl);
+                continue;
+                }
+              rtit->Resources[ri->substr(0, pos)] = amount;
+              }
+            }
           if ( key == "TIMEOUT" )
             {
             rtit->Timeout = atof(val.c_str());
@@ -2178,6 +2752,11 @@ bool cmCTestTestHandler::SetTestsProperties(
             {
             cmSystemTools::ExpandListArgument(val, rtit->RequiredFiles);
             }
+          if ( key == "INPUTS" )
+            {
+            rtit->Inputs.clear();
+            cmSystemTools::ExpandListArgument(val, rtit->Inputs);
+            }
           if ( key == "RUN_SERIAL" )
             {
             rtit->RunSerial = cmSystemTools::IsOn(val.c_str());
@@ -73,6 +73,13 @@ public:
   ///! pass the -I argument down
   void SetTestsToRunInformation(const char*);
 
+  /**
+   * Parse a shard specification of the form "<index>/<count>" with
+   * 1 <= index <= count.
+   */
+  static bool ParseShard(std::string const& spec,
+                         unsigned long& index, unsigned long& count);
+
   cmCTestTestHandler();
 
   /*
@@ -97,6 +104,8 @@ public:
     std::string Directory;
     std::vector<std::string> Args;
     std::vector<std::string> RequiredFiles;
+    // files whose content decides the result of the test
+    std::vector<std::string> Inputs;
     std::vector<std::string> Depends;
     std::vector<std::string> AttachedFiles;
     std::vector<std::string> AttachOnFail;
@@ -123,6 +132,8 @@ public:
     std::vector<std::string> Environment;
     std::vector<std::string> Labels;
     std::set<std::string> LockedResources;
+    // amount of each countable resource taken while running
+    std::map<std::string, unsigned long> Resources;
   };
 
   struct cmCTestTestResult
@@ -234,6 +245,25 @@ private:
   // based on LastTestFailed.log
   void ComputeTestListForRerunFailed();
 
+  // keep only the tests of the shard given by the Shard option
+  void ComputeShard();
+
+  // combine the results of shards run in other build trees
+  int MergeShards(std::vector<std::string> const& dirs);
+
+  // read the tests that passed before and hash the inputs of the tests
+  // to run, or write the updated record back
+  void LoadResultCache();
+  void SaveResultCache();
+
+  // key for a test run from its inputs, command line and environment,
+  // or empty if the result of the test may not be cached
+  std::string ComputeResultCacheKey(cmCTestTestProperties* props,
+                                    std::string const& commandLine);
+  bool IsResultCached(std::string const& name, std::string const& key);
+  void RecordResult(std::string const& name, std::string const& key,
+                    bool passed);
+
   void UpdateMaxTestNameWidth();
 
   bool GetValue(const char* tag,
@@ -294,6 +324,12 @@ private:
   std::ostream* LogFile;
 
   bool RerunFailed;
+
+  bool UseResultCache;
+  // hash of the content of each test input, empty if it cannot be read
+  std::map<std::string, std::string> InputHashes;
+  // key of the last passing run of each test
+  std::map<std::string, std::string> ResultCache;
 };
 
 #endif
@@ -36,6 +36,7 @@ bool cmAddCustomCommandCommand
   bool verbatim = false;
   bool append = false;
   bool uses_terminal = false;
+  bool job_server_aware = false;
   std::string implicit_depends_lang;
   cmCustomCommand::ImplicitDependsList implicit_depends;
 
@@ -108,6 +109,10 @@ bool cmAddCustomCommandCommand
       {
       uses_terminal = true;
       }
+    else if(copy == "JOB_SERVER_AWARE")
+      {
+      job_server_aware = true;
+      }
     else if(copy == "TARGET")
       {
       doing = doing_target;
@@ -279,6 +284,12 @@ bool cmAddCustomCommandCommand
     this->SetError("given APPEND option with no OUTPUT.");
     return false;
     }
+  if(job_server_aware && output.empty())
+    {
+    this->SetError("JOB_SERVER_AWARE may only be used with the OUTPUT "
+                   "signature.");
+    return false;
+    }
 
   // Make sure the output names and locations are safe.
   if(!this->CheckOutputs(output) ||
@@ -300,6 +311,10 @@ bool cmAddCustomCommandCommand
         cc->AppendCommands(commandLines);
         cc->AppendDepends(depends);
         cc->AppendImplicitDepends(implicit_depends);
+        if(job_server_aware)
+          {
+          cc->SetJobserverAware(true);
+          }
         return true;
         }
       }
@@ -339,8 +354,9 @@ bool cmAddCustomCommandCommand
                                              working.c_str(), false,
                                              escapeOldStyle, uses_terminal);
 
-    // Add implicit dependency scanning requests if any were given.
-    if(!implicit_depends.empty())
+    // Add implicit dependency scanning requests and the jobserver
+    // request if any were given.
+    if(!implicit_depends.empty() || job_server_aware)
       {
       bool okay = false;
       if(cmSourceFile* sf =
@@ -349,7 +365,11 @@ bool cmAddCustomCommandCommand
         if(cmCustomCommand* cc = sf->GetCustomCommand())
           {
           okay = true;
-          cc->SetImplicitDepends(implicit_depends);
+          if(!implicit_depends.empty())
+            {
+            cc->SetImplicitDepends(implicit_depends);
+            }
+          cc->SetJobserverAware(job_server_aware);
           }
         }
       if(!okay)
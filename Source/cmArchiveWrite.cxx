@@ -13,6 +13,7 @@
 
 #include "cmSystemTools.h"
 #include "cmLocale.h"
+#include "cmWorkerPool.h"
 #include <cmsys/Directory.hxx>
 #include <cmsys/FStream.hxx>
 #include <cm_libarchive.h>
@@ -61,6 +62,266 @@ public:
   operator struct archive_entry*() { return this->Object; }
 };
 
+//----------------------------------------------------------------------------
+static bool cm_archive_add_filter(struct archive* a,
+                                  cmArchiveWrite::Compress c,
+                                  std::string& error)
+{
+  switch (c)
+    {
+    case cmArchiveWrite::CompressNone:
+      if(archive_write_add_filter_none(a) != ARCHIVE_OK)
+        {
+        error = "archive_write_add_filter_none: ";
+        error += cm_archive_error_string(a);
+        return false;
+        }
+      break;
+    case cmArchiveWrite::CompressCompress:
+      if(archive_write_add_filter_compress(a) != ARCHIVE_OK)
+        {
+        error = "archive_write_add_filter_compress: ";
+        error += cm_archive_error_string(a);
+        return false;
+        }
+      break;
+    case cmArchiveWrite::CompressGZip:
+      if(archive_write_add_filter_gzip(a) != ARCHIVE_OK)
+        {
+        error = "archive_write_add_filter_gzip: ";
+        error += cm_archive_error_string(a);
+        return false;
+        }
+      break;
+    case cmArchiveWrite::CompressBZip2:
+      if(archive_write_add_filter_bzip2(a) != ARCHIVE_OK)
+        {
+        error = "archive_write_add_filter_bzip2: ";
+        error += cm_archive_error_string(a);
+        return false;
+        }
+      break;
+    case cmArchiveWrite::CompressLZMA:
+      if(archive_write_add_filter_lzma(a) != ARCHIVE_OK)
+        {
+        error = "archive_write_add_filter_lzma: ";
+        error += cm_archive_error_string(a);
+        return false;
+        }
+      break;
+    case cmArchiveWrite::CompressXZ:
+      if(archive_write_add_filter_xz(a) != ARCHIVE_OK)
+        {
+        error = "archive_write_add_filter_xz: ";
+        error += cm_archive_error_string(a);
+        return false;
+        }
+      break;
+    };
+  return true;
+}
+
+//----------------------------------------------------------------------------
+// Compress one block of the archive stream as a complete, independent
+// gzip member, bzip2 stream or xz stream.  The formats allow such pieces
+// to be concatenated, and standard decompressors (including libarchive)
+// read the concatenation back as one stream.
+class cmArchiveWrite::Block: public cmWorkerPool::Job
+{
+public:
+  Block(cmArchiveWrite::Compress c, std::string& data): Type(c)
+    {
+    this->Input.swap(data);
+    }
+
+  virtual void Run()
+    {
+    struct archive* a = archive_write_new();
+    if(this->CompressInput(a))
+      {
+      this->Input.clear();
+      }
+    else if(this->Error.empty())
+      {
+      this->Error = cm_archive_error_string(a);
+      }
+    archive_write_free(a);
+    }
+
+  std::string const& GetOutput() const { return this->Output; }
+  std::string const& GetError() const { return this->Error; }
+
+private:
+  bool CompressInput(struct archive* a)
+    {
+    if(!cm_archive_add_filter(a, this->Type, this->Error) ||
+       archive_write_set_format_raw(a) != ARCHIVE_OK ||
+       archive_write_set_bytes_in_last_block(a, 1) != ARCHIVE_OK ||
+       archive_write_open(a, this, 0,
+         reinterpret_cast<archive_write_callback*>(&Block::Write),
+         0) != ARCHIVE_OK)
+      {
+      return false;
+      }
+    Entry e;
+    archive_entry_set_filetype(e, AE_IFREG);
+    if(archive_write_header(a, e) != ARCHIVE_OK)
+      {
+      return false;
+      }
+    const char* data = this->Input.data();
+    size_t nleft = this->Input.size();
+    while(nleft > 0)
+      {
+      __LA_SSIZE_T n = archive_write_data(a, data, nleft);
+      if(n <= 0)
+        {
+        return false;
+        }
+      data += n;
+      nleft -= static_cast<size_t>(n);
+      }
+    return archive_write_close(a) == ARCHIVE_OK;
+    }
+
+  // archive_write_callback
+  static __LA_SSIZE_T Write(struct archive*, void *cd,
+                            const void *b, size_t n)
+    {
+    Block* self = static_cast<Block*>(cd);
+    self->Output.append(static_cast<const char*>(b), n);
+    return static_cast<__LA_SSIZE_T>(n);
+    }
+
+  cmArchiveWrite::Compress Type;
+  std::string Input;
+  std::string Output;
+  std::string Error;
+};
+
+//----------------------------------------------------------------------------
+// Split the uncompressed archive stream into blocks, compress them on a
+// pool of threads and write the results to the output in order.
+class cmArchiveWrite::BlockCompressor
+{
+public:
+  BlockCompressor(std::ostream& os, Compress c, unsigned int threads):
+    Stream(os), Type(c), Pool(threads), BlocksWritten(0)
+    {
+    // xz needs larger blocks to make use of its dictionary.
+    this->BlockSize = (c == CompressXZ? 8 : 1) << 20;
+    this->MaxInFlight = 2 * this->Pool.GetNumberOfThreads();
+    }
+
+  ~BlockCompressor()
+    {
+    while(!this->InFlight.empty())
+      {
+      this->Pool.Wait(this->InFlight.front());
+      delete this->InFlight.front();
+      this->InFlight.pop_front();
+      }
+    }
+
+  bool Write(const char* data, size_t n)
+    {
+    // Fill the current block straight from the input.  A full block
+    // takes over the buffer, so no data is moved more than once.
+    while(n > 0)
+      {
+      size_t room = this->BlockSize - this->Buffer.size();
+      size_t take = n < room? n : room;
+      this->Buffer.append(data, take);
+      data += take;
+      n -= take;
+      if(this->Buffer.size() == this->BlockSize)
+        {
+        if(!this->Submit(this->Buffer))
+          {
+          return false;
+          }
+        this->Buffer.clear();
+        this->Buffer.reserve(this->BlockSize);
+        }
+      }
+    return true;
+    }
+
+  bool Finish()
+    {
+    // Always produce at least one block so that an empty stream is
+    // still a valid compressed file.
+    if((!this->Buffer.empty() ||
+        (this->BlocksWritten == 0 && this->InFlight.empty())) &&
+       !this->Submit(this->Buffer))
+      {
+      return false;
+      }
+    while(!this->InFlight.empty())
+      {
+      if(!this->WriteFront())
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  std::string const& GetError() const { return this->Error; }
+
+private:
+  bool Submit(std::string& data)
+    {
+    Block* block = new Block(this->Type, data);
+    this->InFlight.push_back(block);
+    this->Pool.Submit(block);
+    while(this->InFlight.size() > this->MaxInFlight)
+      {
+      if(!this->WriteFront())
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  bool WriteFront()
+    {
+    Block* block = this->InFlight.front();
+    this->Pool.Wait(block);
+    this->InFlight.pop_front();
+    bool okay = block->GetError().empty();
+    if(okay)
+      {
+      std::string const& out = block->GetOutput();
+      okay = this->Stream.write(out.data(),
+                                static_cast<std::streamsize>(out.size()))
+        ? true : false;
+      if(!okay)
+        {
+        this->Error = "error writing compressed block";
+        }
+      }
+    else
+      {
+      this->Error = "block compression failed: " + block->GetError();
+      }
+    delete block;
+    ++this->BlocksWritten;
+    return okay;
+    }
+
+  std::ostream& Stream;
+  Compress Type;
+  cmWorkerPool Pool;
+  size_t BlockSize;
+  size_t MaxInFlight;
+  size_t BlocksWritten;
+  std::string Buffer;
+  std::deque<Block*> InFlight;
+  std::string Error;
+};
+
 //----------------------------------------------------------------------------
 struct cmArchiveWrite::Callback
 {
@@ -69,6 +330,16 @@ struct cmArchiveWrite::Callback
                             const void *b, size_t n)
     {
     cmArchiveWrite* self = static_cast<cmArchiveWrite*>(cd);
+    if(self->Compressor)
+      {
+      if(self->Compressor->Write(static_cast<const char*>(b), n))
+        {
+        return static_cast<__LA_SSIZE_T>(n);
+        }
+      archive_set_error(self->Archive, -1, "%s",
+                        self->Compressor->GetError().c_str());
+      return static_cast<__LA_SSIZE_T>(-1);
+      }
     if(self->Stream.write(static_cast<const char*>(b),
                           static_cast<std::streamsize>(n)))
       {
@@ -81,66 +352,34 @@ struct cmArchiveWrite::Callback
     }
 };
 
+//----------------------------------------------------------------------------
+bool cmArchiveWrite::SupportsThreads(Compress c)
+{
+  return c == CompressGZip || c == CompressBZip2 || c == CompressXZ;
+}
+
 //----------------------------------------------------------------------------
 cmArchiveWrite::cmArchiveWrite(
-  std::ostream& os, Compress c, std::string const& format):
+  std::ostream& os, Compress c, std::string const& format, int threads):
     Stream(os),
     Archive(archive_write_new()),
     Disk(archive_read_disk_new()),
+    Compressor(0),
+    Closed(false),
     Verbose(false),
     Format(format)
 {
-  switch (c)
+  if(threads != 1 && SupportsThreads(c))
     {
-    case CompressNone:
-      if(archive_write_add_filter_none(this->Archive) != ARCHIVE_OK)
-        {
-        this->Error = "archive_write_add_filter_none: ";
-        this->Error += cm_archive_error_string(this->Archive);
-        return;
-        }
-      break;
-    case CompressCompress:
-      if(archive_write_add_filter_compress(this->Archive) != ARCHIVE_OK)
-        {
-        this->Error = "archive_write_add_filter_compress: ";
-        this->Error += cm_archive_error_string(this->Archive);
-        return;
-        }
-      break;
-    case CompressGZip:
-      if(archive_write_add_filter_gzip(this->Archive) != ARCHIVE_OK)
-        {
-        this->Error = "archive_write_add_filter_gzip: ";
-        this->Error += cm_archive_error_string(this->Archive);
-        return;
-        }
-      break;
-    case CompressBZip2:
-      if(archive_write_add_filter_bzip2(this->Archive) != ARCHIVE_OK)
-        {
-        this->Error = "archive_write_add_filter_bzip2: ";
-        this->Error += cm_archive_error_string(this->Archive);
-        return;
-        }
-      break;
-    case CompressLZMA:
-      if(archive_write_add_filter_lzma(this->Archive) != ARCHIVE_OK)
-        {
-        this->Error = "archive_write_add_filter_lzma: ";
-        this->Error += cm_archive_error_string(this->Archive);
-        return;
-        }
-      break;
-    case CompressXZ:
-      if(archive_write_add_filter_xz(this->Archive) != ARCHIVE_OK)
-        {
-        this->Error = "archive_write_add_filter_xz: ";
-        this->Error += cm_archive_error_string(this->Archive);
-        return;
-        }
-      break;
-    };
+    // libarchive produces the uncompressed stream and we compress it.
+    this->Compressor = new BlockCompressor(
+      os, c, cmWorkerPool::NormalizeThreadCount(threads));
+    c = CompressNone;
+    }
+  if(!cm_archive_add_filter(this->Archive, c, this->Error))
+    {
+    return;
+    }
 #if !defined(_WIN32) || defined(__CYGWIN__)
   if (archive_read_disk_set_standard_lookup(this->Disk) != ARCHIVE_OK)
     {
@@ -180,8 +419,38 @@ cmArchiveWrite::cmArchiveWrite(
 //----------------------------------------------------------------------------
 cmArchiveWrite::~cmArchiveWrite()
 {
+  if(!this->Closed && this->Okay() && !this->Close())
+    {
+    cmSystemTools::Error("cmArchiveWrite: ", this->Error.c_str());
+    }
   archive_read_free(this->Disk);
   archive_write_free(this->Archive);
+  delete this->Compressor;
+}
+
+//----------------------------------------------------------------------------
+bool cmArchiveWrite::Close()
+{
+  if(this->Closed)
+    {
+    return this->Okay();
+    }
+  this->Closed = true;
+  if(archive_write_close(this->Archive) != ARCHIVE_OK && this->Okay())
+    {
+    this->Error = "archive_write_close: ";
+    this->Error += cm_archive_error_string(this->Archive);
+    }
+  // The compressor still holds the blocks that are in flight.
+  if(this->Compressor && !this->Compressor->Finish() && this->Okay())
+    {
+    this->Error = this->Compressor->GetError();
+    }
+  if(!this->Stream.flush() && this->Okay())
+    {
+    this->Error = "error writing archive";
+    }
+  return this->Okay();
 }
 
 //----------------------------------------------------------------------------
@@ -54,9 +54,14 @@ public:
     CompressXZ
   };
 
-  /** Construct with output stream to which to write archive.  */
+  /**
+   * Construct with output stream to which to write archive.  A thread
+   * count other than one compresses the stream in independent blocks on
+   * that many threads (zero means one per processor) when the compression
+   * type supports it.  See SupportsThreads().
+   */
   cmArchiveWrite(std::ostream& os, Compress c = CompressNone,
-    std::string const& format = "paxr");
+    std::string const& format = "paxr", int threads = 1);
 
   ~cmArchiveWrite();
 
@@ -73,6 +78,17 @@ public:
      const char* prefix = 0,
      bool recursive = true);
 
+  /**
+   * Finish the archive and flush all remaining data to the output
+   * stream.  Returns false on error; see GetError().  The destructor
+   * closes the archive if this has not been called, but then has no
+   * way to report a failure to the caller.
+   */
+  bool Close();
+
+  /** Returns true if the compression type can use multiple threads.  */
+  static bool SupportsThreads(Compress c);
+
   /** Returns true if there has been no error.  */
   operator safe_bool() const
     { return this->Okay()? &cmArchiveWrite::safe_bool_true : 0; }
@@ -154,10 +170,14 @@ private:
   friend struct Callback;
 
   class Entry;
+  class Block;
+  class BlockCompressor;
 
   std::ostream& Stream;
   struct archive* Archive;
   struct archive* Disk;
+  BlockCompressor* Compressor;
+  bool Closed;
   bool Verbose;
   std::string Format;
   std::string Error;
@@ -397,6 +397,51 @@ void cmCTest::SetTestLoad(unsigned long load)
   this->TestLoad = load;
 }
 
+//----------------------------------------------------------------------------
+bool cmCTest::ParseResourcePool(std::string const& spec,
+                                ResourcePoolType& pool,
+                                std::string& errormsg)
+{
+  std::vector<std::string> lines;
+  cmSystemTools::Split(spec.c_str(), lines);
+  for(std::vector<std::string>::const_iterator li = lines.begin();
+      li != lines.end(); ++li)
+    {
+    std::string line = cmSystemTools::TrimWhitespace(*li);
+    if(line.empty() || line[0] == '#')
+      {
+      continue;
+      }
+    std::vector<std::string> entries = cmSystemTools::tokenize(line, ",");
+    for(std::vector<std::string>::const_iterator ei = entries.begin();
+        ei != entries.end(); ++ei)
+      {
+      std::string entry = cmSystemTools::TrimWhitespace(*ei);
+      if(entry.empty())
+        {
+        continue;
+        }
+      std::string::size_type pos = entry.find('=');
+      unsigned long amount;
+      std::string name;
+      if(pos != entry.npos)
+        {
+        name = cmSystemTools::TrimWhitespace(entry.substr(0, pos));
+        }
+      if(name.empty() || !cmSystemTools::StringToULong(
+           cmSystemTools::TrimWhitespace(entry.substr(pos+1)).c_str(),
+           &amount))
+        {
+        errormsg = "Invalid resource pool entry '" + entry +
+          "', expected '<name>=<amount>'";
+        return false;
+        }
+      pool[name] = amount;
+      }
+    }
+  return true;
+}
+
 //----------------------------------------------------------------------------
 bool cmCTest::ShouldCompressTestOutput()
 {
@@ -2089,6 +2134,38 @@ bool cmCTest::HandleCommandLineArguments(size_t &i,
       }
     }
 
+  if(this->CheckArgument(arg, "--resource-pool") && i < args.size() - 1)
+    {
+    i++;
+    if(!cmCTest::ParseResourcePool(args[i], this->ResourcePool, errormsg))
+      {
+      return false;
+      }
+    }
+
+  if(this->CheckArgument(arg, "--resource-pool-file") && i < args.size() - 1)
+    {
+    i++;
+    std::string spec;
+    cmsys::ifstream fin(args[i].c_str());
+    if(!fin)
+      {
+      errormsg = "Cannot read resource pool file: " + args[i];
+      return false;
+      }
+    std::string line;
+    while(cmSystemTools::GetLineFromStream(fin, line))
+      {
+      spec += line;
+      spec += "\n";
+      }
+    if(!cmCTest::ParseResourcePool(spec, this->ResourcePool, errormsg))
+      {
+      errormsg += " in " + args[i];
+      return false;
+      }
+    }
+
   if(this->CheckArgument(arg, "--no-compress-output"))
     {
     this->CompressTestOutput = false;
@@ -2312,6 +2389,46 @@ bool cmCTest::HandleCommandLineArguments(size_t &i,
     this->GetHandler("test")->SetPersistentOption("RerunFailed", "true");
     this->GetHandler("memcheck")->SetPersistentOption("RerunFailed", "true");
     }
+
+  if(this->CheckArgument(arg, "--cache-results"))
+    {
+    this->GetHandler("test")->SetPersistentOption("CacheResults", "true");
+    }
+
+  if(this->CheckArgument(arg, "--shard") && i < args.size() - 1)
+    {
+    i++;
+    unsigned long index;
+    unsigned long count;
+    if(!cmCTestTestHandler::ParseShard(args[i], index, count))
+      {
+      errormsg = "'--shard' requires an argument of the form "
+        "<index>/<count> with 1 <= <index> <= <count>, not '" + args[i] + "'";
+      return false;
+      }
+    this->GetHandler("test")->SetPersistentOption("Shard", args[i].c_str());
+    this->GetHandler("memcheck")->
+      SetPersistentOption("Shard", args[i].c_str());
+    }
+
+  if(this->CheckArgument(arg, "--merge-shards"))
+    {
+    std::vector<std::string> dirs;
+    while(i < args.size() - 1 && args[i + 1].find('-') != 0)
+      {
+      i++;
+      dirs.push_back(args[i]);
+      }
+    if(dirs.empty())
+      {
+      errormsg = "'--merge-shards' requires at least one directory";
+      return false;
+      }
+    this->ProduceXML = true;
+    this->SetTest("Test");
+    this->GetHandler("test")->
+      SetPersistentOption("MergeShards", cmJoin(dirs, ";").c_str());
+    }
   return true;
 }
 
@@ -164,6 +164,19 @@ public:
   unsigned long GetTestLoad() { return this->TestLoad; }
   void SetTestLoad(unsigned long);
 
+  /** Countable resources shared by parallel tests, see the RESOURCES
+      test property.  Maps each resource name to the amount available.  */
+  typedef std::map<std::string, unsigned long> ResourcePoolType;
+  ResourcePoolType const& GetResourcePool() { return this->ResourcePool; }
+
+  /**
+   * Parse "<name>=<amount>" entries separated by commas or newlines and
+   * add them to the given pool.  Lines starting in '#' are ignored.
+   */
+  static bool ParseResourcePool(std::string const& spec,
+                                ResourcePoolType& pool,
+                                std::string& errormsg);
+
   /**
    * Check if CTest file exists
    */
@@ -505,6 +518,8 @@ private:
 
   unsigned long           TestLoad;
 
+  ResourcePoolType        ResourcePool;
+
   int                     CompatibilityMode;
 
   // information for the --build-and-test options
@@ -11,6 +11,8 @@
 ============================================================================*/
 #include "cmCryptoHash.h"
 
+#include "cmWorkerPool.h"
+
 #include <cmsys/MD5.h>
 #include <cmsys/FStream.hxx>
 #include "cm_sha2.h"
@@ -54,8 +56,9 @@ std::string cmCryptoHash::HashFile(const std::string& file)
 
   this->Initialize();
 
-  // Should be efficient enough on most system:
-  cm_sha2_uint64_t buffer[512];
+  // Read large blocks to keep the number of stream calls low when
+  // hashing big files.
+  cm_sha2_uint64_t buffer[8192];
   char* buffer_c = reinterpret_cast<char*>(buffer);
   unsigned char const* buffer_uc =
     reinterpret_cast<unsigned char const*>(buffer);
@@ -79,6 +82,65 @@ std::string cmCryptoHash::HashFile(const std::string& file)
   return "";
 }
 
+//----------------------------------------------------------------------------
+class cmCryptoHashFileJob: public cmWorkerPool::Job
+{
+public:
+  cmCryptoHashFileJob(): Algo(0), File(0), Result(0) {}
+  virtual void Run()
+    {
+    // Each job uses its own hash state so jobs may run concurrently.
+    cmsys::auto_ptr<cmCryptoHash> hash = cmCryptoHash::New(this->Algo);
+    *this->Result = hash->HashFile(*this->File);
+    }
+  const char* Algo;
+  std::string const* File;
+  std::string* Result;
+};
+
+//----------------------------------------------------------------------------
+bool cmCryptoHash::HashFiles(const char* algo,
+                             std::vector<std::string> const& files,
+                             std::vector<std::string>& hashes,
+                             unsigned int threads)
+{
+  cmsys::auto_ptr<cmCryptoHash> hash = cmCryptoHash::New(algo);
+  if(!hash.get())
+    {
+    return false;
+    }
+  hashes.clear();
+  hashes.resize(files.size());
+
+  threads = cmWorkerPool::NormalizeThreadCount(static_cast<int>(threads));
+  if(threads > files.size())
+    {
+    threads = static_cast<unsigned int>(files.size());
+    }
+  if(threads <= 1)
+    {
+    for(std::vector<std::string>::size_type i = 0; i < files.size(); ++i)
+      {
+      hashes[i] = hash->HashFile(files[i]);
+      }
+    return true;
+    }
+
+  // The pool does not own its jobs, so keep them all alive here until
+  // every one of them is done.
+  std::vector<cmCryptoHashFileJob> jobs(files.size());
+  cmWorkerPool pool(threads);
+  for(std::vector<std::string>::size_type i = 0; i < files.size(); ++i)
+    {
+    jobs[i].Algo = algo;
+    jobs[i].File = &files[i];
+    jobs[i].Result = &hashes[i];
+    pool.Submit(&jobs[i]);
+    }
+  pool.WaitAll();
+  return true;
+}
+
 //----------------------------------------------------------------------------
 cmCryptoHashMD5::cmCryptoHashMD5(): MD5(cmsysMD5_New())
 {
@@ -23,6 +23,18 @@ public:
   static cmsys::auto_ptr<cmCryptoHash> New(const char* algo);
   std::string HashString(const std::string& input);
   std::string HashFile(const std::string& file);
+
+  /**
+   * Hash many files with the named algorithm on up to the given number
+   * of threads (zero selects one per logical processor).  The hashes
+   * are stored in the order of the input files.  An empty entry marks
+   * a file that could not be read.  Returns false if the algorithm is
+   * not known.
+   */
+  static bool HashFiles(const char* algo,
+                        std::vector<std::string> const& files,
+                        std::vector<std::string>& hashes,
+                        unsigned int threads = 0);
 protected:
   virtual void Initialize()=0;
   virtual void Append(unsigned char const*, int)=0;
@@ -23,6 +23,7 @@ cmCustomCommand::cmCustomCommand()
   this->EscapeOldStyle = true;
   this->EscapeAllowMakeVars = false;
   this->UsesTerminal = false;
+  this->JobserverAware = false;
 }
 
 //----------------------------------------------------------------------------
@@ -42,7 +43,8 @@ cmCustomCommand::cmCustomCommand(cmMakefile const* mf,
   WorkingDirectory(workingDirectory?workingDirectory:""),
   HaveComment(comment?true:false),
   EscapeAllowMakeVars(false),
-  EscapeOldStyle(true)
+  EscapeOldStyle(true),
+  JobserverAware(false)
 {
   if(mf)
     {
@@ -155,3 +157,15 @@ void cmCustomCommand::SetUsesTerminal(bool b)
 {
   this->UsesTerminal = b;
 }
+
+//----------------------------------------------------------------------------
+bool cmCustomCommand::GetJobserverAware() const
+{
+  return this->JobserverAware;
+}
+
+//----------------------------------------------------------------------------
+void cmCustomCommand::SetJobserverAware(bool b)
+{
+  this->JobserverAware = b;
+}
@@ -84,6 +84,11 @@ public:
   bool GetUsesTerminal() const;
   void SetUsesTerminal(bool b);
 
+  /** Set/Get whether this custom command should be given access to the
+      jobserver of the parent build tool (if possible).  */
+  bool GetJobserverAware() const;
+  void SetJobserverAware(bool b);
+
 private:
   std::vector<std::string> Outputs;
   std::vector<std::string> Byproducts;
@@ -97,6 +102,7 @@ private:
   bool EscapeAllowMakeVars;
   bool EscapeOldStyle;
   bool UsesTerminal;
+  bool JobserverAware;
 };
 
 #endif
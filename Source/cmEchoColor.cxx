@@ -0,0 +1,209 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmEchoColor.h"
+
+#include <cmsys/Directory.hxx>
+#include <cmsys/SystemTools.hxx>
+#include <cmsys/Terminal.h>
+
+//----------------------------------------------------------------------------
+static bool cmEchoColorIsOn(std::string const& value)
+{
+  // Same values as cmSystemTools::IsOn, which is not available here.
+  std::string v = cmsys::SystemTools::UpperCase(value);
+  return v == "ON" || v == "1" || v == "YES" || v == "TRUE" || v == "Y";
+}
+
+//----------------------------------------------------------------------------
+void cmEchoColor::ReportProgress(std::string const& dir,
+                                 std::string const& num)
+{
+  std::string dirName = dir;
+  dirName += "/Progress";
+  std::string fName;
+  FILE *progFile;
+
+  // read the count
+  fName = dirName;
+  fName += "/count.txt";
+  progFile = cmsys::SystemTools::Fopen(fName,"r");
+  int count = 0;
+  if (!progFile)
+    {
+    return;
+    }
+  else
+    {
+    if (1!=fscanf(progFile,"%i",&count))
+      {
+      fprintf(stderr, "Could not read from progress file.\n");
+      }
+    fclose(progFile);
+    }
+  const char* last = num.c_str();
+  for(const char* c = last;; ++c)
+    {
+    if (*c == ',' || *c == '\0')
+      {
+      if (c != last)
+        {
+        fName = dirName;
+        fName += "/";
+        fName.append(last, c-last);
+        progFile = cmsys::SystemTools::Fopen(fName,"w");
+        if (progFile)
+          {
+          fprintf(progFile,"empty");
+          fclose(progFile);
+          }
+        }
+      if(*c == '\0')
+        {
+        break;
+        }
+      last = c + 1;
+      }
+    }
+  int fileNum = static_cast<int>
+    (cmsys::Directory::GetNumberOfFilesInDirectory(dirName));
+  if (count > 0)
+    {
+    // print the progress
+    fprintf(stdout,"[%3i%%] ",((fileNum-3)*100)/count);
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmEchoColor::Echo(int color, const char* message,
+                       bool newline, bool enabled)
+{
+  // On some platforms (an MSYS prompt) cmsysTerminal may not be able
+  // to determine whether the stream is displayed on a tty.  In this
+  // case it assumes no unless we tell it otherwise.  Since we want
+  // color messages to be displayed for users we will assume yes.
+  // However, we can test for some situations when the answer is most
+  // likely no.
+  int assumeTTY = cmsysTerminal_Color_AssumeTTY;
+  if(cmsys::SystemTools::GetEnv("DART_TEST_FROM_DART") ||
+     cmsys::SystemTools::GetEnv("DASHBOARD_TEST_FROM_CTEST") ||
+     cmsys::SystemTools::GetEnv("CTEST_INTERACTIVE_DEBUG_MODE"))
+    {
+    // Avoid printing color escapes during dashboard builds.
+    assumeTTY = 0;
+    }
+
+  if(enabled && color != cmsysTerminal_Color_Normal)
+    {
+    // Print with color.  Delay the newline until later so that
+    // all color restore sequences appear before it.
+    cmsysTerminal_cfprintf(color | assumeTTY, stdout, "%s", message);
+    }
+  else
+    {
+    // Color is disabled.  Print without color.
+    fprintf(stdout, "%s", message);
+    }
+
+  if(newline)
+    {
+    fprintf(stdout, "\n");
+    }
+}
+
+//----------------------------------------------------------------------------
+int cmEchoColor::Execute(std::vector<std::string> const& args)
+{
+  bool enabled = true;
+  int color = cmsysTerminal_Color_Normal;
+  bool newline = true;
+  std::string progressDir;
+  for(std::vector<std::string>::const_iterator a = args.begin();
+      a != args.end(); ++a)
+    {
+    std::string const& arg = *a;
+    if(arg.find("--switch=") == 0)
+      {
+      // Enable or disable color based on the switch value.
+      std::string value = arg.substr(9);
+      if(!value.empty())
+        {
+        enabled = cmEchoColorIsOn(value);
+        }
+      }
+    else if(arg.find("--progress-dir=") == 0)
+      {
+      progressDir = arg.substr(15);
+      }
+    else if(arg.find("--progress-num=") == 0)
+      {
+      if (!progressDir.empty())
+        {
+        cmEchoColor::ReportProgress(progressDir, arg.substr(15));
+        }
+      }
+    else if(arg == "--normal")
+      {
+      color = cmsysTerminal_Color_Normal;
+      }
+    else if(arg == "--black")
+      {
+      color = cmsysTerminal_Color_ForegroundBlack;
+      }
+    else if(arg == "--red")
+      {
+      color = cmsysTerminal_Color_ForegroundRed;
+      }
+    else if(arg == "--green")
+      {
+      color = cmsysTerminal_Color_ForegroundGreen;
+      }
+    else if(arg == "--yellow")
+      {
+      color = cmsysTerminal_Color_ForegroundYellow;
+      }
+    else if(arg == "--blue")
+      {
+      color = cmsysTerminal_Color_ForegroundBlue;
+      }
+    else if(arg == "--magenta")
+      {
+      color = cmsysTerminal_Color_ForegroundMagenta;
+      }
+    else if(arg == "--cyan")
+      {
+      color = cmsysTerminal_Color_ForegroundCyan;
+      }
+    else if(arg == "--white")
+      {
+      color = cmsysTerminal_Color_ForegroundWhite;
+      }
+    else if(arg == "--bold")
+      {
+      color |= cmsysTerminal_Color_ForegroundBold;
+      }
+    else if(arg == "--no-newline")
+      {
+      newline = false;
+      }
+    else if(arg == "--newline")
+      {
+      newline = true;
+      }
+    else
+      {
+      // Color is enabled.  Print with the current color.
+      cmEchoColor::Echo(color, arg.c_str(), newline, enabled);
+      }
+    }
+
+  return 0;
+}
@@ -0,0 +1,46 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmEchoColor_h
+#define cmEchoColor_h
+
+#include "cmStandardIncludes.h"
+
+/** \class cmEchoColor
+ * \brief Print build rule messages for the Makefile generators.
+ *
+ * This implements "cmake -E cmake_echo_color".  It depends only on
+ * KWSys so that the small cmecho helper, which generated Makefiles run
+ * instead of cmake for every rule message, can share it.
+ */
+class cmEchoColor
+{
+public:
+  /**
+   * Run with the arguments following "cmake_echo_color": options
+   * --switch=, --progress-dir=, --progress-num=, color names,
+   * --bold, --[no-]newline, and the text to print.
+   */
+  static int Execute(std::vector<std::string> const& args);
+
+  /** Print a message with the given cmsysTerminal color.  */
+  static void Echo(int color, const char* message,
+                   bool newline, bool enabled);
+
+  /**
+   * Mark the comma-separated progress steps as done in the given
+   * directory and print the percentage of steps completed.
+   */
+  static void ReportProgress(std::string const& dir,
+                             std::string const& num);
+};
+
+#endif
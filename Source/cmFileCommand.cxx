@@ -16,6 +16,7 @@
 #include "cmInstallType.h"
 #include "cmFileTimeComparison.h"
 #include "cmGlobalGenerator.h"
+#include "cmInstallHashManifest.h"
 #include "cmCryptoHash.h"
 #include "cmAlgorithms.h"
 
@@ -24,6 +25,7 @@
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 #include "cmCurl.h"
 #include "cmFileLockResult.h"
+#include "cmWorkerPool.h"
 #endif
 
 #undef GetCurrentDirectory
@@ -116,6 +118,10 @@ bool cmFileCommand
     {
     return this->HandleDownloadCommand(args);
     }
+  else if ( subCommand == "DOWNLOAD_BATCH" )
+    {
+    return this->HandleDownloadBatchCommand(args);
+    }
   else if ( subCommand == "UPLOAD" )
     {
     return this->HandleUploadCommand(args);
@@ -244,6 +250,18 @@ bool cmFileCommand::HandleWriteCommand(std::vector<std::string> const& args,
   std::string dir = cmSystemTools::GetFilenamePath(fileName);
   cmSystemTools::MakeDirectory(dir.c_str());
 
+  // An install script staging with hard links must not write through
+  // a link into the tree the file was installed from.
+  std::string staging =
+    this->Makefile->GetSafeDefinition("CMAKE_INSTALL_STAGING_MODE");
+  if ( staging == "LINK" && !cmSystemTools::BreakHardLink(fileName) )
+    {
+    std::string error = "failed to unshare hard-linked file:\n  ";
+    error += fileName;
+    this->SetError(error);
+    return false;
+    }
+
   mode_t mode = 0;
 
   // Set permissions to writable
@@ -348,20 +366,43 @@ bool cmFileCommand::HandleReadCommand(std::vector<std::string> const& args)
 
   file.seekg(offset, std::ios::beg); // explicit ios::beg for IBM VisualAge 6
 
+  // Size the result once instead of growing it while reading.
   std::string output;
+  long length = static_cast<long>(cmSystemTools::FileLength(fileName))
+    - offset;
+  if (sizeLimit >= 0 && sizeLimit < length)
+    {
+    length = sizeLimit;
+    }
+  if (length > 0)
+    {
+    output.reserve(static_cast<std::string::size_type>(length) *
+                   (hexOutputArg.IsEnabled()? 2 : 1));
+    }
 
   if (hexOutputArg.IsEnabled())
     {
     // Convert part of the file into hex code
-    char c;
-    while((sizeLimit != 0) && (file.get(c)))
+    static const char hexDigits[] = "0123456789abcdef";
+    char buffer[16384];
+    while (sizeLimit != 0 && file)
       {
-      char hex[4];
-      sprintf(hex, "%.2x", c&0xff);
-      output += hex;
+      std::streamsize n = sizeof(buffer);
+      if (sizeLimit > 0 && sizeLimit < n)
+        {
+        n = sizeLimit;
+        }
+      file.read(buffer, n);
+      std::streamsize got = file.gcount();
+      for (std::streamsize j = 0; j < got; ++j)
+        {
+        unsigned char c = static_cast<unsigned char>(buffer[j]);
+        output += hexDigits[c >> 4];
+        output += hexDigits[c & 0xf];
+        }
       if (sizeLimit > 0)
         {
-        sizeLimit--;
+        sizeLimit -= static_cast<long>(got);
         }
       }
     }
@@ -400,6 +441,10 @@ bool cmFileCommand::HandleReadCommand(std::vector<std::string> const& args)
 bool cmFileCommand::HandleHashCommand(std::vector<std::string> const& args)
 {
 #if defined(CMAKE_BUILD_WITH_CMAKE)
+  if(args.size() >= 3 && args[2] == "FILES")
+    {
+    return this->HandleHashFilesCommand(args);
+    }
   if(args.size() != 3)
     {
     std::ostringstream e;
@@ -431,6 +476,149 @@ bool cmFileCommand::HandleHashCommand(std::vector<std::string> const& args)
 #endif
 }
 
+//----------------------------------------------------------------------------
+bool
+cmFileCommand::HandleHashFilesCommand(std::vector<std::string> const& args)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // file(<HASH> <variable> FILES <file>...)
+  std::vector<std::string> files(args.begin() + 3, args.end());
+
+  std::vector<std::string> hashes;
+  if(!cmCryptoHash::HashFiles(args[0].c_str(), files, hashes))
+    {
+    return false;
+    }
+  for(std::vector<std::string>::size_type i = 0; i < hashes.size(); ++i)
+    {
+    if(hashes[i].empty())
+      {
+      std::ostringstream e;
+      e << args[0] << " failed to read file \"" << files[i] << "\"";
+      this->SetError(e.str());
+      return false;
+      }
+    }
+  this->Makefile->AddDefinition(args[1], cmJoin(hashes, ";").c_str());
+  return true;
+#else
+  (void)args;
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+namespace {
+// Block-buffered input for the byte-wise scanner of file(STRINGS).
+// It offers the few istream operations the scanner needs without a
+// stream call per byte, and tracks the position for LIMIT_INPUT.
+class cmFileStringsInput
+{
+public:
+  cmFileStringsInput(std::istream& is, long position):
+    Stream(is), Begin(0), End(0), Position(position), Failed(false)
+    {
+    this->Buffer.resize(65536);
+    }
+
+  bool Good() const { return !this->Failed; }
+  long Tell() const { return this->Position; }
+
+  int Get()
+    {
+    if(this->Begin == this->End && !this->Fill())
+      {
+      this->Failed = true;
+      return EOF;
+      }
+    ++this->Position;
+    return static_cast<unsigned char>(this->Buffer[this->Begin++]);
+    }
+
+  void PutBack(char c)
+    {
+    if(this->Failed)
+      {
+      return;
+      }
+    if(this->Begin > 0)
+      {
+      this->Buffer[--this->Begin] = c;
+      }
+    else
+      {
+      this->Buffer.insert(this->Buffer.begin(), c);
+      ++this->End;
+      }
+    --this->Position;
+    }
+
+  // Append the run of printable ASCII characters at the current
+  // position to the string, stopping after at most 'max' characters
+  // or at the given input position limit.
+  void AppendPrintable(std::string& s, std::string::size_type max,
+                       long limit, bool newline)
+    {
+    while(max > 0 && (limit < 0 || this->Position < limit) &&
+          (this->Begin < this->End || this->Fill()))
+      {
+      std::string::size_type n = this->End - this->Begin;
+      if(n > max)
+        {
+        n = max;
+        }
+      if(limit >= 0 && static_cast<long>(n) > limit - this->Position)
+        {
+        n = static_cast<std::string::size_type>(limit - this->Position);
+        }
+      const char* first = &this->Buffer[this->Begin];
+      const char* last = first;
+      const char* end = first + n;
+      for(; last != end; ++last)
+        {
+        unsigned char c = static_cast<unsigned char>(*last);
+        if(!((c >= 0x20 && c < 0x7F) || c == '\t' ||
+             (c == '\n' && newline)))
+          {
+          break;
+          }
+        }
+      std::string::size_type k = last - first;
+      s.append(first, k);
+      this->Begin += k;
+      this->Position += static_cast<long>(k);
+      max -= k;
+      if(k < n)
+        {
+        break;
+        }
+      }
+    }
+
+private:
+  bool Fill()
+    {
+    if(!this->Stream)
+      {
+      return false;
+      }
+    this->Stream.read(&this->Buffer[0],
+                      static_cast<std::streamsize>(this->Buffer.size()));
+    this->Begin = 0;
+    this->End = static_cast<std::vector<char>::size_type>(
+      this->Stream.gcount());
+    return this->End > 0;
+    }
+
+  std::istream& Stream;
+  std::vector<char> Buffer;
+  std::vector<char>::size_type Begin;
+  std::vector<char>::size_type End;
+  long Position;
+  bool Failed;
+};
+}
+
 //----------------------------------------------------------------------------
 bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
 {
@@ -685,22 +873,37 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
     }
 
   // Parse strings out of the file.
+  std::streamoff start = fin.tellg();
+  cmFileStringsInput in(fin, start > 0 ? static_cast<long>(start) : 0);
   int output_size = 0;
   std::vector<std::string> strings;
   std::string s;
   while((!limit_count || strings.size() < limit_count) &&
-        (limit_input < 0 || static_cast<int>(fin.tellg()) < limit_input) &&
-        fin)
+        (limit_input < 0 || in.Tell() < limit_input) &&
+        in.Good())
     {
     std::string current_str;
 
-    int c = fin.get();
+    // Take a whole run of single-byte printable characters at once.
+    // Leave room for the character that reaches the maximum length so
+    // the string is terminated below.
+    if(bytes_rem == 0 && (maxlen == 0 || s.size() + 1 < maxlen))
+      {
+      in.AppendPrintable(s, maxlen > 0? maxlen - 1 - s.size() :
+                         std::string::npos, limit_input, newline_consume);
+      if(limit_input >= 0 && in.Tell() >= limit_input)
+        {
+        break;
+        }
+      }
+
+    int c = in.Get();
     for(unsigned int i=0; i<bytes_rem; ++i)
       {
-      int c1 = fin.get();
-      if(!fin)
+      int c1 = in.Get();
+      if(!in.Good())
         {
-        fin.putback(static_cast<char>(c1));
+        in.PutBack(static_cast<char>(c1));
         break;
         }
       c = (c << 8) | c1;
@@ -752,10 +955,10 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
         {
         if(j != 0)
           {
-          c = fin.get();
-          if(!fin || (c & 0xC0) != 0x80)
+          c = in.Get();
+          if(!in.Good() || (c & 0xC0) != 0x80)
             {
-            fin.putback(static_cast<char>(c));
+            in.PutBack(static_cast<char>(c));
             break;
             }
           }
@@ -769,7 +972,7 @@ bool cmFileCommand::HandleStringsCommand(std::vector<std::string> const& args)
         for(unsigned int j=0; j<current_str.size()-1; j++)
           {
           c = current_str[current_str.size() - 1 - j];
-          fin.putback(static_cast<char>(c));
+          in.PutBack(static_cast<char>(c));
           }
         current_str = "";
         }
@@ -1183,10 +1386,15 @@ struct cmFileCopier
     UseGivenPermissionsFile(false),
     UseGivenPermissionsDir(false),
     UseSourcePermissions(true),
-    Doing(DoingNone)
+    Doing(DoingNone),
+    Staging(StagingCopy),
+    ParallelLevel(1)
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    , Pool(0)
+#endif
     {
     }
-  virtual ~cmFileCopier() {}
+  virtual ~cmFileCopier();
 
   bool Run(std::vector<std::string> const& args);
 protected:
@@ -1293,6 +1501,8 @@ protected:
   bool InstallSymlink(const char* fromFile, const char* toFile);
   bool InstallFile(const char* fromFile, const char* toFile,
                    MatchProperties const& match_properties);
+  bool StageFile(const char* fromFile, const char* toFile,
+                 mode_t permissions, bool& linked);
   bool InstallDirectory(const char* source, const char* destination,
                         MatchProperties const& match_properties);
   virtual bool Install(const char* fromFile, const char* toFile);
@@ -1305,6 +1515,7 @@ protected:
     TypeDir,
     TypeLink
   };
+  virtual bool NeedCopy(const char* fromFile, const char* toFile);
   virtual void ReportCopy(const char*, Type, bool) {}
   virtual bool ReportMissing(const char* fromFile)
     {
@@ -1340,6 +1551,30 @@ protected:
   virtual bool CheckKeyword(std::string const& arg);
   virtual bool CheckValue(std::string const& arg);
 
+  // How the data of installed files may be shared with the source.
+  enum StagingMode
+  {
+    StagingCopy,    // always write a new copy
+    StagingReflink, // copy-on-write clone if possible, else copy
+    StagingLink     // clone, else hard link, else copy
+  };
+  StagingMode Staging;
+
+  // Number of threads used to copy file contents.  File copies are
+  // queued while messages and manifest entries are produced in order.
+  unsigned int ParallelLevel;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  struct CopyJob;
+  cmWorkerPool* Pool;
+  std::vector<CopyJob*> Copies;
+#endif
+  bool QueueCopy(const char* fromFile, const char* toFile,
+                 mode_t permissions, bool setTime);
+  bool FinishCopies(bool report);
+  bool TransferFile(const char* fromFile, const char* toFile,
+                    mode_t permissions, bool copy, bool setTime,
+                    std::string& error);
+
   void NotBeforeMatch(std::string const& arg)
     {
     std::ostringstream e;
@@ -1377,6 +1612,16 @@ protected:
     }
 };
 
+//----------------------------------------------------------------------------
+cmFileCopier::~cmFileCopier()
+{
+  // Never leave a worker thread writing after the command is done.
+  this->FinishCopies(false);
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  delete this->Pool;
+#endif
+}
+
 //----------------------------------------------------------------------------
 bool cmFileCopier::Parse(std::vector<std::string> const& args)
 {
@@ -1668,10 +1913,11 @@ bool cmFileCopier::Run(std::vector<std::string> const& args)
 
     if(!this->Install(fromFile.c_str(), toFile.c_str()))
       {
+      this->FinishCopies(false);
       return false;
       }
     }
-  return true;
+  return this->FinishCopies(true);
 }
 
 //----------------------------------------------------------------------------
@@ -1764,36 +2010,74 @@ bool cmFileCopier::InstallSymlink(const char* fromFile, const char* toFile)
   return true;
 }
 
+//----------------------------------------------------------------------------
+bool cmFileCopier::NeedCopy(const char* fromFile, const char* toFile)
+{
+  // If both files exist with the same time do not copy.
+  return this->Always || this->FileTimes.FileTimesDiffer(fromFile, toFile);
+}
+
 //----------------------------------------------------------------------------
 bool cmFileCopier::InstallFile(const char* fromFile, const char* toFile,
                                MatchProperties const& match_properties)
 {
   // Determine whether we will copy the file.
-  bool copy = true;
-  if(!this->Always)
-    {
-    // If both files exist with the same time do not copy.
-    if(!this->FileTimes.FileTimesDiffer(fromFile, toFile))
-      {
-      copy = false;
-      }
-    }
+  bool copy = this->NeedCopy(fromFile, toFile);
 
   // Inform the user about this file installation.
   this->ReportCopy(toFile, TypeFile, copy);
 
+  // Compute the permissions of the destination file.
+  mode_t permissions = (match_properties.Permissions?
+                        match_properties.Permissions : this->FilePermissions);
+  if(!permissions)
+    {
+    // No permissions were explicitly provided but the user requested
+    // that the source file permissions be used.
+    cmSystemTools::GetPermissions(fromFile, permissions);
+    }
+
+  // Let the worker threads copy the file if parallel installation
+  // was requested.
+  if(copy && this->QueueCopy(fromFile, toFile, permissions, !this->Always))
+    {
+    return true;
+    }
+
+  std::string error;
+  if(!this->TransferFile(fromFile, toFile, permissions,
+                         copy, copy && !this->Always, error))
+    {
+    this->FileCommand->SetError(error);
+    return false;
+    }
+  return true;
+}
+
+//----------------------------------------------------------------------------
+bool cmFileCopier::TransferFile(const char* fromFile, const char* toFile,
+                                mode_t permissions, bool copy, bool setTime,
+                                std::string& error)
+{
   // Copy the file.
-  if(copy && !cmSystemTools::CopyAFile(fromFile, toFile, true))
+  bool linked = false;
+  if(copy && !this->StageFile(fromFile, toFile, permissions, linked))
     {
     std::ostringstream e;
     e << this->Name << " cannot copy file \"" << fromFile
       << "\" to \"" << toFile << "\".";
-    this->FileCommand->SetError(e.str());
+    error = e.str();
     return false;
     }
 
+  // A hard link already shares the time and permissions of the source.
+  if(linked)
+    {
+    return true;
+    }
+
   // Set the file modification time of the destination file.
-  if(copy && !this->Always)
+  if(setTime)
     {
     // Add write permission so we can set the file time.
     // Permissions are set unconditionally below anyway.
@@ -1807,21 +2091,139 @@ bool cmFileCopier::InstallFile(const char* fromFile, const char* toFile,
       std::ostringstream e;
       e << this->Name << " cannot set modification time on \""
         << toFile << "\"";
-      this->FileCommand->SetError(e.str());
+      error = e.str();
       return false;
       }
     }
 
   // Set permissions of the destination file.
-  mode_t permissions = (match_properties.Permissions?
-                        match_properties.Permissions : this->FilePermissions);
-  if(!permissions)
+  if(permissions && !cmSystemTools::SetPermissions(toFile, permissions))
     {
-    // No permissions were explicitly provided but the user requested
-    // that the source file permissions be used.
-    cmSystemTools::GetPermissions(fromFile, permissions);
+    std::ostringstream e;
+    e << this->Name << " cannot set permissions on \"" << toFile << "\"";
+    error = e.str();
+    return false;
+    }
+  return true;
+}
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+//----------------------------------------------------------------------------
+struct cmFileCopier::CopyJob: public cmWorkerPool::Job
+{
+  CopyJob(cmFileCopier* copier, const char* fromFile, const char* toFile,
+          mode_t permissions, bool setTime):
+    Copier(copier), FromFile(fromFile), ToFile(toFile),
+    Permissions(permissions), SetTime(setTime), Success(false) {}
+
+  virtual void Run()
+    {
+    this->Success = this->Copier->TransferFile(this->FromFile.c_str(),
+                                               this->ToFile.c_str(),
+                                               this->Permissions, true,
+                                               this->SetTime, this->Error);
+    }
+
+  cmFileCopier* Copier;
+  std::string FromFile;
+  std::string ToFile;
+  mode_t Permissions;
+  bool SetTime;
+  bool Success;
+  std::string Error;
+};
+#endif
+
+//----------------------------------------------------------------------------
+bool cmFileCopier::QueueCopy(const char* fromFile, const char* toFile,
+                             mode_t permissions, bool setTime)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if(this->ParallelLevel > 1)
+    {
+    if(!this->Pool)
+      {
+      this->Pool = new cmWorkerPool(
+        cmWorkerPool::NormalizeThreadCount(
+          static_cast<int>(this->ParallelLevel)));
+      }
+    CopyJob* job = new CopyJob(this, fromFile, toFile, permissions, setTime);
+    this->Copies.push_back(job);
+    this->Pool->Submit(job);
+    return true;
+    }
+#else
+  (void)fromFile;
+  (void)toFile;
+  (void)permissions;
+  (void)setTime;
+#endif
+  return false;
+}
+
+//----------------------------------------------------------------------------
+bool cmFileCopier::FinishCopies(bool report)
+{
+  bool okay = true;
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if(this->Pool)
+    {
+    this->Pool->WaitAll();
+    }
+  // Report the first failure in the order the files were listed.
+  for(std::vector<CopyJob*>::iterator i = this->Copies.begin();
+      i != this->Copies.end(); ++i)
+    {
+    if(okay && !(*i)->Success)
+      {
+      if(report)
+        {
+        this->FileCommand->SetError((*i)->Error);
+        }
+      okay = false;
+      }
+    delete *i;
+    }
+  this->Copies.clear();
+#else
+  (void)report;
+#endif
+  return okay;
+}
+
+//----------------------------------------------------------------------------
+bool cmFileCopier::StageFile(const char* fromFile, const char* toFile,
+                             mode_t permissions, bool& linked)
+{
+  linked = false;
+  if(this->Staging == StagingCopy)
+    {
+    return cmSystemTools::CopyAFile(fromFile, toFile, true);
+    }
+
+  // Never write through an existing destination; it may be a link.
+  cmSystemTools::RemoveFile(toFile);
+  if(cmSystemTools::CloneFile(fromFile, toFile))
+    {
+    return true;
+    }
+
+  // A hard link shares the inode, so only use it when nothing will be
+  // changed on the destination that would show up in the source.
+  // file(WRITE), file(APPEND) and file(RPATH_*) unshare the file before
+  // editing it, but other tools run by the install script do not.
+  if(this->Staging == StagingLink)
+    {
+    mode_t sourcePermissions = 0;
+    if(cmSystemTools::GetPermissions(fromFile, sourcePermissions) &&
+       (sourcePermissions & 07777) == (permissions & 07777) &&
+       cmSystemTools::CreateHardLink(fromFile, toFile))
+      {
+      linked = true;
+      return true;
+      }
     }
-  return this->SetPermissions(toFile, permissions);
+  return cmSystemTools::CopyAFile(fromFile, toFile, true);
 }
 
 //----------------------------------------------------------------------------
@@ -1904,6 +2306,13 @@ bool cmFileCopier::InstallDirectory(const char* source,
       }
     }
 
+  // Finish writing the contents before the directory may become
+  // read-only.
+  if(permissions_after && !this->FinishCopies(true))
+    {
+    return false;
+    }
+
   // Set the requested permissions of the destination directory.
   return this->SetPermissions(destination, permissions_after);
 }
@@ -1925,13 +2334,41 @@ struct cmFileInstaller: public cmFileCopier
     MessageAlways(false),
     MessageLazy(false),
     MessageNever(false),
-    DestDirLength(0)
+    DestDirLength(0),
+    HashManifest(0)
     {
     // Installation does not use source permissions by default.
     this->UseSourcePermissions = false;
     // Check whether to copy files always or only if they have changed.
     this->Always =
       cmSystemTools::IsOn(cmSystemTools::GetEnv("CMAKE_INSTALL_ALWAYS"));
+    // Check whether the destination may share data with the source.
+    std::string staging =
+      this->Makefile->GetSafeDefinition("CMAKE_INSTALL_STAGING_MODE");
+    if(staging == "LINK")
+      {
+      this->Staging = StagingLink;
+      }
+    else if(staging == "REFLINK")
+      {
+      this->Staging = StagingReflink;
+      }
+    // Check whether to copy file contents on several threads.
+    const char* parallel =
+      this->Makefile->GetDefinition("CMAKE_INSTALL_PARALLEL_LEVEL");
+    if(!parallel)
+      {
+      parallel = cmSystemTools::GetEnv("CMAKE_INSTALL_PARALLEL_LEVEL");
+      }
+    unsigned long level = 0;
+    if(parallel && cmSystemTools::StringToULong(parallel, &level) &&
+       level > 1)
+      {
+      this->ParallelLevel = static_cast<unsigned int>(level);
+      }
+    // Check whether to compare file content with the last installation.
+    this->HashManifestFile =
+      this->Makefile->GetSafeDefinition("CMAKE_INSTALL_HASH_MANIFEST_FILE");
     // Get the current manifest.
     this->Manifest =
       this->Makefile->GetSafeDefinition("CMAKE_INSTALL_MANIFEST_FILES");
@@ -1943,6 +2380,8 @@ struct cmFileInstaller: public cmFileCopier
                                   this->Manifest.c_str());
     }
 
+  void SaveHashes();
+
 protected:
   cmInstallType InstallType;
   bool Optional;
@@ -1962,6 +2401,14 @@ protected:
     this->Manifest += file.substr(this->DestDirLength);
     }
 
+  // Content hashes of the sources of files installed before, by
+  // destination, and those of files installed by this call.
+  std::string HashManifestFile;
+  cmInstallHashManifest* HashManifest;
+  std::vector<std::pair<std::string, std::string> > NewHashes;
+  std::vector<std::string> Unchanged;
+  virtual bool NeedCopy(const char* fromFile, const char* toFile);
+
   virtual std::string const& ToName(std::string const& fromName)
     { return this->Rename.empty()? fromName : this->Rename; }
 
@@ -2028,6 +2475,75 @@ protected:
   bool HandleInstallDestination();
 };
 
+//----------------------------------------------------------------------------
+bool cmFileInstaller::NeedCopy(const char* fromFile, const char* toFile)
+{
+  bool copy = this->cmFileCopier::NeedCopy(fromFile, toFile);
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if(this->HashManifestFile.empty() || this->Always)
+    {
+    return copy;
+    }
+  if(!this->HashManifest)
+    {
+    this->HashManifest = &this->Makefile->GetGlobalGenerator()
+      ->GetInstallHashManifest(this->HashManifestFile);
+    }
+
+  // A file with the same time as its source was hashed when installed.
+  std::string const* h = this->HashManifest->Find(toFile);
+  if(!copy && h)
+    {
+    return false;
+    }
+
+  cmsys::auto_ptr<cmCryptoHash> hasher(cmCryptoHash::New("SHA256"));
+  std::string hash = hasher->HashFile(fromFile);
+  if(hash.empty())
+    {
+    return copy;
+    }
+  if(h && *h == hash)
+    {
+    // The source still has the content installed last time.  Leave the
+    // destination and its time alone.
+    if(copy && cmSystemTools::FileExists(toFile, true))
+      {
+      this->Unchanged.push_back(toFile);
+      copy = false;
+      }
+    return copy;
+    }
+  this->NewHashes.push_back(std::make_pair(std::string(toFile), hash));
+#endif
+  return copy;
+}
+
+//----------------------------------------------------------------------------
+void cmFileInstaller::SaveHashes()
+{
+  // Tell the install script which destinations were left untouched so
+  // it does not edit them again.
+  if(!this->Unchanged.empty())
+    {
+    this->Makefile->AddDefinition("CMAKE_INSTALL_UNCHANGED_FILES",
+      cmJoin(this->Unchanged, ";").c_str());
+    }
+  else
+    {
+    this->Makefile->RemoveDefinition("CMAKE_INSTALL_UNCHANGED_FILES");
+    }
+
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // The manifest is written once when the script is done.
+  for(std::vector<std::pair<std::string, std::string> >::const_iterator
+        i = this->NewHashes.begin(); i != this->NewHashes.end(); ++i)
+    {
+    this->HashManifest->Add(i->first, i->second);
+    }
+#endif
+}
+
 //----------------------------------------------------------------------------
 bool cmFileInstaller::Parse(std::vector<std::string> const& args)
 {
@@ -2357,14 +2873,52 @@ bool cmFileInstaller::HandleInstallDestination()
 }
 
 //----------------------------------------------------------------------------
-bool
+// Change the RPATH of one file, keeping its modification time.  This
+// may run on a worker thread, so it only records its result.
+class cmFileRPathChange
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  : public cmWorkerPool::Job
+#endif
+{
+public:
+  cmFileRPathChange(std::string const& file, std::string const& oldRPath,
+                    std::string const& newRPath, bool unshare):
+    File(file), OldRPath(oldRPath), NewRPath(newRPath),
+    Unshare(unshare), Success(false), Changed(false) {}
+
+  virtual void Run()
+    {
+    cmSystemToolsFileTime* ft = cmSystemTools::FileTimeNew();
+    bool have_ft = cmSystemTools::FileTimeGet(this->File.c_str(), ft);
+    this->Success = cmSystemTools::ChangeRPath(this->File, this->OldRPath,
+                                               this->NewRPath, &this->Error,
+                                               &this->Changed,
+                                               this->Unshare);
+    if(this->Success && have_ft)
+      {
+      cmSystemTools::FileTimeSet(this->File.c_str(), ft);
+      }
+    cmSystemTools::FileTimeDelete(ft);
+    }
+
+  std::string File;
+  std::string const& OldRPath;
+  std::string const& NewRPath;
+  bool Unshare;
+  std::string Error;
+  bool Success;
+  bool Changed;
+};
+
+//----------------------------------------------------------------------------
+bool
 cmFileCommand::HandleRPathChangeCommand(std::vector<std::string> const& args)
 {
   // Evaluate arguments.
-  const char* file = 0;
+  std::vector<std::string> files;
   const char* oldRPath = 0;
   const char* newRPath = 0;
-  enum Doing { DoingNone, DoingFile, DoingOld, DoingNew };
+  enum Doing { DoingNone, DoingFile, DoingFiles, DoingOld, DoingNew };
   Doing doing = DoingNone;
   for(unsigned int i=1; i < args.size(); ++i)
     {
@@ -2380,11 +2934,19 @@ cmFileCommand::HandleRPathChangeCommand(std::vector<std::string> const& args)
       {
       doing = DoingFile;
       }
+    else if(args[i] == "FILES")
+      {
+      doing = DoingFiles;
+      }
     else if(doing == DoingFile)
       {
-      file = args[i].c_str();
+      files.push_back(args[i]);
       doing = DoingNone;
       }
+    else if(doing == DoingFiles)
+      {
+      files.push_back(args[i]);
+      }
     else if(doing == DoingOld)
       {
       oldRPath = args[i].c_str();
@@ -2403,7 +2965,7 @@ cmFileCommand::HandleRPathChangeCommand(std::vector<std::string> const& args)
       return false;
       }
     }
-  if(!file)
+  if(files.empty())
     {
     this->SetError("RPATH_CHANGE not given FILE option.");
     return false;
@@ -2418,46 +2980,92 @@ cmFileCommand::HandleRPathChangeCommand(std::vector<std::string> const& args)
     this->SetError("RPATH_CHANGE not given NEW_RPATH option.");
     return false;
     }
-  if(!cmSystemTools::FileExists(file, true))
+  for(std::vector<std::string>::const_iterator fi = files.begin();
+      fi != files.end(); ++fi)
     {
-    std::ostringstream e;
-    e << "RPATH_CHANGE given FILE \"" << file << "\" that does not exist.";
-    this->SetError(e.str());
-    return false;
+    if(!cmSystemTools::FileExists(fi->c_str(), true))
+      {
+      std::ostringstream e;
+      e << "RPATH_CHANGE given FILE \"" << *fi << "\" that does not exist.";
+      this->SetError(e.str());
+      return false;
+      }
     }
-  bool success = true;
-  cmSystemToolsFileTime* ft = cmSystemTools::FileTimeNew();
-  bool have_ft = cmSystemTools::FileTimeGet(file, ft);
-  std::string emsg;
-  bool changed;
-  if(!cmSystemTools::ChangeRPath(file, oldRPath, newRPath, &emsg, &changed))
+
+  // An install script staging with hard links must not write through
+  // a link into the tree the file was installed from.
+  bool unshare = this->Makefile->GetSafeDefinition(
+    "CMAKE_INSTALL_STAGING_MODE") == std::string("LINK");
+
+  std::string const oldRPathStr = oldRPath;
+  std::string const newRPathStr = newRPath;
+  std::vector<cmFileRPathChange*> changes;
+  for(std::vector<std::string>::const_iterator fi = files.begin();
+      fi != files.end(); ++fi)
     {
-    std::ostringstream e;
-    e << "RPATH_CHANGE could not write new RPATH:\n"
-      << "  " << newRPath << "\n"
-      << "to the file:\n"
-      << "  " << file << "\n"
-      << emsg;
-    this->SetError(e.str());
-    success = false;
+    changes.push_back(new cmFileRPathChange(*fi, oldRPathStr, newRPathStr,
+                                            unshare));
     }
-  if(success)
+
+  // Each file is parsed and patched independently, so several of them
+  // may be processed at once.  Results are reported in the given order.
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  if(changes.size() > 1)
     {
-    if(changed)
+    unsigned int threads = cmWorkerPool::NormalizeThreadCount(0);
+    if(threads > changes.size())
       {
-      std::string message = "Set runtime path of \"";
-      message += file;
-      message += "\" to \"";
-      message += newRPath;
-      message += "\"";
-      this->Makefile->DisplayStatus(message.c_str(), -1);
+      threads = static_cast<unsigned int>(changes.size());
       }
-    if(have_ft)
+    cmWorkerPool pool(threads);
+    for(std::vector<cmFileRPathChange*>::iterator ci = changes.begin();
+        ci != changes.end(); ++ci)
       {
-      cmSystemTools::FileTimeSet(file, ft);
+      pool.Submit(*ci);
       }
+    pool.WaitAll();
+    }
+  else
+#endif
+    {
+    for(std::vector<cmFileRPathChange*>::iterator ci = changes.begin();
+        ci != changes.end(); ++ci)
+      {
+      (*ci)->Run();
+      }
+    }
+
+  bool success = true;
+  for(std::vector<cmFileRPathChange*>::iterator ci = changes.begin();
+      ci != changes.end(); ++ci)
+    {
+    cmFileRPathChange* change = *ci;
+    if(change->Success)
+      {
+      if(change->Changed)
+        {
+        std::string message = "Set runtime path of \"";
+        message += change->File;
+        message += "\" to \"";
+        message += newRPathStr;
+        message += "\"";
+        this->Makefile->DisplayStatus(message.c_str(), -1);
+        }
+      }
+    else if(success)
+      {
+      // Report the first failure.
+      std::ostringstream e;
+      e << "RPATH_CHANGE could not write new RPATH:\n"
+        << "  " << newRPathStr << "\n"
+        << "to the file:\n"
+        << "  " << change->File << "\n"
+        << change->Error;
+      this->SetError(e.str());
+      success = false;
+      }
+    delete change;
     }
-  cmSystemTools::FileTimeDelete(ft);
   return success;
 }
 
@@ -2505,7 +3113,9 @@ cmFileCommand::HandleRPathRemoveCommand(std::vector<std::string> const& args)
   bool have_ft = cmSystemTools::FileTimeGet(file, ft);
   std::string emsg;
   bool removed;
-  if(!cmSystemTools::RemoveRPath(file, &emsg, &removed))
+  bool unshare = this->Makefile->GetSafeDefinition(
+    "CMAKE_INSTALL_STAGING_MODE") == std::string("LINK");
+  if(!cmSystemTools::RemoveRPath(file, &emsg, &removed, unshare))
     {
     std::ostringstream e;
     e << "RPATH_REMOVE could not remove RPATH from file:\n"
@@ -2596,7 +3206,12 @@ cmFileCommand::HandleRPathCheckCommand(std::vector<std::string> const& args)
 bool cmFileCommand::HandleInstallCommand(std::vector<std::string> const& args)
 {
   cmFileInstaller installer(this);
-  return installer.Run(args);
+  if(!installer.Run(args))
+    {
+    return false;
+    }
+  installer.SaveHashes();
+  return true;
 }
 
 //----------------------------------------------------------------------------
@@ -2949,6 +3564,122 @@ namespace {
     ::CURL * Easy;
   };
 
+  // Location of the file with the given content hash in the download
+  // cache named by CMAKE_DOWNLOAD_CACHE, or an empty string if there
+  // is no cache.
+  std::string cmFileDownloadCachePath(cmMakefile* mf,
+                                      std::string const& algo,
+                                      std::string const& hash)
+    {
+    std::string dir = mf->GetSafeDefinition("CMAKE_DOWNLOAD_CACHE");
+    if(dir.empty())
+      {
+      cmSystemTools::GetEnv("CMAKE_DOWNLOAD_CACHE", dir);
+      }
+    if(dir.empty() || algo.empty() || hash.empty() ||
+       hash.find_first_not_of("0123456789abcdef") != std::string::npos)
+      {
+      return "";
+      }
+    return dir + "/" + algo + "/" + hash;
+    }
+
+  // Copy a cached file to its destination if it still has the expected
+  // content.
+  bool cmFileDownloadFromCache(std::string const& cached,
+                               cmCryptoHash& hash,
+                               std::string const& expectedHash,
+                               std::string const& file)
+    {
+    if(cached.empty() || !cmSystemTools::FileExists(cached, true) ||
+       hash.HashFile(cached) != expectedHash)
+      {
+      return false;
+      }
+    std::string dir = cmSystemTools::GetFilenamePath(file);
+    return (cmSystemTools::FileIsDirectory(dir) ||
+            cmSystemTools::MakeDirectory(dir)) &&
+      cmSystemTools::CopyFileAlways(cached, file);
+    }
+
+  // Add a verified download to the cache.  The copy is renamed into
+  // place so concurrent readers never see a partial file.
+  void cmFileDownloadStoreInCache(std::string const& file,
+                                  std::string const& cached)
+    {
+    if(cached.empty() || cmSystemTools::FileExists(cached, true))
+      {
+      return;
+      }
+    std::ostringstream tmp;
+    tmp << cached << ".tmp" << cmSystemTools::RandomSeed();
+    if(!cmSystemTools::MakeDirectory(cmSystemTools::GetFilenamePath(cached))
+       || !cmSystemTools::CopyFileAlways(file, tmp.str()) ||
+       !cmSystemTools::RenameFile(tmp.str().c_str(), cached.c_str()))
+      {
+      cmSystemTools::RemoveFile(tmp.str());
+      }
+    }
+
+  // One transfer of a file(DOWNLOAD_BATCH) call.
+  struct cmFileDownloadItem
+  {
+    cmFileDownloadItem(): Out(0), Curl(0), Result(CURLE_OK), Done(false) {}
+    std::string Url;
+    std::string File;
+    std::string Algo;
+    std::string ExpectedHash;
+    std::string CachePath;
+    cmsys::ofstream* Out;
+    ::CURL* Curl;
+    ::CURLcode Result;
+    bool Done;
+  };
+
+  // Release every transfer still in flight when a batch ends.
+  class cURLMultiGuard
+  {
+  public:
+    cURLMultiGuard(std::vector<cmFileDownloadItem>& items)
+      : Items(items)
+      {
+      ::curl_global_init(CURL_GLOBAL_DEFAULT);
+      this->Multi = ::curl_multi_init();
+      }
+
+    ~cURLMultiGuard(void)
+      {
+      for(std::vector<cmFileDownloadItem>::iterator i = this->Items.begin();
+          i != this->Items.end(); ++i)
+        {
+        this->Finish(*i);
+        }
+      if(this->Multi)
+        {
+        ::curl_multi_cleanup(this->Multi);
+        }
+      ::curl_global_cleanup();
+      }
+
+    void Finish(cmFileDownloadItem& item)
+      {
+      if(item.Curl)
+        {
+        ::curl_multi_remove_handle(this->Multi, item.Curl);
+        ::curl_easy_cleanup(item.Curl);
+        item.Curl = 0;
+        }
+      delete item.Out;
+      item.Out = 0;
+      }
+
+    ::CURLM* Get(void) { return this->Multi; }
+
+  private:
+    std::vector<cmFileDownloadItem>& Items;
+    ::CURLM* Multi;
+  };
+
 }
 #endif
 
@@ -2962,6 +3693,94 @@ namespace {
     return false;                         \
     }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+//----------------------------------------------------------------------------
+// Set the options that DOWNLOAD and DOWNLOAD_BATCH use for every
+// transfer.  Returns an error message or an empty string on success.
+static std::string cmFileDownloadSetOptions(::CURL* curl,
+                                            std::string const& cmd,
+                                            std::string const& url,
+                                            void* out, bool tls_verify,
+                                            const char* cainfo,
+                                            long timeout,
+                                            long inactivity_timeout)
+{
+  ::CURLcode res = ::curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+  if(res != CURLE_OK)
+    {
+    return cmd + " cannot set url: " + ::curl_easy_strerror(res);
+    }
+
+  // enable HTTP ERROR parsing
+  res = ::curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1);
+  if(res != CURLE_OK)
+    {
+    return cmd + " cannot set http failure option: " +
+      ::curl_easy_strerror(res);
+    }
+
+  res = ::curl_easy_setopt(curl, CURLOPT_USERAGENT, "curl/" LIBCURL_VERSION);
+  if(res != CURLE_OK)
+    {
+    return cmd + " cannot set user agent option: " +
+      ::curl_easy_strerror(res);
+    }
+
+  res = ::curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION,
+                           cmWriteToFileCallback);
+  if(res != CURLE_OK)
+    {
+    return cmd + " cannot set write function: " + ::curl_easy_strerror(res);
+    }
+
+  res = ::curl_easy_setopt(curl, CURLOPT_WRITEDATA, out);
+  if(res != CURLE_OK)
+    {
+    return cmd + " cannot set write data: " + ::curl_easy_strerror(res);
+    }
+
+  // check to see if TLS verification is requested
+  res = ::curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, tls_verify? 1 : 0);
+  if(res != CURLE_OK)
+    {
+    return std::string(tls_verify? "Unable to set TLS/SSL Verify on: " :
+                                   "Unable to set TLS/SSL Verify off: ") +
+      ::curl_easy_strerror(res);
+    }
+  // check to see if a CAINFO file has been specified
+  // command arg comes first
+  std::string const& cainfo_err = cmCurlSetCAInfo(curl, cainfo);
+  if(!cainfo_err.empty())
+    {
+    return cainfo_err;
+    }
+
+  res = ::curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+  if(res != CURLE_OK)
+    {
+    return cmd + " cannot set follow-redirect option: " +
+      ::curl_easy_strerror(res);
+    }
+
+  if(timeout > 0)
+    {
+    res = ::curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout);
+    if(res != CURLE_OK)
+      {
+      return cmd + " cannot set timeout: " + ::curl_easy_strerror(res);
+      }
+    }
+
+  if(inactivity_timeout > 0)
+    {
+    // Give up if there is no progress for a long time.
+    ::curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1);
+    ::curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, inactivity_timeout);
+    }
+  return std::string();
+}
+#endif
+
 
 bool
 cmFileCommand::HandleDownloadCommand(std::vector<std::string> const& args)
@@ -2986,6 +3805,7 @@ cmFileCommand::HandleDownloadCommand(std::vector<std::string> const& args)
   bool tls_verify = this->Makefile->IsOn("CMAKE_TLS_VERIFY");
   const char* cainfo = this->Makefile->GetDefinition("CMAKE_TLS_CAINFO");
   std::string expectedHash;
+  std::string hashAlgo;
   std::string hashMatchMSG;
   cmsys::auto_ptr<cmCryptoHash> hash;
   bool showProgress = false;
@@ -3073,6 +3893,7 @@ cmFileCommand::HandleDownloadCommand(std::vector<std::string> const& args)
         return false;
         }
       hash = cmsys::auto_ptr<cmCryptoHash>(cmCryptoHash::New("MD5"));
+      hashAlgo = "MD5";
       hashMatchMSG = "MD5 sum";
       expectedHash = cmSystemTools::LowerCase(*i);
       }
@@ -3107,6 +3928,7 @@ cmFileCommand::HandleDownloadCommand(std::vector<std::string> const& args)
         this->SetError(err);
         return false;
         }
+      hashAlgo = algo;
       hashMatchMSG = algo + " hash";
       }
     ++i;
@@ -3134,6 +3956,23 @@ cmFileCommand::HandleDownloadCommand(std::vector<std::string> const& args)
       return true;
       }
     }
+  // If a download cache is configured and already has a file with the
+  // expected hash, use it instead of transferring the file again.
+  std::string cachePath;
+  if(hash.get())
+    {
+    cachePath = cmFileDownloadCachePath(this->Makefile, hashAlgo,
+                                        expectedHash);
+    if(cmFileDownloadFromCache(cachePath, *hash, expectedHash, file))
+      {
+      if(!statusVar.empty())
+        {
+        this->Makefile->AddDefinition(statusVar,
+          "0;\"file copied from download cache\"");
+        }
+      return true;
+      }
+    }
   // Make sure parent directory exists so we can write to the file
   // as we receive downloaded bits from curl...
   //
@@ -3169,74 +4008,30 @@ cmFileCommand::HandleDownloadCommand(std::vector<std::string> const& args)
     }
 
   cURLEasyGuard g_curl(curl);
-  ::CURLcode res = ::curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
-  check_curl_result(res, "DOWNLOAD cannot set url: ");
-
-  // enable HTTP ERROR parsing
-  res = ::curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1);
-  check_curl_result(res, "DOWNLOAD cannot set http failure option: ");
-
-  res = ::curl_easy_setopt(curl, CURLOPT_USERAGENT, "curl/" LIBCURL_VERSION);
-  check_curl_result(res, "DOWNLOAD cannot set user agent option: ");
-
-  res = ::curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION,
-                           cmWriteToFileCallback);
-  check_curl_result(res, "DOWNLOAD cannot set write function: ");
-
-  res = ::curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION,
-                           cmFileCommandCurlDebugCallback);
-  check_curl_result(res, "DOWNLOAD cannot set debug function: ");
-
-  // check to see if TLS verification is requested
-  if(tls_verify)
-    {
-    res = ::curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 1);
-    check_curl_result(res, "Unable to set TLS/SSL Verify on: ");
-    }
-  else
+  std::string const& setup_err =
+    cmFileDownloadSetOptions(curl, "DOWNLOAD", url, (void *)&fout,
+                             tls_verify, cainfo, timeout, inactivity_timeout);
+  if(!setup_err.empty())
     {
-    res = ::curl_easy_setopt(curl, CURLOPT_SSL_VERIFYPEER, 0);
-    check_curl_result(res, "Unable to set TLS/SSL Verify off: ");
-    }
-  // check to see if a CAINFO file has been specified
-  // command arg comes first
-  std::string const& cainfo_err = cmCurlSetCAInfo(curl, cainfo);
-  if (!cainfo_err.empty())
-    {
-    this->SetError(cainfo_err);
+    this->SetError(setup_err);
     return false;
     }
 
-  cmFileCommandVectorOfChar chunkDebug;
+  ::CURLcode res = ::curl_easy_setopt(curl, CURLOPT_DEBUGFUNCTION,
+                                      cmFileCommandCurlDebugCallback);
+  check_curl_result(res, "DOWNLOAD cannot set debug function: ");
 
-  res = ::curl_easy_setopt(curl, CURLOPT_WRITEDATA, (void *)&fout);
-  check_curl_result(res, "DOWNLOAD cannot set write data: ");
+  cmFileCommandVectorOfChar chunkDebug;
 
   res = ::curl_easy_setopt(curl, CURLOPT_DEBUGDATA, (void *)&chunkDebug);
   check_curl_result(res, "DOWNLOAD cannot set debug data: ");
 
-  res = ::curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
-  check_curl_result(res, "DOWNLOAD cannot set follow-redirect option: ");
-
   if(!logVar.empty())
     {
     res = ::curl_easy_setopt(curl, CURLOPT_VERBOSE, 1);
     check_curl_result(res, "DOWNLOAD cannot set verbose: ");
     }
 
-  if(timeout > 0)
-    {
-    res = ::curl_easy_setopt(curl, CURLOPT_TIMEOUT, timeout );
-    check_curl_result(res, "DOWNLOAD cannot set timeout: ");
-    }
-
-  if(inactivity_timeout > 0)
-    {
-    // Give up if there is no progress for a long time.
-    ::curl_easy_setopt(curl, CURLOPT_LOW_SPEED_LIMIT, 1);
-    ::curl_easy_setopt(curl, CURLOPT_LOW_SPEED_TIME, inactivity_timeout);
-    }
-
   // Need the progress helper's scope to last through the duration of
   // the curl_easy_perform call... so this object is declared at function
   // scope intentionally, rather than inside the "if(showProgress)"
@@ -3312,6 +4107,8 @@ cmFileCommand::HandleDownloadCommand(std::vector<std::string> const& args)
       this->SetError(oss.str());
       return false;
       }
+
+    cmFileDownloadStoreInCache(file, cachePath);
     }
 
   if (!logVar.empty())
@@ -3328,6 +4125,304 @@ cmFileCommand::HandleDownloadCommand(std::vector<std::string> const& args)
 }
 
 
+bool
+cmFileCommand::HandleDownloadBatchCommand(
+  std::vector<std::string> const& args)
+{
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  std::vector<cmFileDownloadItem> items;
+  long timeout = 0;
+  long inactivity_timeout = 0;
+  unsigned long parallel = 8;
+  std::string statusVar;
+  bool tls_verify = this->Makefile->IsOn("CMAKE_TLS_VERIFY");
+  const char* cainfo = this->Makefile->GetDefinition("CMAKE_TLS_CAINFO");
+
+  for(std::vector<std::string>::const_iterator i = args.begin() + 1;
+      i != args.end(); ++i)
+    {
+    if(*i == "FILE")
+      {
+      if(args.end() - i < 3)
+        {
+        this->SetError("DOWNLOAD_BATCH FILE requires a URL and a file name.");
+        return false;
+        }
+      cmFileDownloadItem item;
+      item.Url = *++i;
+      item.File = *++i;
+#if defined(_WIN32) && defined(CMAKE_ENCODING_UTF8)
+      item.Url = fix_file_url_windows(item.Url);
+#endif
+      items.push_back(item);
+      }
+    else if(*i == "EXPECTED_HASH" || *i == "EXPECTED_MD5")
+      {
+      std::string const& option = *i;
+      if(items.empty())
+        {
+        this->SetError("DOWNLOAD_BATCH " + option + " must follow a FILE.");
+        return false;
+        }
+      if(++i == args.end())
+        {
+        this->SetError("DOWNLOAD_BATCH missing value for " + option + ".");
+        return false;
+        }
+      std::string algo = "MD5";
+      std::string value = *i;
+      if(option == "EXPECTED_HASH")
+        {
+        std::string::size_type pos = i->find("=");
+        if(pos == std::string::npos)
+          {
+          this->SetError(
+            "DOWNLOAD_BATCH EXPECTED_HASH expects ALGO=value but got: " + *i);
+          return false;
+          }
+        algo = i->substr(0, pos);
+        value = i->substr(pos+1);
+        if(!cmCryptoHash::New(algo.c_str()).get())
+          {
+          this->SetError(
+            "DOWNLOAD_BATCH EXPECTED_HASH given unknown ALGO: " + algo);
+          return false;
+          }
+        }
+      items.back().Algo = algo;
+      items.back().ExpectedHash = cmSystemTools::LowerCase(value);
+      }
+    else if(*i == "PARALLEL_LEVEL")
+      {
+      if(++i == args.end() ||
+         !cmSystemTools::StringToULong(i->c_str(), &parallel) ||
+         parallel < 1)
+        {
+        this->SetError(
+          "DOWNLOAD_BATCH PARALLEL_LEVEL requires a positive integer.");
+        return false;
+        }
+      }
+    else if(*i == "TIMEOUT")
+      {
+      if(++i == args.end())
+        {
+        this->SetError("DOWNLOAD_BATCH missing time for TIMEOUT.");
+        return false;
+        }
+      timeout = atol(i->c_str());
+      }
+    else if(*i == "INACTIVITY_TIMEOUT")
+      {
+      if(++i == args.end())
+        {
+        this->SetError(
+          "DOWNLOAD_BATCH missing time for INACTIVITY_TIMEOUT.");
+        return false;
+        }
+      inactivity_timeout = atol(i->c_str());
+      }
+    else if(*i == "STATUS")
+      {
+      if(++i == args.end())
+        {
+        this->SetError("DOWNLOAD_BATCH missing VAR for STATUS.");
+        return false;
+        }
+      statusVar = *i;
+      }
+    else if(*i == "TLS_VERIFY")
+      {
+      if(++i == args.end())
+        {
+        this->SetError("TLS_VERIFY missing bool value.");
+        return false;
+        }
+      tls_verify = cmSystemTools::IsOn(i->c_str());
+      }
+    else if(*i == "TLS_CAINFO")
+      {
+      if(++i == args.end())
+        {
+        this->SetError("TLS_CAFILE missing file value.");
+        return false;
+        }
+      cainfo = i->c_str();
+      }
+    else
+      {
+      this->SetError("DOWNLOAD_BATCH given unknown argument \"" + *i + "\".");
+      return false;
+      }
+    }
+
+  // Skip files that are already present with the expected hash, either
+  // at their destination or in the download cache.
+  for(std::vector<cmFileDownloadItem>::iterator item = items.begin();
+      item != items.end(); ++item)
+    {
+    if(item->Algo.empty())
+      {
+      continue;
+      }
+    cmsys::auto_ptr<cmCryptoHash> hash =
+      cmCryptoHash::New(item->Algo.c_str());
+    item->CachePath = cmFileDownloadCachePath(this->Makefile, item->Algo,
+                                              item->ExpectedHash);
+    item->Done =
+      (cmSystemTools::FileExists(item->File.c_str()) &&
+       hash->HashFile(item->File) == item->ExpectedHash) ||
+      cmFileDownloadFromCache(item->CachePath, *hash, item->ExpectedHash,
+                              item->File);
+    }
+
+  // Run the remaining transfers concurrently, keeping at most the
+  // requested number of them in flight.
+  cURLMultiGuard multi(items);
+  if(!multi.Get())
+    {
+    this->SetError("DOWNLOAD_BATCH error initializing curl.");
+    return false;
+    }
+  std::vector<cmFileDownloadItem>::iterator next = items.begin();
+  unsigned long active = 0;
+  for(;;)
+    {
+    for(; next != items.end() && active < parallel; ++next)
+      {
+      if(next->Done)
+        {
+        continue;
+        }
+      std::string dir = cmSystemTools::GetFilenamePath(next->File);
+      if(!cmSystemTools::FileExists(dir.c_str()) &&
+         !cmSystemTools::MakeDirectory(dir.c_str()))
+        {
+        this->SetError("DOWNLOAD_BATCH error: cannot create directory '"
+                       + dir + "'.");
+        return false;
+        }
+      next->Out = new cmsys::ofstream(next->File.c_str(), std::ios::binary);
+      if(!*next->Out)
+        {
+        this->SetError("DOWNLOAD_BATCH cannot open file for write: "
+                       + next->File);
+        return false;
+        }
+      ::CURL* curl = next->Curl = ::curl_easy_init();
+      if(!curl)
+        {
+        this->SetError("DOWNLOAD_BATCH error initializing curl.");
+        return false;
+        }
+      std::string const& setup_err =
+        cmFileDownloadSetOptions(curl, "DOWNLOAD_BATCH", next->Url,
+                                 static_cast<void*>(next->Out), tls_verify,
+                                 cainfo, timeout, inactivity_timeout);
+      if(!setup_err.empty())
+        {
+        this->SetError(setup_err);
+        return false;
+        }
+      ::CURLcode res = ::curl_easy_setopt(curl, CURLOPT_PRIVATE,
+                                          static_cast<void*>(&*next));
+      check_curl_result(res, "DOWNLOAD_BATCH cannot set private data: ");
+      if(::curl_multi_add_handle(multi.Get(), curl) != CURLM_OK)
+        {
+        this->SetError("DOWNLOAD_BATCH cannot start transfer of " +
+                       next->Url);
+        return false;
+        }
+      ++active;
+      }
+    if(active == 0)
+      {
+      break;
+      }
+
+    int running = 0;
+    ::curl_multi_perform(multi.Get(), &running);
+    bool finished = false;
+    int left = 0;
+    while(::CURLMsg* msg = ::curl_multi_info_read(multi.Get(), &left))
+      {
+      if(msg->msg != CURLMSG_DONE)
+        {
+        continue;
+        }
+      void* data = 0;
+      ::curl_easy_getinfo(msg->easy_handle, CURLINFO_PRIVATE, &data);
+      cmFileDownloadItem* item = static_cast<cmFileDownloadItem*>(data);
+      item->Result = msg->data.result;
+      multi.Finish(*item);
+      --active;
+      finished = true;
+      }
+    if(!finished)
+      {
+      ::curl_multi_wait(multi.Get(), 0, 0, 1000, 0);
+      }
+    }
+
+  // Report the first failure and verify the hashes in input order.
+  ::CURLcode status = CURLE_OK;
+  std::string statusMsg = ::curl_easy_strerror(status);
+  for(std::vector<cmFileDownloadItem>::iterator item = items.begin();
+      item != items.end(); ++item)
+    {
+    if(item->Done)
+      {
+      continue;
+      }
+    if(item->Result != CURLE_OK && status == CURLE_OK)
+      {
+      status = item->Result;
+      statusMsg = item->Url + ": " + ::curl_easy_strerror(item->Result);
+      }
+    if(item->Algo.empty())
+      {
+      continue;
+      }
+    cmsys::auto_ptr<cmCryptoHash> hash =
+      cmCryptoHash::New(item->Algo.c_str());
+    std::string actualHash = hash->HashFile(item->File);
+    if(actualHash != item->ExpectedHash)
+      {
+      std::ostringstream oss;
+      oss << "DOWNLOAD_BATCH HASH mismatch" << std::endl
+        << "  for file: [" << item->File << "]" << std::endl
+        << "    expected hash: [" << item->ExpectedHash << "]" << std::endl
+        << "      actual hash: [" << actualHash << "]" << std::endl
+        << "           status: [" << (int)item->Result << ";\""
+          << ::curl_easy_strerror(item->Result) << "\"]" << std::endl
+        ;
+      if(!statusVar.empty() && status == CURLE_OK)
+        {
+        std::string s = "1;HASH mismatch: " + item->File +
+          " expected: " + item->ExpectedHash + " actual: " + actualHash;
+        this->Makefile->AddDefinition(statusVar, s.c_str());
+        }
+      this->SetError(oss.str());
+      return false;
+      }
+    cmFileDownloadStoreInCache(item->File, item->CachePath);
+    }
+
+  if(!statusVar.empty())
+    {
+    std::ostringstream result;
+    result << (int)status << ";\"" << statusMsg << "\"";
+    this->Makefile->AddDefinition(statusVar, result.str().c_str());
+    }
+  return true;
+#else
+  static_cast<void>(args);
+  this->SetError("DOWNLOAD_BATCH not supported by bootstrap cmake.");
+  return false;
+#endif
+}
+
+
 bool
 cmFileCommand::HandleUploadCommand(std::vector<std::string> const& args)
 {
@@ -3641,6 +4736,7 @@ bool cmFileCommand::HandleLockCommand(
   // Default values
   bool directory = false;
   bool release = false;
+  bool shared = false;
   enum Guard {
     GUARD_FUNCTION,
     GUARD_FILE,
@@ -3648,6 +4744,7 @@ bool cmFileCommand::HandleLockCommand(
   };
   Guard guard = GUARD_PROCESS;
   std::string resultVariable;
+  std::string waitTimeVariable;
   unsigned long timeout = static_cast<unsigned long>(-1);
 
   // Parse arguments
@@ -3670,6 +4767,10 @@ bool cmFileCommand::HandleLockCommand(
       {
       release = true;
       }
+    else if (args[i] == "SHARED")
+      {
+      shared = true;
+      }
     else if (args[i] == "GUARD")
       {
       ++i;
@@ -3714,6 +4815,18 @@ bool cmFileCommand::HandleLockCommand(
         }
       resultVariable = args[i];
       }
+    else if (args[i] == "WAIT_TIME_VARIABLE")
+      {
+      ++i;
+      if (i >= args.size())
+        {
+        this->Makefile->IssueMessage(
+            cmake::FATAL_ERROR,
+            "expected variable name after WAIT_TIME_VARIABLE");
+        return false;
+        }
+      waitTimeVariable = args[i];
+      }
     else if (args[i] == "TIMEOUT")
       {
       ++i;
@@ -3738,7 +4851,8 @@ bool cmFileCommand::HandleLockCommand(
     else
       {
       std::ostringstream e;
-      e << "expected DIRECTORY, RELEASE, GUARD, RESULT_VARIABLE or TIMEOUT\n";
+      e << "expected DIRECTORY, RELEASE, SHARED, GUARD, RESULT_VARIABLE, "
+        << "WAIT_TIME_VARIABLE or TIMEOUT\n";
       e << "but got: \"" << args[i] << "\".";
       this->Makefile->IssueMessage(cmake::FATAL_ERROR, e.str());
       return false;
@@ -3785,6 +4899,7 @@ bool cmFileCommand::HandleLockCommand(
                                            ->GetFileLockPool();
 
   cmFileLockResult fileLockResult(cmFileLockResult::MakeOk());
+  const double startTime = cmSystemTools::GetTime();
   if (release)
     {
     fileLockResult = lockPool.Release(path);
@@ -3794,13 +4909,13 @@ bool cmFileCommand::HandleLockCommand(
     switch (guard)
       {
       case GUARD_FUNCTION:
-        fileLockResult = lockPool.LockFunctionScope(path, timeout);
+        fileLockResult = lockPool.LockFunctionScope(path, timeout, shared);
         break;
       case GUARD_FILE:
-        fileLockResult = lockPool.LockFileScope(path, timeout);
+        fileLockResult = lockPool.LockFileScope(path, timeout, shared);
         break;
       case GUARD_PROCESS:
-        fileLockResult = lockPool.LockProcessScope(path, timeout);
+        fileLockResult = lockPool.LockProcessScope(path, timeout, shared);
         break;
       default:
         cmSystemTools::SetFatalErrorOccured();
@@ -3808,8 +4923,16 @@ bool cmFileCommand::HandleLockCommand(
       }
     }
 
+  const double waitTime = cmSystemTools::GetTime() - startTime;
   const std::string result = fileLockResult.GetOutputMessage();
 
+  if (!waitTimeVariable.empty())
+    {
+    std::ostringstream w;
+    w << std::fixed << std::setprecision(3) << waitTime;
+    this->Makefile->AddDefinition(waitTimeVariable, w.str().c_str());
+    }
+
   if (resultVariable.empty() && !fileLockResult.IsOk())
     {
     std::ostringstream e;
@@ -28,7 +28,7 @@ cmFileLock::~cmFileLock()
 }
 
 cmFileLockResult cmFileLock::Lock(
-    const std::string& filename, unsigned long timeout)
+    const std::string& filename, unsigned long timeout, bool shared)
 {
   if (filename.empty())
     {
@@ -45,6 +45,7 @@ cmFileLockResult cmFileLock::Lock(
     }
 
   this->Filename = filename;
+  this->Shared = shared;
   cmFileLockResult result = this->OpenFile();
   if (result.IsOk())
     {
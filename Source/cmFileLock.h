@@ -24,8 +24,9 @@ class cmFileLockResult;
 /**
   * @brief Cross-platform file locking.
   * @details Under the hood this class use 'fcntl' for Unix-like platforms and
-  * 'LockFileEx'/'UnlockFileEx' for Win32 platform. Locks are exclusive and
-  * advisory.
+  * 'LockFileEx'/'UnlockFileEx' for Win32 platform. Locks are exclusive or
+  * shared and advisory. Waiting for a lock with a timeout blocks in the
+  * system call until the lock is granted or the timeout expires.
   */
 class cmFileLock
 {
@@ -36,8 +37,10 @@ class cmFileLock
   /**
     * @brief Lock the file.
     * @param timeoutSec Lock timeout. If -1 try until success or fatal error.
+    * @param shared Take a shared (reader) lock instead of an exclusive one.
     */
-  cmFileLockResult Lock(const std::string& filename, unsigned long timeoutSec);
+  cmFileLockResult Lock(const std::string& filename, unsigned long timeoutSec,
+                        bool shared);
 
   /**
     * @brief Unlock the file.
@@ -61,7 +64,7 @@ class cmFileLock
 
 #if defined(_WIN32)
   typedef HANDLE FileId;
-  BOOL LockFile(DWORD flags);
+  BOOL LockFile(DWORD flags, OVERLAPPED* overlapped);
 #else
   typedef int FileId;
   int LockFile(int cmd, int type);
@@ -69,6 +72,7 @@ class cmFileLock
 
   FileId File;
   std::string Filename;
+  bool Shared;
 };
 
 #endif // cmFileLock_h
@@ -53,7 +53,7 @@ void cmFileLockPool::PopFileScope()
 }
 
 cmFileLockResult cmFileLockPool::LockFunctionScope(
-    const std::string& filename, unsigned long timeoutSec)
+    const std::string& filename, unsigned long timeoutSec, bool shared)
 {
   if (this->IsAlreadyLocked(filename))
     {
@@ -63,28 +63,28 @@ cmFileLockResult cmFileLockPool::LockFunctionScope(
     {
     return cmFileLockResult::MakeNoFunction();
     }
-  return this->FunctionScopes.back()->Lock(filename, timeoutSec);
+  return this->FunctionScopes.back()->Lock(filename, timeoutSec, shared);
 }
 
 cmFileLockResult cmFileLockPool::LockFileScope(
-    const std::string& filename, unsigned long timeoutSec)
+    const std::string& filename, unsigned long timeoutSec, bool shared)
 {
   if (this->IsAlreadyLocked(filename))
     {
     return cmFileLockResult::MakeAlreadyLocked();
     }
   assert(!this->FileScopes.empty());
-  return this->FileScopes.back()->Lock(filename, timeoutSec);
+  return this->FileScopes.back()->Lock(filename, timeoutSec, shared);
 }
 
 cmFileLockResult cmFileLockPool::LockProcessScope(
-    const std::string& filename, unsigned long timeoutSec)
+    const std::string& filename, unsigned long timeoutSec, bool shared)
 {
   if (this->IsAlreadyLocked(filename))
     {
     return cmFileLockResult::MakeAlreadyLocked();
     }
-  return this->ProcessScope.Lock(filename, timeoutSec);
+  return this->ProcessScope.Lock(filename, timeoutSec, shared);
 }
 
 cmFileLockResult cmFileLockPool::Release(const std::string& filename)
@@ -145,10 +145,10 @@ cmFileLockPool::ScopePool::~ScopePool()
 }
 
 cmFileLockResult cmFileLockPool::ScopePool::Lock(
-    const std::string& filename, unsigned long timeoutSec)
+    const std::string& filename, unsigned long timeoutSec, bool shared)
 {
   cmFileLock *lock = new cmFileLock();
-  const cmFileLockResult result = lock->Lock(filename, timeoutSec);
+  const cmFileLockResult result = lock->Lock(filename, timeoutSec, shared);
   if (result.IsOk())
     {
     this->Locks.push_back(lock);
@@ -45,15 +45,16 @@ class cmFileLockPool
   /**
     * @brief Lock the file in given scope.
     * @param timeoutSec Lock timeout. If -1 try until success or fatal error.
+    * @param shared Take a shared (reader) lock instead of an exclusive one.
     */
   cmFileLockResult LockFunctionScope(
-      const std::string& filename, unsigned long timeoutSec
+      const std::string& filename, unsigned long timeoutSec, bool shared
   );
   cmFileLockResult LockFileScope(
-      const std::string& filename, unsigned long timeoutSec
+      const std::string& filename, unsigned long timeoutSec, bool shared
   );
   cmFileLockResult LockProcessScope(
-      const std::string& filename, unsigned long timeoutSec
+      const std::string& filename, unsigned long timeoutSec, bool shared
   );
   //@}
 
@@ -75,7 +76,7 @@ class cmFileLockPool
     ~ScopePool();
 
     cmFileLockResult Lock(
-        const std::string& filename, unsigned long timeoutSec
+        const std::string& filename, unsigned long timeoutSec, bool shared
     );
     cmFileLockResult Release(const std::string& filename);
     bool IsAlreadyLocked(const std::string& filename) const;
@@ -18,7 +18,7 @@
 #include <unistd.h>
 #include "cmSystemTools.h"
 
-cmFileLock::cmFileLock(): File(-1)
+cmFileLock::cmFileLock(): File(-1), Shared(false)
 {
 }
 
@@ -60,7 +60,13 @@ cmFileLockResult cmFileLock::OpenFile()
 
 cmFileLockResult cmFileLock::LockWithoutTimeout()
 {
-  if (this->LockFile(F_SETLKW, F_WRLCK) == -1)
+  const int type = this->Shared ? F_RDLCK : F_WRLCK;
+  int lockResult;
+  while ((lockResult = this->LockFile(F_SETLKW, type)) == -1 &&
+         errno == EINTR)
+    {
+    }
+  if (lockResult == -1)
     {
     return cmFileLockResult::MakeSystem();
     }
@@ -72,25 +78,53 @@ cmFileLockResult cmFileLock::LockWithoutTimeout()
 
 cmFileLockResult cmFileLock::LockWithTimeout(unsigned long seconds)
 {
+  const int type = this->Shared ? F_RDLCK : F_WRLCK;
+  if (this->LockFile(F_SETLK, type) == 0)
+    {
+    return cmFileLockResult::MakeOk();
+    }
+  if (errno != EACCES && errno != EAGAIN)
+    {
+    return cmFileLockResult::MakeSystem();
+    }
+  if (seconds == 0)
+    {
+    return cmFileLockResult::MakeTimeout();
+    }
+
+  // Poll for the lock, starting with short delays so that a lock held
+  // briefly is granted soon and backing off to bound the number of
+  // attempts during long waits.  A timer signal could interrupt a
+  // blocking F_SETLKW instead, but would reach an arbitrary thread and
+  // clash with any timer the process already uses.
+  const double deadline =
+    cmSystemTools::GetTime() + static_cast<double>(seconds);
+  unsigned int delay = 10;
   while (true)
     {
-    if (this->LockFile(F_SETLK, F_WRLCK) == -1)
+    double remaining = deadline - cmSystemTools::GetTime();
+    if (remaining <= 0)
+      {
+      return cmFileLockResult::MakeTimeout();
+      }
+    unsigned int ms = delay;
+    if (remaining * 1000 < ms)
       {
-      if (errno != EACCES && errno != EAGAIN)
-        {
-        return cmFileLockResult::MakeSystem();
-        }
+      ms = static_cast<unsigned int>(remaining * 1000) + 1;
       }
-    else
+    cmSystemTools::Delay(ms);
+    if (this->LockFile(F_SETLK, type) == 0)
       {
       return cmFileLockResult::MakeOk();
       }
-    if (seconds == 0)
+    if (errno != EACCES && errno != EAGAIN)
       {
-      return cmFileLockResult::MakeTimeout();
+      return cmFileLockResult::MakeSystem();
+      }
+    if (delay < 200)
+      {
+      delay *= 2;
       }
-    --seconds;
-    cmSystemTools::Delay(1000);
     }
 }
 
@@ -100,7 +134,7 @@ int cmFileLock::LockFile(int cmd, int type)
   lock.l_start = 0;
   lock.l_len = 0; // lock all bytes
   lock.l_pid = 0; // unused (for F_GETLK only)
-  lock.l_type = static_cast<short>(type); // exclusive lock
+  lock.l_type = static_cast<short>(type); // exclusive or shared lock
   lock.l_whence = SEEK_SET;
   return ::fcntl(this->File, cmd, &lock);
 }
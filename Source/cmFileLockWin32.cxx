@@ -15,7 +15,7 @@
 #include <windows.h> // CreateFileW
 #include "cmSystemTools.h"
 
-cmFileLock::cmFileLock(): File(INVALID_HANDLE_VALUE)
+cmFileLock::cmFileLock(): File(INVALID_HANDLE_VALUE), Shared(false)
 {
 }
 
@@ -56,7 +56,8 @@ cmFileLockResult cmFileLock::OpenFile()
   const DWORD access = GENERIC_READ | GENERIC_WRITE;
   const DWORD shareMode = FILE_SHARE_READ | FILE_SHARE_WRITE;
   const PSECURITY_ATTRIBUTES security = NULL;
-  const DWORD attr = 0;
+  // Overlapped mode lets LockWithTimeout wait for the lock with a timeout.
+  const DWORD attr = FILE_FLAG_OVERLAPPED;
   const HANDLE templ = NULL;
   this->File = CreateFileW(
       cmSystemTools::ConvertToWindowsExtendedPath(this->Filename).c_str(),
@@ -79,51 +80,60 @@ cmFileLockResult cmFileLock::OpenFile()
 
 cmFileLockResult cmFileLock::LockWithoutTimeout()
 {
-  if (!this->LockFile(LOCKFILE_EXCLUSIVE_LOCK))
-    {
-    return cmFileLockResult::MakeSystem();
-    }
-  else
-    {
-    return cmFileLockResult::MakeOk();
-    }
+  return this->LockWithTimeout(static_cast<unsigned long>(-1));
 }
 
 cmFileLockResult cmFileLock::LockWithTimeout(unsigned long seconds)
 {
-  const DWORD flags = LOCKFILE_EXCLUSIVE_LOCK | LOCKFILE_FAIL_IMMEDIATELY;
-  while (true)
+  const DWORD flags = this->Shared ? 0 : LOCKFILE_EXCLUSIVE_LOCK;
+  OVERLAPPED overlapped;
+  ZeroMemory(&overlapped, sizeof(overlapped));
+  overlapped.hEvent = CreateEventW(NULL, TRUE, FALSE, NULL);
+  if (!overlapped.hEvent)
     {
-    const BOOL result = this->LockFile(flags);
-    if (result)
-      {
-      return cmFileLockResult::MakeOk();
-      }
-    const DWORD error = GetLastError();
-    if (error != ERROR_LOCK_VIOLATION)
-      {
-      return cmFileLockResult::MakeSystem();
-      }
-    if (seconds == 0)
+    return cmFileLockResult::MakeSystem();
+    }
+
+  // The lock request completes asynchronously; wait for it in the
+  // kernel and cancel it when the timeout expires.
+  BOOL result = this->LockFile(flags, &overlapped);
+  if (!result && GetLastError() == ERROR_IO_PENDING)
+    {
+    // Timeouts too long for the wait mean no timeout at all.
+    const DWORD ms = seconds > (INFINITE - 1) / 1000 ?
+      INFINITE : static_cast<DWORD>(seconds * 1000);
+    if (WaitForSingleObject(overlapped.hEvent, ms) != WAIT_OBJECT_0)
       {
-      return cmFileLockResult::MakeTimeout();
+      CancelIo(this->File);
       }
-    --seconds;
-    cmSystemTools::Delay(1000);
+    DWORD transferred;
+    result = GetOverlappedResult(this->File, &overlapped, &transferred, TRUE);
     }
+  const DWORD error = result ? ERROR_SUCCESS : GetLastError();
+  CloseHandle(overlapped.hEvent);
+
+  if (result)
+    {
+    return cmFileLockResult::MakeOk();
+    }
+  if (error == ERROR_OPERATION_ABORTED || error == ERROR_LOCK_VIOLATION)
+    {
+    return cmFileLockResult::MakeTimeout();
+    }
+  SetLastError(error);
+  return cmFileLockResult::MakeSystem();
 }
 
-BOOL cmFileLock::LockFile(DWORD flags)
+BOOL cmFileLock::LockFile(DWORD flags, OVERLAPPED* overlapped)
 {
   const DWORD reserved = 0;
   const unsigned long len = static_cast<unsigned long>(-1);
-  static OVERLAPPED overlapped;
   return LockFileEx(
       this->File,
       flags,
       reserved,
       len,
       len,
-      &overlapped
+      overlapped
   );
 }
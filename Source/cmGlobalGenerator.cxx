@@ -42,6 +42,8 @@
 # include <cmsys/MD5.h>
 # include "cm_jsoncpp_value.h"
 # include "cm_jsoncpp_writer.h"
+# include "cmJobserverClient.h"
+# include "cmWorkerPool.h"
 #endif
 
 #include <stdlib.h> // required for atof
@@ -97,10 +99,37 @@ cmGlobalGenerator::cmGlobalGenerator(cmake* cm)
 
 cmGlobalGenerator::~cmGlobalGenerator()
 {
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  this->SaveInstallHashManifests();
+#endif
   this->ClearGeneratorMembers();
   delete this->ExtraGenerator;
 }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+cmInstallHashManifest&
+cmGlobalGenerator::GetInstallHashManifest(std::string const& file)
+{
+  cmInstallHashManifest& manifest = this->InstallHashManifests[file];
+  manifest.Load(file);
+  return manifest;
+}
+
+void cmGlobalGenerator::SaveInstallHashManifests()
+{
+  for(std::map<std::string, cmInstallHashManifest>::iterator
+        i = this->InstallHashManifests.begin();
+      i != this->InstallHashManifests.end(); ++i)
+    {
+    if(!i->second.Save())
+      {
+      cmSystemTools::Error("Cannot write install hash manifest \"",
+                           i->first.c_str(), "\".");
+      }
+    }
+}
+#endif
+
 bool cmGlobalGenerator::SetGeneratorPlatform(std::string const& p,
                                              cmMakefile* mf)
 {
@@ -1875,6 +1904,26 @@ int cmGlobalGenerator::Build(
                              bindir, target, config, fast, verbose,
                              nativeOptions);
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+  // A native tool that cannot join the jobserver of an enclosing make
+  // gets one job for the implicit slot plus one for each token we can
+  // take right now.  The tokens are returned when the build finishes.
+  // Options given by the caller come later and still take precedence.
+  cmJobserverClient jobserver;
+  std::string jobsOption = this->GetParallelJobsOption();
+  if(!jobsOption.empty() && !makeCommand.empty() && jobserver.Connect())
+    {
+    unsigned int maxTokens = cmWorkerPool::GetNumberOfProcessors() - 1;
+    while(jobserver.GetNumberOfTokens() < maxTokens &&
+          jobserver.TryAcquire())
+      {
+      }
+    std::ostringstream jobs;
+    jobs << jobsOption << (jobserver.GetNumberOfTokens() + 1);
+    makeCommand.insert(makeCommand.begin() + 1, jobs.str());
+    }
+#endif
+
   // Workaround to convince VCExpress.exe to produce output.
   if (outputflag == cmSystemTools::OUTPUT_PASSTHROUGH &&
       !makeCommand.empty() && cmSystemTools::LowerCase(
@@ -2395,7 +2444,7 @@ void cmGlobalGenerator::CreateDefaultGlobalTargets(cmTargets* targets)
     (*targets)[this->GetTestTargetName()]
       = this->CreateGlobalTarget(this->GetTestTargetName(),
         "Running tests...", &cpackCommandLines, depends, 0,
-        /*uses_terminal*/true);
+        /*uses_terminal*/true, /*job_server_aware*/true);
     }
 
   //Edit Cache
@@ -2611,7 +2660,7 @@ cmTarget cmGlobalGenerator::CreateGlobalTarget(
   const cmCustomCommandLines* commandLines,
   std::vector<std::string> depends,
   const char* workingDirectory,
-  bool uses_terminal)
+  bool uses_terminal, bool job_server_aware)
 {
   // Package
   cmTarget target;
@@ -2625,6 +2674,7 @@ cmTarget cmGlobalGenerator::CreateGlobalTarget(
   cmCustomCommand cc(0, no_outputs, no_byproducts, no_depends,
                      *commandLines, 0, workingDirectory);
   cc.SetUsesTerminal(uses_terminal);
+  cc.SetJobserverAware(job_server_aware);
   target.AddPostBuildCommand(cc);
   target.SetProperty("EchoString", message);
   std::vector<std::string>::iterator dit;
@@ -25,6 +25,7 @@
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 # include "cmFileLockPool.h"
+# include "cmInstallHashManifest.h"
 # ifdef CMake_HAVE_CXX11_UNORDERED_MAP
 #  include <unordered_map>
 # else
@@ -165,6 +166,15 @@ public:
     std::vector<std::string> const& makeOptions = std::vector<std::string>()
     );
 
+  /**
+   * Return the prefix of the native tool option that limits the number
+   * of parallel jobs, e.g. "-j".  Build() uses it to share the jobserver
+   * of an enclosing GNU make with tools that cannot join it by
+   * themselves.  Tools that join the jobserver or have no such option
+   * return an empty string.
+   */
+  virtual std::string GetParallelJobsOption() const { return std::string(); }
+
   /** Generate a "cmake --build" call for a given target and config.  */
   std::string GenerateCMakeBuildCommand(const std::string& target,
                                         const std::string& config,
@@ -353,6 +363,10 @@ public:
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   cmFileLockPool& GetFileLockPool() { return FileLockPool; }
+
+  /** Get the install hash manifest stored in a file, reading it the
+      first time.  It is written back when the generator is destroyed.  */
+  cmInstallHashManifest& GetInstallHashManifest(std::string const& file);
 #endif
 
   bool GetConfigureDoneCMP0026() const
@@ -397,7 +411,7 @@ protected:
   cmTarget CreateGlobalTarget(const std::string& name, const char* message,
     const cmCustomCommandLines* commandLines,
     std::vector<std::string> depends, const char* workingDir,
-    bool uses_terminal);
+    bool uses_terminal, bool job_server_aware = false);
 
   std::string FindMakeProgramFile;
   std::string ConfiguredFilesPath;
@@ -522,6 +536,10 @@ private:
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   // Pool of file locks
   cmFileLockPool FileLockPool;
+
+  // Install hash manifests by file name
+  std::map<std::string, cmInstallHashManifest> InstallHashManifests;
+  void SaveInstallHashManifests();
 #endif
 
 protected:
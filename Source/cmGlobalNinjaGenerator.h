@@ -198,6 +198,8 @@ public:
     std::vector<std::string> const& makeOptions = std::vector<std::string>()
     );
 
+  virtual std::string GetParallelJobsOption() const { return "-j"; }
+
   // Setup target names
   virtual const char* GetAllTargetName()           const { return "all"; }
   virtual const char* GetInstallTargetName()       const { return "install"; }
@@ -32,6 +32,7 @@ cmGlobalUnixMakefileGenerator3::cmGlobalUnixMakefileGenerator3(cmake* cm)
   this->UseLinkScript = true;
 #endif
   this->CommandDatabase = NULL;
+  this->FlatMakefiles = false;
 
   this->IncludeDirective = "include";
   this->DefineWindowsNULL = false;
@@ -131,6 +132,12 @@ void cmGlobalUnixMakefileGenerator3::Configure()
 
 void cmGlobalUnixMakefileGenerator3::Generate()
 {
+  // Decide whether all targets are built from one flat makefile.  The
+  // target generators need to know this to name their variables.
+  this->FlatMakefiles = this->SupportsFlatMakefiles() &&
+    !this->Makefiles.empty() &&
+    this->Makefiles[0]->IsOn("CMAKE_FLAT_MAKEFILES");
+
   // first do superclass method
   this->cmGlobalGenerator::Generate();
 
@@ -262,6 +269,37 @@ void cmGlobalUnixMakefileGenerator3::WriteMainMakefile2()
   // Write out the "special" stuff
   lg->WriteSpecialTargetsTop(makefileStream);
 
+  // Include the rules of all targets built without recursion so that
+  // make sees one graph and schedules across target boundaries.
+  this->ComputeFlatTargets();
+  if(this->FlatMakefiles)
+    {
+    lg->WriteDivider(makefileStream);
+    makefileStream
+      << "# Include the rules of targets built by this makefile.\n\n";
+    for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i)
+      {
+      cmLocalUnixMakefileGenerator3* tlg =
+        static_cast<cmLocalUnixMakefileGenerator3*>(this->LocalGenerators[i]);
+      std::vector<cmGeneratorTarget*> targets = tlg->GetGeneratorTargets();
+      for(std::vector<cmGeneratorTarget*>::iterator t = targets.begin();
+          t != targets.end(); ++t)
+        {
+        if(this->IsFlatTarget(*t))
+          {
+          std::string buildMake = tlg->GetRelativeTargetDirectory(*t);
+          buildMake += "/build.make";
+          makefileStream
+            << this->IncludeDirective << " "
+            << tlg->Convert(buildMake, cmLocalGenerator::HOME_OUTPUT,
+                            cmLocalGenerator::MAKERULE)
+            << "\n";
+          }
+        }
+      }
+    makefileStream << "\n";
+    }
+
   // write the target convenience rules
   unsigned int i;
   for (i = 0; i < this->LocalGenerators.size(); ++i)
@@ -647,12 +685,19 @@ cmGlobalUnixMakefileGenerator3
           << "# Target rules for targets named "
           << name << "\n\n";
 
-        // Write the rule.
+        // Write the rule.  The flat Makefile2 has no rule named after
+        // the target because a target file may have the same name.
         commands.clear();
         std::string tmp = cmake::GetCMakeFilesDirectoryPostSlash();
         tmp += "Makefile2";
+        std::string rule = name;
+        if(this->FlatMakefiles)
+          {
+          rule = lg->GetRelativeTargetDirectory(gtarget);
+          rule += "/rule";
+          }
         commands.push_back(lg->GetRecursiveMakeCall
-                            (tmp.c_str(),name));
+                            (tmp.c_str(),rule));
         depends.clear();
         depends.push_back("cmake_check_build_system");
         lg->WriteMakeRule(ruleFileStream,
@@ -740,6 +785,7 @@ cmGlobalUnixMakefileGenerator3
       makefileName += "/build.make";
 
       bool needRequiresStep = this->NeedRequiresStep(gtarget);
+      bool flat = this->IsFlatTarget(gtarget);
 
       lg->WriteDivider(ruleFileStream);
       ruleFileStream
@@ -747,10 +793,17 @@ cmGlobalUnixMakefileGenerator3
         << localName << "\n\n";
 
       commands.clear();
-      makeTargetName = localName;
-      makeTargetName += "/depend";
-      commands.push_back(lg->GetRecursiveMakeCall
-                         (makefileName.c_str(),makeTargetName));
+      if (flat)
+        {
+        // The target's rules are included above.
+        }
+      else if (this->NeedDependStep(gtarget))
+        {
+        makeTargetName = localName;
+        makeTargetName += "/depend";
+        commands.push_back(lg->GetRecursiveMakeCall
+                           (makefileName.c_str(),makeTargetName));
+        }
 
       // add requires if we need it for this generator
       if (needRequiresStep)
@@ -762,8 +815,11 @@ cmGlobalUnixMakefileGenerator3
         }
       makeTargetName = localName;
       makeTargetName += "/build";
-      commands.push_back(lg->GetRecursiveMakeCall
-                         (makefileName.c_str(),makeTargetName));
+      if (!flat)
+        {
+        commands.push_back(lg->GetRecursiveMakeCall
+                           (makefileName.c_str(),makeTargetName));
+        }
 
       // Write the rule.
       localName += "/all";
@@ -801,8 +857,16 @@ cmGlobalUnixMakefileGenerator3
         }
 
       this->AppendGlobalTargetDepends(depends, gtarget);
+      if (flat)
+        {
+        depends.push_back(makeTargetName);
+        }
       lg->WriteMakeRule(ruleFileStream, "All Build rule for target.",
                         localName, depends, commands, true);
+      if (flat)
+        {
+        this->WriteFlatTargetRules(ruleFileStream, lg, gtarget);
+        }
 
       // add the all/all dependency
       if(!this->IsExcluded(this->LocalGenerators[0], gtarget))
@@ -853,11 +917,14 @@ cmGlobalUnixMakefileGenerator3
                         localName, depends, commands, true);
 
       // Add a target with the canonical name (no prefix, suffix or path).
-      commands.clear();
-      depends.clear();
-      depends.push_back(localName);
-      lg->WriteMakeRule(ruleFileStream, "Convenience name for target.",
-                        name, depends, commands, true);
+      if(!this->FlatMakefiles)
+        {
+        commands.clear();
+        depends.clear();
+        depends.push_back(localName);
+        lg->WriteMakeRule(ruleFileStream, "Convenience name for target.",
+                          name, depends, commands, true);
+        }
 
       // Add rules to prepare the target for installation.
       if(gtarget
@@ -867,11 +934,14 @@ cmGlobalUnixMakefileGenerator3
         localName += "/preinstall";
         depends.clear();
         commands.clear();
-        commands.push_back(lg->GetRecursiveMakeCall
-                            (makefileName.c_str(), localName));
-        lg->WriteMakeRule(ruleFileStream,
-                          "Pre-install relink rule for target.",
-                          localName, depends, commands, true);
+        if (!flat)
+          {
+          commands.push_back(lg->GetRecursiveMakeCall
+                              (makefileName.c_str(), localName));
+          lg->WriteMakeRule(ruleFileStream,
+                            "Pre-install relink rule for target.",
+                            localName, depends, commands, true);
+          }
 
         if(!this->IsExcluded(this->LocalGenerators[0], gtarget))
           {
@@ -889,10 +959,13 @@ cmGlobalUnixMakefileGenerator3
       makeTargetName += "/clean";
       depends.clear();
       commands.clear();
-      commands.push_back(lg->GetRecursiveMakeCall
-                          (makefileName.c_str(), makeTargetName));
-      lg->WriteMakeRule(ruleFileStream, "clean rule for target.",
-                        makeTargetName, depends, commands, true);
+      if (!flat)
+        {
+        commands.push_back(lg->GetRecursiveMakeCall
+                            (makefileName.c_str(), makeTargetName));
+        lg->WriteMakeRule(ruleFileStream, "clean rule for target.",
+                          makeTargetName, depends, commands, true);
+        }
       commands.clear();
       depends.push_back(makeTargetName);
       lg->WriteMakeRule(ruleFileStream, "clean rule for target.",
@@ -1002,6 +1075,226 @@ cmGlobalUnixMakefileGenerator3::RecordTargetProgress(
   TargetProgress& tp = this->ProgressMap[tg->GetGeneratorTarget()];
   tp.NumberOfActions = tg->GetNumberOfProgressActions();
   tp.VariableFile = tg->GetProgressFileNameFull();
+  tp.VariablePrefix = this->GetMakeVariablePrefix(tg->GetGeneratorTarget());
+}
+
+//----------------------------------------------------------------------------
+std::string const&
+cmGlobalUnixMakefileGenerator3
+::GetMakeVariablePrefix(cmGeneratorTarget const* gt)
+{
+  std::map<cmGeneratorTarget const*, std::string,
+           cmGeneratorTarget::StrictTargetComparison>::iterator i =
+    this->MakeVariablePrefixes.find(gt);
+  if(i != this->MakeVariablePrefixes.end())
+    {
+    return i->second;
+    }
+
+  // The flat Makefile2 includes every build.make file, so variables
+  // like C_FLAGS must be unique to each target there.
+  std::string prefix;
+  if(this->FlatMakefiles)
+    {
+    std::string base = cmSystemTools::MakeCidentifier(gt->GetName());
+    prefix = base + "_";
+    for(int n = 2; !this->UsedMakeVariablePrefixes.insert(prefix).second;
+        ++n)
+      {
+      std::ostringstream e;
+      e << base << "_" << n << "_";
+      prefix = e.str();
+      }
+    }
+  return this->MakeVariablePrefixes[gt] = prefix;
+}
+
+//----------------------------------------------------------------------------
+bool
+cmGlobalUnixMakefileGenerator3
+::NeedDependStep(cmGeneratorTarget const* gt) const
+{
+  DependInfoMapType::const_iterator i = this->DependInfoMap.find(gt);
+  return i == this->DependInfoMap.end() || i->second.NeedDependStep;
+}
+
+//----------------------------------------------------------------------------
+bool
+cmGlobalUnixMakefileGenerator3
+::IsFlatTarget(cmGeneratorTarget const* gt) const
+{
+  return this->FlatTargets.count(gt) > 0;
+}
+
+//----------------------------------------------------------------------------
+void cmGlobalUnixMakefileGenerator3::ComputeFlatTargets()
+{
+  this->FlatTargets.clear();
+  if(!this->FlatMakefiles)
+    {
+    return;
+    }
+
+  // Targets whose dependencies must be scanned before their rules are
+  // read still build recursively.
+  std::map<std::string, int> outputCount;
+  for (unsigned int i = 0; i < this->LocalGenerators.size(); ++i)
+    {
+    std::vector<cmGeneratorTarget*> targets =
+      this->LocalGenerators[i]->GetGeneratorTargets();
+    for(std::vector<cmGeneratorTarget*>::const_iterator t = targets.begin();
+        t != targets.end(); ++t)
+      {
+      DependInfoMapType::const_iterator di = this->DependInfoMap.find(*t);
+      if(di == this->DependInfoMap.end())
+        {
+        continue;
+        }
+      std::vector<std::string> const& outputs = di->second.CustomOutputs;
+      for(std::vector<std::string>::const_iterator o = outputs.begin();
+          o != outputs.end(); ++o)
+        {
+        ++outputCount[*o];
+        }
+      std::vector<std::pair<std::string, std::string> > const& byproducts =
+        di->second.Byproducts;
+      for(std::vector<std::pair<std::string, std::string> >::const_iterator
+            b = byproducts.begin(); b != byproducts.end(); ++b)
+        {
+        ++outputCount[b->first];
+        }
+      int type = (*t)->GetType();
+      if((type == cmState::EXECUTABLE ||
+          type == cmState::STATIC_LIBRARY ||
+          type == cmState::SHARED_LIBRARY ||
+          type == cmState::MODULE_LIBRARY ||
+          type == cmState::OBJECT_LIBRARY ||
+          type == cmState::UTILITY) &&
+         !di->second.NeedDependScan && !this->NeedRequiresStep(*t))
+        {
+        this->FlatTargets.insert(*t);
+        }
+      }
+    }
+
+  // One makefile can hold only one rule for a file, so targets sharing
+  // custom command outputs keep their own build.make files.  Targets
+  // that use files of a recursively built dependency cannot see the
+  // rules for them and build recursively too.
+  bool changed = true;
+  while(changed)
+    {
+    changed = false;
+    FlatTargetSet flat = this->FlatTargets;
+    for(FlatTargetSet::const_iterator t = flat.begin(); t != flat.end(); ++t)
+      {
+      bool keep = true;
+      TargetDependInfo const& info = this->DependInfoMap[*t];
+      for(std::vector<std::string>::const_iterator
+            o = info.CustomOutputs.begin();
+          keep && o != info.CustomOutputs.end(); ++o)
+        {
+        keep = outputCount[*o] == 1;
+        }
+      for(std::vector<std::pair<std::string, std::string> >::const_iterator
+            b = info.Byproducts.begin();
+          keep && b != info.Byproducts.end(); ++b)
+        {
+        keep = outputCount[b->first] == 1;
+        }
+      TargetDependSet const& depends = this->GetTargetDirectDepends(*t);
+      for(TargetDependSet::const_iterator d = depends.begin();
+          keep && d != depends.end(); ++d)
+        {
+        cmGeneratorTarget const* dep = *d;
+        int type = dep->GetType();
+        keep = (type == cmState::INTERFACE_LIBRARY ||
+                type == cmState::GLOBAL_TARGET ||
+                this->FlatTargets.count(dep) > 0);
+        }
+      if(!keep)
+        {
+        this->FlatTargets.erase(*t);
+        changed = true;
+        }
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void
+cmGlobalUnixMakefileGenerator3
+::WriteFlatTargetRules(std::ostream& ruleFileStream,
+                       cmLocalUnixMakefileGenerator3* lg,
+                       cmGeneratorTarget const* gt)
+{
+  std::string prepare =
+    lg->GetRelativeTargetDirectory(const_cast<cmGeneratorTarget*>(gt));
+  prepare += "/prepare";
+
+  // Everything the rules of this target may use from its dependencies.
+  // Of a library built by this makefile that is only its custom command
+  // outputs, so its objects may compile in parallel with ours.  Link
+  // rules already depend on the library files they need.
+  std::vector<std::string> depends;
+  TargetDependSet const& depends_set = this->GetTargetDirectDepends(gt);
+  for(TargetDependSet::const_iterator i = depends_set.begin();
+      i != depends_set.end(); ++i)
+    {
+    cmGeneratorTarget const* dep = *i;
+    int type = dep->GetType();
+    if (type == cmState::INTERFACE_LIBRARY)
+      {
+      continue;
+      }
+    cmLocalUnixMakefileGenerator3* lg3 =
+      static_cast<cmLocalUnixMakefileGenerator3*>(dep->GetLocalGenerator());
+    std::string depName =
+      lg3->GetRelativeTargetDirectory(const_cast<cmGeneratorTarget*>(dep));
+    if(this->IsFlatTarget(dep) &&
+       (type == cmState::STATIC_LIBRARY ||
+        type == cmState::SHARED_LIBRARY ||
+        type == cmState::MODULE_LIBRARY ||
+        type == cmState::OBJECT_LIBRARY))
+      {
+      depends.push_back(depName + "/prepare");
+      std::vector<std::string> const& outputs =
+        this->DependInfoMap[dep].CustomOutputs;
+      depends.insert(depends.end(), outputs.begin(), outputs.end());
+      }
+    else
+      {
+      depends.push_back(depName + "/all");
+      }
+    }
+  std::vector<std::string> no_commands;
+  lg->WriteMakeRule(ruleFileStream,
+                    "Dependencies used by the rules of this target.",
+                    prepare, depends, no_commands, true);
+
+  // Order the rules of this target after its dependencies, and its
+  // objects after its own custom commands.
+  TargetDependInfo const& info = this->DependInfoMap[gt];
+  std::vector<std::string> rules = info.Objects;
+  rules.insert(rules.end(),
+               info.CustomOutputs.begin(), info.CustomOutputs.end());
+  lg->WriteOrderOnlyRule(ruleFileStream, rules,
+                         std::vector<std::string>(1, prepare));
+  lg->WriteOrderOnlyRule(ruleFileStream, info.Objects, info.CustomOutputs);
+
+  // Give byproducts a rule so that other targets may depend on them.
+  std::vector<std::string> files = info.CustomOutputs;
+  for(std::vector<std::pair<std::string, std::string> >::const_iterator
+        b = info.Byproducts.begin(); b != info.Byproducts.end(); ++b)
+    {
+    lg->WriteAliasRule(ruleFileStream, b->first, b->second);
+    files.push_back(b->first);
+    }
+
+  // Compiler-written depfiles name generated files by full path.  Tie
+  // that name to our rule so objects rebuild in the same run.
+  lg->WriteFullPathAliasRules(ruleFileStream, files);
+  ruleFileStream << "\n";
 }
 
 //----------------------------------------------------------------------------
@@ -1012,7 +1305,7 @@ cmGlobalUnixMakefileGenerator3::TargetProgress
   cmGeneratedFileStream fout(this->VariableFile.c_str());
   for(unsigned long i = 1; i <= this->NumberOfActions; ++i)
     {
-    fout << "CMAKE_PROGRESS_" << i << " = ";
+    fout << this->VariablePrefix << "CMAKE_PROGRESS_" << i << " = ";
     if (total <= 100)
       {
       unsigned long num = i + current;
@@ -1126,7 +1419,7 @@ void cmGlobalUnixMakefileGenerator3::WriteHelpRule
 
 
 bool cmGlobalUnixMakefileGenerator3
-::NeedRequiresStep(const cmGeneratorTarget* target)
+::NeedRequiresStep(const cmGeneratorTarget* target) const
 {
   std::set<std::string> languages;
   target->GetLanguages(languages,
@@ -136,6 +136,37 @@ public:
   /** Does the make tool tolerate .DELETE_ON_ERROR? */
   virtual bool AllowDeleteOnError() const { return true; }
 
+  /** Does the make tool support optional includes of compiler depfiles? */
+  virtual bool SupportsCompilerDependencies() const { return true; }
+
+  /** Does the make tool support the rules of a flat build graph? */
+  virtual bool SupportsFlatMakefiles() const
+    { return this->SupportsCompilerDependencies(); }
+
+  /** Whether all targets are built from one non-recursive makefile.  */
+  bool GetFlatMakefiles() const { return this->FlatMakefiles; }
+
+  /** Get a prefix making per-target variable names globally unique.  */
+  std::string const& GetMakeVariablePrefix(cmGeneratorTarget const* gt);
+
+  /** Dependency step information recorded for each target.  */
+  struct TargetDependInfo
+  {
+    TargetDependInfo(): NeedDependScan(true), NeedDependStep(true) {}
+    // Whether cmake_depends must scan sources of the target.
+    bool NeedDependScan;
+    // Whether "make <target>/depend" has anything to do.
+    bool NeedDependStep;
+    // Object and custom command output rule names relative to the top
+    // of the build tree.
+    std::vector<std::string> Objects;
+    std::vector<std::string> CustomOutputs;
+    // Byproducts of custom commands and the rule producing each one.
+    std::vector<std::pair<std::string, std::string> > Byproducts;
+  };
+  TargetDependInfo& GetTargetDependInfo(cmGeneratorTarget const* gt)
+    { return this->DependInfoMap[gt]; }
+
   virtual void ComputeTargetObjectDirectory(cmGeneratorTarget* gt) const;
 
   std::string IncludeDirective;
@@ -160,7 +191,17 @@ protected:
                                  cmGeneratorTarget* target);
 
   // does this generator need a requires step for any of its targets
-  bool NeedRequiresStep(cmGeneratorTarget const*);
+  bool NeedRequiresStep(cmGeneratorTarget const*) const;
+
+  // does the target have anything to do in its depend step
+  bool NeedDependStep(cmGeneratorTarget const* gt) const;
+
+  // is the target built from the flat Makefile2 rather than recursively
+  bool IsFlatTarget(cmGeneratorTarget const* gt) const;
+  void ComputeFlatTargets();
+  void WriteFlatTargetRules(std::ostream& ruleFileStream,
+                            cmLocalUnixMakefileGenerator3* lg,
+                            cmGeneratorTarget const* gt);
 
   // Target name hooks for superclass.
   const char* GetAllTargetName()           const { return "all"; }
@@ -195,6 +236,7 @@ protected:
     TargetProgress(): NumberOfActions(0) {}
     unsigned long NumberOfActions;
     std::string VariableFile;
+    std::string VariablePrefix;
     std::vector<unsigned long> Marks;
     void WriteProgressVariables(unsigned long total, unsigned long& current);
   };
@@ -202,6 +244,19 @@ protected:
                    cmGeneratorTarget::StrictTargetComparison> ProgressMapType;
   ProgressMapType ProgressMap;
 
+  typedef std::map<cmGeneratorTarget const*, TargetDependInfo,
+                   cmGeneratorTarget::StrictTargetComparison> DependInfoMapType;
+  DependInfoMapType DependInfoMap;
+
+  // Non-recursive build mode and its per-target variable prefixes.
+  bool FlatMakefiles;
+  typedef std::set<cmGeneratorTarget const*,
+                   cmGeneratorTarget::StrictTargetComparison> FlatTargetSet;
+  FlatTargetSet FlatTargets;
+  std::map<cmGeneratorTarget const*, std::string,
+           cmGeneratorTarget::StrictTargetComparison> MakeVariablePrefixes;
+  std::set<std::string> UsedMakeVariablePrefixes;
+
   size_t CountProgressMarksInTarget(cmGeneratorTarget const* target,
                                  std::set<cmGeneratorTarget const*>& emitted);
   size_t CountProgressMarksInAll(cmLocalGenerator* lg);
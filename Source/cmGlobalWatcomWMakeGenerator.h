@@ -43,6 +43,7 @@ public:
 
   virtual bool AllowNotParallel() const { return false; }
   virtual bool AllowDeleteOnError() const { return false; }
+  virtual bool SupportsCompilerDependencies() const { return false; }
 };
 
 #endif
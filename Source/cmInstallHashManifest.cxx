@@ -0,0 +1,104 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmInstallHashManifest.h"
+
+#include "cmSystemTools.h"
+
+#include <cmsys/FStream.hxx>
+
+//----------------------------------------------------------------------------
+cmInstallHashManifest::cmInstallHashManifest():
+  Loaded(false), Compact(true)
+{
+}
+
+//----------------------------------------------------------------------------
+void cmInstallHashManifest::Load(std::string const& file)
+{
+  if(this->Loaded)
+    {
+    return;
+    }
+  this->Loaded = true;
+  this->File = file;
+  cmsys::ifstream fin(this->File.c_str());
+  if(!fin)
+    {
+    return;
+    }
+
+  // Each line holds a hash and a destination.  New entries are
+  // appended, so a later line replaces an earlier one.
+  std::string line;
+  size_t lines = 0;
+  while(cmSystemTools::GetLineFromStream(fin, line))
+    {
+    std::string::size_type pos = line.find(' ');
+    if(pos != std::string::npos && pos > 0)
+      {
+      this->Hashes[line.substr(pos+1)] = line.substr(0, pos);
+      ++lines;
+      }
+    }
+  this->Compact = lines <= 2 * this->Hashes.size() + 16;
+}
+
+//----------------------------------------------------------------------------
+std::string const*
+cmInstallHashManifest::Find(std::string const& dest) const
+{
+  std::map<std::string, std::string>::const_iterator h =
+    this->Hashes.find(dest);
+  return h != this->Hashes.end()? &h->second : 0;
+}
+
+//----------------------------------------------------------------------------
+void cmInstallHashManifest::Add(std::string const& dest,
+                                std::string const& hash)
+{
+  this->Hashes[dest] = hash;
+  this->NewHashes.push_back(hash + " " + dest);
+}
+
+//----------------------------------------------------------------------------
+bool cmInstallHashManifest::Save()
+{
+  if(this->NewHashes.empty())
+    {
+    return true;
+    }
+
+  // Append the new entries, or rewrite the file once most of its lines
+  // have been replaced.
+  cmsys::ofstream fout(this->File.c_str(),
+                       this->Compact? std::ios::app : std::ios::out);
+  if(this->Compact)
+    {
+    for(std::vector<std::string>::const_iterator i = this->NewHashes.begin();
+        i != this->NewHashes.end(); ++i)
+      {
+      fout << *i << "\n";
+      }
+    }
+  else
+    {
+    for(std::map<std::string, std::string>::const_iterator
+          i = this->Hashes.begin(); i != this->Hashes.end(); ++i)
+      {
+      fout << i->second << " " << i->first << "\n";
+      }
+    }
+  fout.close();
+  this->NewHashes.clear();
+  this->Compact = true;
+  return fout? true : false;
+}
@@ -0,0 +1,52 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmInstallHashManifest_h
+#define cmInstallHashManifest_h
+
+#include "cmStandardIncludes.h"
+
+/** \class cmInstallHashManifest
+ * \brief Content hashes of installed files, by destination.
+ *
+ * The manifest file is read the first time file(INSTALL) needs it and
+ * kept for the rest of the process.  Entries added by later calls are
+ * written back once by Save.
+ */
+class cmInstallHashManifest
+{
+public:
+  cmInstallHashManifest();
+
+  /** Read the manifest file unless it has been read already.  */
+  void Load(std::string const& file);
+
+  /** Get the hash recorded for a destination, or 0 if there is none.  */
+  std::string const* Find(std::string const& dest) const;
+
+  /** Record the hash of the source installed to a destination.  */
+  void Add(std::string const& dest, std::string const& hash);
+
+  /** Write the entries added since the file was read.  */
+  bool Save();
+
+  std::string const& GetFile() const { return this->File; }
+
+private:
+  std::string File;
+  bool Loaded;
+  // Whether the file has few enough stale lines to append to it.
+  bool Compact;
+  std::map<std::string, std::string> Hashes;
+  std::vector<std::string> NewHashes;
+};
+
+#endif
@@ -462,8 +462,27 @@ cmInstallTargetGenerator
   std::string tws = tw.str();
   if(!tws.empty())
     {
-    os << indent << "if(EXISTS \"" << file << "\" AND\n"
-       << indent << "   NOT IS_SYMLINK \"" << file << "\")\n";
+    // Files left untouched by a content-hash install were tweaked
+    // when they were installed.
+    bool skipUnchanged =
+      tweak == &cmInstallTargetGenerator::PostReplacementTweaks &&
+      this->Target->Target->GetMakefile()
+        ->IsOn("CMAKE_INSTALL_HASH_MANIFEST");
+    if(skipUnchanged)
+      {
+      os << indent << "list(FIND CMAKE_INSTALL_UNCHANGED_FILES \""
+         << file << "\" _cmake_unchanged)\n";
+      }
+    os << indent << "if(EXISTS \"" << file << "\" AND\n";
+    if(skipUnchanged)
+      {
+      os << indent << "   NOT IS_SYMLINK \"" << file << "\" AND\n"
+         << indent << "   _cmake_unchanged EQUAL -1)\n";
+      }
+    else
+      {
+      os << indent << "   NOT IS_SYMLINK \"" << file << "\")\n";
+      }
     os << tws;
     os << indent << "endif()\n";
     }
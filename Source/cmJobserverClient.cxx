@@ -0,0 +1,257 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmJobserverClient.h"
+
+#include "cmSystemTools.h"
+#include "cmAlgorithms.h"
+
+#if !defined(_WIN32) || defined(__CYGWIN__)
+# include <errno.h>
+# include <fcntl.h>
+# include <poll.h>
+# include <stdio.h>
+# include <unistd.h>
+# include <sys/stat.h>
+# define CM_JOBSERVER_POSIX
+#endif
+
+#if defined(CM_JOBSERVER_POSIX)
+//----------------------------------------------------------------------------
+// Whether a descriptor is open and refers to a pipe or fifo.  Make may
+// have closed the jobserver descriptors for this process, and the
+// numbers may since have been reused for unrelated files.
+static bool cmJobserverIsFifo(int fd)
+{
+  struct stat st;
+  return fstat(fd, &st) == 0 && S_ISFIFO(st.st_mode);
+}
+#endif
+
+//----------------------------------------------------------------------------
+cmJobserverClient::cmJobserverClient()
+  : ReadFD(-1), WriteFD(-1), OwnReadFD(false), OwnWriteFD(false)
+{
+}
+
+//----------------------------------------------------------------------------
+cmJobserverClient::~cmJobserverClient()
+{
+  this->ReleaseAll();
+  this->Disconnect();
+}
+
+//----------------------------------------------------------------------------
+bool cmJobserverClient::Connect()
+{
+  if(this->IsConnected())
+    {
+    return true;
+    }
+#if defined(CM_JOBSERVER_POSIX)
+  const char* makeflags = cmSystemTools::GetEnv("MAKEFLAGS");
+  if(!makeflags)
+    {
+    return false;
+    }
+
+  // Newer make versions spell the option "--jobserver-auth" and older
+  // ones "--jobserver-fds".  The last occurrence wins.
+  std::string auth;
+  std::istringstream words(makeflags);
+  std::string word;
+  while(words >> word)
+    {
+    if(cmHasLiteralPrefix(word, "--jobserver-auth="))
+      {
+      auth = word.substr(17);
+      }
+    else if(cmHasLiteralPrefix(word, "--jobserver-fds="))
+      {
+      auth = word.substr(16);
+      }
+    }
+  if(auth.empty())
+    {
+    return false;
+    }
+
+  if(cmHasLiteralPrefix(auth, "fifo:"))
+    {
+    std::string path = auth.substr(5);
+    int fd = open(path.c_str(), O_RDWR | O_NONBLOCK);
+    if(fd < 0)
+      {
+      return false;
+      }
+    if(!cmJobserverIsFifo(fd))
+      {
+      close(fd);
+      return false;
+      }
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+    this->ReadFD = fd;
+    this->WriteFD = fd;
+    this->OwnReadFD = true;
+    return true;
+    }
+
+  // The pipe descriptors are only usable if the parent make passed
+  // them down, which it does only for recursive make rules.
+  int rfd = -1;
+  int wfd = -1;
+  if(sscanf(auth.c_str(), "%d,%d", &rfd, &wfd) != 2 ||
+     rfd < 0 || wfd < 0 ||
+     !cmJobserverIsFifo(rfd) || !cmJobserverIsFifo(wfd))
+    {
+    return false;
+    }
+
+  // Open the read end again to get a non-blocking file description of
+  // our own.  Changing the flags of the inherited description would
+  // affect make and every other client, and a blocking read could wait
+  // for as long as other jobs keep their tokens.  Without /proc there
+  // is no such description, so do not use the jobserver at all.
+  char path[64];
+  sprintf(path, "/proc/self/fd/%d", rfd);
+  int fd = open(path, O_RDONLY | O_NONBLOCK);
+  if(fd < 0)
+    {
+    return false;
+    }
+  fcntl(fd, F_SETFD, FD_CLOEXEC);
+  this->ReadFD = fd;
+  this->OwnReadFD = true;
+  this->WriteFD = wfd;
+  this->OwnWriteFD = false;
+  return true;
+#else
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmJobserverClient::Disconnect()
+{
+#if defined(CM_JOBSERVER_POSIX)
+  if(this->OwnReadFD && this->ReadFD >= 0)
+    {
+    close(this->ReadFD);
+    }
+  if(this->OwnWriteFD && this->WriteFD >= 0 &&
+     this->WriteFD != this->ReadFD)
+    {
+    close(this->WriteFD);
+    }
+#endif
+  this->ReadFD = -1;
+  this->WriteFD = -1;
+  this->OwnReadFD = false;
+  this->OwnWriteFD = false;
+}
+
+//----------------------------------------------------------------------------
+bool cmJobserverClient::ReadToken()
+{
+#if defined(CM_JOBSERVER_POSIX)
+  for(;;)
+    {
+    char token;
+    ssize_t n = read(this->ReadFD, &token, 1);
+    if(n == 1)
+      {
+      this->Tokens += token;
+      return true;
+      }
+    if(n < 0 && errno == EINTR)
+      {
+      continue;
+      }
+    return false;
+    }
+#else
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool cmJobserverClient::TryAcquire()
+{
+  // The read descriptor is non-blocking, so this never waits.
+  return this->IsConnected() && this->ReadToken();
+}
+
+//----------------------------------------------------------------------------
+bool cmJobserverClient::Acquire(double timeout)
+{
+  if(!this->IsConnected())
+    {
+    return false;
+    }
+#if defined(CM_JOBSERVER_POSIX)
+  double deadline = cmSystemTools::GetTime() + timeout;
+  for(;;)
+    {
+    if(this->TryAcquire())
+      {
+      return true;
+      }
+    int ms = -1;
+    if(timeout >= 0)
+      {
+      double remaining = deadline - cmSystemTools::GetTime();
+      if(remaining <= 0)
+        {
+        return false;
+        }
+      ms = static_cast<int>(remaining * 1000) + 1;
+      }
+    struct pollfd pfd;
+    pfd.fd = this->ReadFD;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if(poll(&pfd, 1, ms) < 0 && errno != EINTR)
+      {
+      return false;
+      }
+    }
+#else
+  (void)timeout;
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmJobserverClient::Release()
+{
+  if(this->Tokens.empty())
+    {
+    return;
+    }
+  char token = this->Tokens[this->Tokens.size() - 1];
+  this->Tokens.resize(this->Tokens.size() - 1);
+#if defined(CM_JOBSERVER_POSIX)
+  while(write(this->WriteFD, &token, 1) < 0 && errno == EINTR)
+    {
+    }
+#else
+  (void)token;
+#endif
+}
+
+//----------------------------------------------------------------------------
+void cmJobserverClient::ReleaseAll()
+{
+  while(!this->Tokens.empty())
+    {
+    this->Release();
+    }
+}
@@ -0,0 +1,83 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmJobserverClient_h
+#define cmJobserverClient_h
+
+#include "cmStandardIncludes.h"
+
+#if !defined(CMAKE_BUILD_WITH_CMAKE)
+# error "cmJobserverClient not allowed during bootstrap build!"
+#endif
+
+/** \class cmJobserverClient
+ * \brief Take job slots from a GNU make jobserver.
+ *
+ * A process started by GNU make with "-j" inherits one implicit job
+ * slot.  When make advertises a jobserver in MAKEFLAGS, every further
+ * concurrent job must first read a token from the jobserver and write
+ * it back when done.  This class implements that client protocol for
+ * both the pipe ("--jobserver-auth=R,W" or "--jobserver-fds=R,W") and
+ * the named fifo ("--jobserver-auth=fifo:PATH") forms.  Tokens still
+ * held when the client is destroyed are returned to the jobserver.
+ */
+class cmJobserverClient
+{
+public:
+  cmJobserverClient();
+  ~cmJobserverClient();
+
+  /**
+   * Connect to the jobserver advertised in the MAKEFLAGS environment
+   * variable.  Returns false if there is none, if the parent make did
+   * not pass its descriptors to this process, or if the pipe cannot be
+   * read without blocking (it must be opened again through /proc).
+   */
+  bool Connect();
+
+  /** Return whether Connect() found a usable jobserver.  */
+  bool IsConnected() const { return this->ReadFD >= 0; }
+
+  /** Take one token if one is available right now.  */
+  bool TryAcquire();
+
+  /**
+   * Wait up to the given number of seconds for a token.  A negative
+   * timeout waits without limit.
+   */
+  bool Acquire(double timeout);
+
+  /** Return one held token to the jobserver.  */
+  void Release();
+
+  /** Return every held token to the jobserver.  */
+  void ReleaseAll();
+
+  /** Number of tokens held in addition to the implicit job slot.  */
+  unsigned int GetNumberOfTokens() const
+    { return static_cast<unsigned int>(this->Tokens.size()); }
+
+private:
+  cmJobserverClient(cmJobserverClient const&);
+  cmJobserverClient& operator=(cmJobserverClient const&);
+
+  bool ReadToken();
+  void Disconnect();
+
+  int ReadFD;
+  int WriteFD;
+  bool OwnReadFD;
+  bool OwnWriteFD;
+  // The token bytes must be written back exactly as they were read.
+  std::string Tokens;
+};
+
+#endif
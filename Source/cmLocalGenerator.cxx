@@ -398,6 +398,17 @@ void cmLocalGenerator::GenerateInstallRules()
       "\n";
     }
 
+  if(this->Makefile->IsOn("CMAKE_INSTALL_HASH_MANIFEST"))
+    {
+    fout <<
+      "# Skip installing files whose content has not changed?\n"
+      "if(NOT DEFINED CMAKE_INSTALL_HASH_MANIFEST_FILE)\n"
+      "  set(CMAKE_INSTALL_HASH_MANIFEST_FILE \"" << homedir
+                                              << "/install_hashes.txt\")\n"
+      "endif()\n"
+      "\n";
+    }
+
   // Ask each install generator to write its code.
   std::vector<cmInstallGenerator*> const& installers =
     this->Makefile->GetInstallGenerators();
@@ -668,6 +668,62 @@ cmLocalUnixMakefileGenerator3
     }
 }
 
+//----------------------------------------------------------------------------
+void
+cmLocalUnixMakefileGenerator3
+::WriteOrderOnlyRule(std::ostream& os,
+                     const std::vector<std::string>& targets,
+                     const std::vector<std::string>& depends)
+{
+  if(depends.empty())
+    {
+    return;
+    }
+  std::ostringstream deps;
+  for(std::vector<std::string>::const_iterator dep = depends.begin();
+      dep != depends.end(); ++dep)
+    {
+    deps << " " << cmMakeSafe(this->Convert(*dep, HOME_OUTPUT, MAKERULE));
+    }
+  std::string const depsStr = deps.str();
+  for(std::vector<std::string>::const_iterator tgt = targets.begin();
+      tgt != targets.end(); ++tgt)
+    {
+    os << cmMakeSafe(this->Convert(*tgt, HOME_OUTPUT, MAKERULE))
+       << " : |" << depsStr << "\n";
+    }
+}
+
+//----------------------------------------------------------------------------
+void
+cmLocalUnixMakefileGenerator3
+::WriteFullPathAliasRules(std::ostream& os,
+                          const std::vector<std::string>& files)
+{
+  for(std::vector<std::string>::const_iterator f = files.begin();
+      f != files.end(); ++f)
+    {
+    std::string full = this->Convert(*f, FULL, MAKERULE);
+    std::string rel = this->Convert(*f, HOME_OUTPUT, MAKERULE);
+    if(full != rel)
+      {
+      os << cmMakeSafe(full) << " : " << cmMakeSafe(rel) << " ;\n";
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void
+cmLocalUnixMakefileGenerator3
+::WriteAliasRule(std::ostream& os, const std::string& target,
+                 const std::string& depend)
+{
+  // The empty recipe makes parallel make look at the file again after
+  // the rule it depends on has run.
+  os << cmMakeSafe(this->Convert(target, HOME_OUTPUT, MAKERULE)) << " : "
+     << cmMakeSafe(this->Convert(depend, HOME_OUTPUT, MAKERULE)) << " ;\n";
+}
+
 //----------------------------------------------------------------------------
 std::string
 cmLocalUnixMakefileGenerator3
@@ -731,6 +787,15 @@ cmLocalUnixMakefileGenerator3
     << this->ConvertShellCommand(cmSystemTools::GetCMakeCommand(), FULL)
     << "\n"
     << "\n";
+  if(!cmSystemTools::GetCMEchoCommand().empty())
+    {
+    makefileStream
+      << "# The command to print rule messages.\n"
+      << "CMAKE_ECHO_COMMAND = "
+      << this->ConvertShellCommand(cmSystemTools::GetCMEchoCommand(), FULL)
+      << "\n"
+      << "\n";
+    }
   makefileStream
     << "# The command to remove a file.\n"
     << "RM = "
@@ -1167,6 +1232,19 @@ cmLocalUnixMakefileGenerator3
   // Setup the proper working directory for the commands.
   this->CreateCDCommand(commands1, dir.c_str(), relative);
 
+  // Mark the commands as recursive make invocations so that make
+  // passes its jobserver to them.  Only GNU-compatible make tools
+  // understand the "+" recipe prefix.
+  if(ccg.GetCC().GetJobserverAware() && !this->IsNMake() &&
+     !this->IsWatcomWMake() && !this->BorlandMakeCurlyHack)
+    {
+    for(std::vector<std::string>::iterator i = commands1.begin();
+        i != commands1.end(); ++i)
+      {
+      *i = "+" + *i;
+      }
+    }
+
   // push back the custom commands
   commands.insert(commands.end(), commands1.begin(), commands1.end());
 }
@@ -1272,7 +1350,7 @@ cmLocalUnixMakefileGenerator3::AppendEcho(std::vector<std::string>& commands,
   std::string color_name;
   if(this->GlobalGenerator->GetToolSupportsColor() && this->ColorMakefile)
     {
-    // See cmake::ExecuteEchoColor in cmake.cxx for these options.
+    // See cmEchoColor::Execute in cmEchoColor.cxx for these options.
     // This color set is readable on both black and white backgrounds.
     switch(color)
       {
@@ -1316,8 +1394,17 @@ cmLocalUnixMakefileGenerator3::AppendEcho(std::vector<std::string>& commands,
           }
         else
           {
-          // Use cmake to echo the text in color.
-          cmd = "@$(CMAKE_COMMAND) -E cmake_echo_color --switch=$(COLOR) ";
+          // Use cmake to echo the text in color.  Prefer the cmecho
+          // helper which takes the same options but starts faster.
+          if(cmSystemTools::GetCMEchoCommand().empty())
+            {
+            cmd = "@$(CMAKE_COMMAND) -E cmake_echo_color";
+            }
+          else
+            {
+            cmd = "@$(CMAKE_ECHO_COMMAND)";
+            }
+          cmd += " --switch=$(COLOR) ";
           cmd += color_name;
           if (progress)
             {
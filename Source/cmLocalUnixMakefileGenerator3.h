@@ -55,6 +55,21 @@ public:
                      bool symbolic,
                      bool in_help = false);
 
+  // Write GNU make order-only dependencies of each target on all of
+  // the given dependencies.
+  void WriteOrderOnlyRule(std::ostream& os,
+                          const std::vector<std::string>& targets,
+                          const std::vector<std::string>& depends);
+
+  // Make the full path of each build tree file depend on the relative
+  // name used by the rule that generates it.
+  void WriteFullPathAliasRules(std::ostream& os,
+                               const std::vector<std::string>& files);
+
+  // Write a rule with an empty recipe for a file made by another rule.
+  void WriteAliasRule(std::ostream& os, const std::string& target,
+                      const std::string& depend);
+
   // write the main variables used by the makefiles
   void WriteMakeVariables(std::ostream& makefileStream);
 
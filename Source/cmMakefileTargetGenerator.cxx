@@ -52,6 +52,8 @@ cmMakefileTargetGenerator::cmMakefileTargetGenerator(cmGeneratorTarget* target)
     {
     this->NoRuleMessages = cmSystemTools::IsOff(ruleStatus);
     }
+  this->MakeVariablePrefix =
+    this->GlobalGenerator->GetMakeVariablePrefix(target);
   MacOSXContentGenerator = new MacOSXContentGeneratorType(this);
 }
 
@@ -291,6 +293,13 @@ void cmMakefileTargetGenerator::WriteTargetLanguageFlags()
     compiler += "_COMPILER";
     *this->FlagFileStream << "# compile " << *l << " with " <<
       this->Makefile->GetSafeDefinition(compiler) << "\n";
+    // Objects compiled before the compiler wrote their depfiles must
+    // be rebuilt to get one, so record the mode here too.
+    if(this->UseCompilerDepends(*l))
+      {
+      *this->FlagFileStream << "# " << *l
+                            << " dependencies are written by the compiler\n";
+      }
     }
 
   for(std::set<std::string>::const_iterator l = languages.begin();
@@ -303,9 +312,10 @@ void cmMakefileTargetGenerator::WriteTargetLanguageFlags()
     cmSystemTools::ReplaceString(flags, "#", "\\#");
     cmSystemTools::ReplaceString(defines, "#", "\\#");
     cmSystemTools::ReplaceString(includes, "#", "\\#");
-    *this->FlagFileStream << *l << "_FLAGS = " << flags << "\n\n";
-    *this->FlagFileStream << *l << "_DEFINES = " << defines << "\n\n";
-    *this->FlagFileStream << *l << "_INCLUDES = " << includes << "\n\n";
+    std::string const var = this->MakeVariablePrefix + *l;
+    *this->FlagFileStream << var << "_FLAGS = " << flags << "\n\n";
+    *this->FlagFileStream << var << "_DEFINES = " << defines << "\n\n";
+    *this->FlagFileStream << var << "_INCLUDES = " << includes << "\n\n";
     }
 }
 
@@ -422,6 +432,12 @@ void cmMakefileTargetGenerator
   // generate the build rule file
   this->WriteObjectBuildFile(obj, lang, source, depends);
 
+  // The compiler writes the dependencies of this object itself.
+  if(this->UseCompilerDepends(lang))
+    {
+    return;
+    }
+
   // The object file should be checked for dependency integrity.
   std::string objFullPath = this->LocalGenerator->GetCurrentBinaryDirectory();
   objFullPath += "/";
@@ -461,6 +477,7 @@ cmMakefileTargetGenerator
 
   // Add language-specific flags.
   std::string langFlags = "$(";
+  langFlags += this->MakeVariablePrefix;
   langFlags += lang;
   langFlags += "_FLAGS)";
   this->LocalGenerator->AppendFlags(flags, langFlags);
@@ -611,7 +628,28 @@ cmMakefileTargetGenerator
   vars.ObjectFileDir = objectFileDir.c_str();
   vars.Flags = flags.c_str();
 
+  // Maybe have the compiler write the dependencies of the object to a
+  // depfile that the build rules include directly.
+  std::string compileFlags = flags;
+  std::string depFile;
+  if(this->UseCompilerDepends(lang))
+    {
+    depFile = obj + ".d";
+    std::string depFlags = this->Makefile->GetSafeDefinition(
+      "CMAKE_MAKE_DEPFILE_FLAGS_" + lang);
+    cmSystemTools::ReplaceString(depFlags, "<DEPFILE>",
+      this->Convert(depFile, cmLocalGenerator::NONE,
+                    cmLocalGenerator::SHELL));
+    cmSystemTools::ReplaceString(depFlags, "<OBJECT>",
+      this->Convert(relativeObj, cmLocalGenerator::NONE,
+                    cmLocalGenerator::SHELL));
+    this->LocalGenerator->AppendFlags(compileFlags, depFlags);
+    this->CleanFiles.push_back(depFile);
+    }
+  vars.Flags = compileFlags.c_str();
+
   std::string definesString = "$(";
+  definesString += this->MakeVariablePrefix;
   definesString += lang;
   definesString += "_DEFINES)";
 
@@ -619,7 +657,8 @@ cmMakefileTargetGenerator
 
   vars.Defines = definesString.c_str();
 
-  std::string const includesString = "$(" + lang + "_INCLUDES)";
+  std::string const includesString =
+    "$(" + this->MakeVariablePrefix + lang + "_INCLUDES)";
   vars.Includes = includesString.c_str();
 
   // At the moment, it is assumed that C, C++, and Fortran have both
@@ -652,10 +691,12 @@ cmMakefileTargetGenerator
                                     cmLocalGenerator::FULL);
     compileCommand.replace(compileCommand.find(langFlags),
                            langFlags.size(), this->GetFlags(lang));
-    std::string langDefines = std::string("$(") + lang + "_DEFINES)";
+    std::string langDefines =
+      "$(" + this->MakeVariablePrefix + lang + "_DEFINES)";
     compileCommand.replace(compileCommand.find(langDefines),
                            langDefines.size(), this->GetDefines(lang));
-    std::string langIncludes = std::string("$(") + lang + "_INCLUDES)";
+    std::string langIncludes =
+      "$(" + this->MakeVariablePrefix + lang + "_INCLUDES)";
     compileCommand.replace(compileCommand.find(langIncludes),
                            langIncludes.size(), this->GetIncludes(lang));
     this->GlobalGenerator->AddCXXCompileCommand(
@@ -739,6 +780,27 @@ cmMakefileTargetGenerator
   this->WriteMakeRule(*this->BuildFileStream, 0, outputs,
                       depends, commands);
 
+  // Include the depfile written by the compiler, if any.  It does not
+  // exist until the object has been built once.
+  if(!depFile.empty())
+    {
+    std::string depFileFull =
+      this->LocalGenerator->GetCurrentBinaryDirectory();
+    depFileFull += "/";
+    depFileFull += depFile;
+    *this->BuildFileStream
+      << "-" << this->GlobalGenerator->IncludeDirective << " "
+      << (this->Makefile->IsOn("CMAKE_MAKE_INCLUDE_FROM_ROOT")?
+          "$(CMAKE_BINARY_DIR)/" : "")
+      << this->Convert(depFileFull,
+                       cmLocalGenerator::HOME_OUTPUT,
+                       cmLocalGenerator::MAKERULE)
+      << "\n\n";
+    }
+
+  // The preprocessing and assembly rules do not write depfiles.
+  vars.Flags = flags.c_str();
+
   bool do_preprocess_rules = lang_has_preprocessor &&
     this->LocalGenerator->GetCreatePreprocessedSourceRules();
   bool do_assembly_rules = lang_has_assembly &&
@@ -1104,6 +1166,46 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
     this->LocalGenerator->GetRelativeTargetDirectory(this->GeneratorTarget);
   depTarget += "/depend";
 
+  // Tell the global generator about the rules of this target.
+  cmGlobalUnixMakefileGenerator3::TargetDependInfo& dependInfo =
+    this->GlobalGenerator->GetTargetDependInfo(this->GeneratorTarget);
+  this->DriveCustomCommands(dependInfo.CustomOutputs);
+  for(std::vector<std::string>::const_iterator o = this->Objects.begin();
+      o != this->Objects.end(); ++o)
+    {
+    dependInfo.Objects.push_back(
+      this->LocalGenerator->GetHomeRelativeOutputPath() + *o);
+    }
+
+  // When the compiler writes the dependencies of every object there is
+  // nothing left to scan.  Drop stale scanner results and skip the
+  // cmake_depends call.
+  if(this->CompilerDependsEnabled() &&
+     this->LocalGenerator->GetImplicitDepends(this->GeneratorTarget).empty()
+     && this->MultipleOutputPairs.empty())
+    {
+    std::string dependFileNameFull = this->TargetBuildDirectoryFull;
+    dependFileNameFull += "/depend.make";
+    cmGeneratedFileStream depFileStream(dependFileNameFull.c_str());
+    depFileStream.SetCopyIfDifferent(true);
+    depFileStream
+      << "# Empty dependencies file for "
+      << this->GeneratorTarget->GetName() << ".\n"
+      << "# Dependencies are written by the compiler." << std::endl;
+
+    // Make sure all custom command outputs in this target are built.
+    if(this->CustomCommandDriver == OnDepends)
+      {
+      this->DriveCustomCommands(depends);
+      }
+    dependInfo.NeedDependScan = false;
+    dependInfo.NeedDependStep = !depends.empty();
+    this->LocalGenerator->WriteMakeRule(*this->BuildFileStream, 0,
+                                        depTarget,
+                                        depends, commands, true);
+    return;
+    }
+
   // Add a command to call CMake to scan dependencies.  CMake will
   // touch the corresponding depends file after scanning dependencies.
   std::ostringstream depCmd;
@@ -1163,6 +1265,32 @@ void cmMakefileTargetGenerator::WriteTargetDependRules()
                                       depends, commands, true);
 }
 
+//----------------------------------------------------------------------------
+bool cmMakefileTargetGenerator::CompilerDependsEnabled() const
+{
+  // Only make tools that tolerate a missing include can use depfiles,
+  // which do not exist before the first build.  The flat makefile mode
+  // cannot scan before reading the rules, so it always uses them.
+  return (this->GlobalGenerator->SupportsCompilerDependencies() &&
+          (this->Makefile->IsOn("CMAKE_DEPENDS_USE_COMPILER") ||
+           this->GlobalGenerator->GetFlatMakefiles()));
+}
+
+//----------------------------------------------------------------------------
+bool
+cmMakefileTargetGenerator::UseCompilerDepends(const std::string& lang) const
+{
+  // Depfiles do not order Fortran objects by the modules they provide
+  // and require, so Fortran sources always go through the scanner.
+  if(!this->CompilerDependsEnabled() || lang == "Fortran")
+    {
+    return false;
+    }
+  std::string const flagsVar = "CMAKE_MAKE_DEPFILE_FLAGS_" + lang;
+  const char* flags = this->Makefile->GetDefinition(flagsVar);
+  return flags && *flags;
+}
+
 //----------------------------------------------------------------------------
 void
 cmMakefileTargetGenerator
@@ -1185,6 +1313,56 @@ cmMakefileTargetGenerator
     }
 }
 
+//----------------------------------------------------------------------------
+void
+cmMakefileTargetGenerator::RecordByproducts(const std::string& main_output)
+{
+  // Tell the global generator which rule produces each byproduct.  The
+  // flat makefile needs a rule for every file used by another target.
+  std::vector<std::pair<std::string, std::string> >& byproducts =
+    this->GlobalGenerator->GetTargetDependInfo(this->GeneratorTarget)
+    .Byproducts;
+  std::vector<cmCustomCommand> const* events[] =
+    {
+    &this->GeneratorTarget->GetPreBuildCommands(),
+    &this->GeneratorTarget->GetPreLinkCommands(),
+    &this->GeneratorTarget->GetPostBuildCommands()
+    };
+  for(unsigned int i = 0; i < sizeof(events) / sizeof(events[0]); ++i)
+    {
+    for(std::vector<cmCustomCommand>::const_iterator cc = events[i]->begin();
+        cc != events[i]->end(); ++cc)
+      {
+      cmCustomCommandGenerator ccg(*cc, this->ConfigName,
+                                   this->LocalGenerator);
+      std::vector<std::string> const& files = ccg.GetByproducts();
+      for(std::vector<std::string>::const_iterator f = files.begin();
+          f != files.end(); ++f)
+        {
+        byproducts.push_back(std::make_pair(*f, main_output));
+        }
+      }
+    }
+
+  std::vector<cmSourceFile*> sources;
+  this->GeneratorTarget->GetSourceFiles(sources, this->ConfigName);
+  for(std::vector<cmSourceFile*>::const_iterator source = sources.begin();
+      source != sources.end(); ++source)
+    {
+    if(cmCustomCommand* cc = (*source)->GetCustomCommand())
+      {
+      cmCustomCommandGenerator ccg(*cc, this->ConfigName,
+                                   this->LocalGenerator);
+      std::vector<std::string> const& files = ccg.GetByproducts();
+      for(std::vector<std::string>::const_iterator f = files.begin();
+          f != files.end(); ++f)
+        {
+        byproducts.push_back(std::make_pair(*f, ccg.GetOutputs()[0]));
+        }
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void cmMakefileTargetGenerator
 ::WriteObjectDependRules(cmSourceFile const& source,
@@ -1267,7 +1445,8 @@ cmMakefileTargetGenerator
   progress.Dir = this->LocalGenerator->GetBinaryDirectory();
   progress.Dir += cmake::GetCMakeFilesDirectory();
   std::ostringstream progressArg;
-  progressArg << "$(CMAKE_PROGRESS_" << this->NumberOfProgressActions << ")";
+  progressArg << "$(" << this->MakeVariablePrefix << "CMAKE_PROGRESS_"
+              << this->NumberOfProgressActions << ")";
   progress.Arg = progressArg.str();
 }
 
@@ -1409,6 +1588,21 @@ cmMakefileTargetGenerator
   helper.Done();
 }
 
+//----------------------------------------------------------------------------
+std::string cmMakefileTargetGenerator::GetSymbolicRuleName() const
+{
+  // The flat Makefile2 includes this file and already has a rule
+  // named after the target, so use a name private to the target.
+  if(this->GlobalGenerator->GetFlatMakefiles())
+    {
+    std::string name =
+      this->LocalGenerator->GetRelativeTargetDirectory(this->GeneratorTarget);
+    name += "/symbolic";
+    return name;
+    }
+  return this->GeneratorTarget->GetName();
+}
+
 //----------------------------------------------------------------------------
 void cmMakefileTargetGenerator::WriteTargetDriverRule(
                                                 const std::string& main_output,
@@ -1447,6 +1641,8 @@ void cmMakefileTargetGenerator::WriteTargetDriverRule(
     // Make sure the extra files are built.
     depends.insert(depends.end(),
                    this->ExtraFiles.begin(), this->ExtraFiles.end());
+
+    this->RecordByproducts(main_output);
     }
 
   // Write the driver rule.
@@ -101,6 +101,12 @@ protected:
   void WriteObjectDependRules(cmSourceFile const& source,
                               std::vector<std::string>& depends);
 
+  // whether compiler-written dependencies are enabled for this target
+  bool CompilerDependsEnabled() const;
+
+  // whether the compiler writes the dependencies of objects in a language
+  bool UseCompilerDepends(const std::string& lang) const;
+
   // write the build rule for a custom command
   void GenerateCustomRuleFile(cmCustomCommandGenerator const& ccg);
 
@@ -122,8 +128,14 @@ protected:
   // write the driver rule to build target outputs
   void WriteTargetDriverRule(const std::string& main_output, bool relink);
 
+  // name of the symbolic rule for targets without a real output file
+  std::string GetSymbolicRuleName() const;
+
   void DriveCustomCommands(std::vector<std::string>& depends);
 
+  // record the byproducts of custom commands for the global generator
+  void RecordByproducts(const std::string& main_output);
+
   // append intertarget dependencies
   void AppendTargetDepends(std::vector<std::string>& depends);
 
@@ -180,6 +192,9 @@ protected:
   // the full path to the progress file
   std::string ProgressFileNameFull;
   unsigned long NumberOfProgressActions;
+
+  // Prefix of the make variables private to this target.
+  std::string MakeVariablePrefix;
   bool NoRuleMessages;
 
   // the path to the directory the build file is in
@@ -102,12 +102,12 @@ void cmMakefileUtilityTargetGenerator::WriteRuleFiles()
     }
 
   // Write the rule.
+  std::string ruleName = this->GetSymbolicRuleName();
   this->LocalGenerator->WriteMakeRule(*this->BuildFileStream, 0,
-                                      this->GeneratorTarget->GetName(),
-                                      depends, commands, true);
+                                      ruleName, depends, commands, true);
 
   // Write the main driver rule to build everything in this target.
-  this->WriteTargetDriverRule(this->GeneratorTarget->GetName(), false);
+  this->WriteTargetDriverRule(ruleName, false);
 
   // Write clean target
   this->WriteTargetCleanRules();
@@ -12,6 +12,7 @@
 
 #include "cmSystemTools.h"
 #include "cmAlgorithms.h"
+#include "cmEchoColor.h"
 #include <ctype.h>
 #include <errno.h>
 #include <time.h>
@@ -29,13 +30,15 @@
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 # include "cmArchiveWrite.h"
 # include "cmLocale.h"
+# include "cmWorkerPool.h"
 # include <cm_libarchive.h>
+# include <cmsys/auto_ptr.hxx>
+# include <deque>
 # ifndef __LA_INT64_T
 #  define __LA_INT64_T la_int64_t
 # endif
 #endif
 #include <cmsys/FStream.hxx>
-#include <cmsys/Terminal.h>
 
 #if defined(_WIN32)
 # include <windows.h>
@@ -46,6 +49,17 @@
 # include <unistd.h>
 # include <utime.h>
 # include <sys/wait.h>
+# include <fcntl.h>
+#endif
+
+#if defined(__linux__)
+# include <sys/ioctl.h>
+# include <linux/fs.h>
+# if defined(FICLONE)
+#  define CM_FICLONE FICLONE
+# else
+#  define CM_FICLONE _IOW(0x94, 9, int)
+# endif
 #endif
 
 #if defined(__APPLE__)
@@ -979,6 +993,106 @@ bool cmSystemTools::RenameFile(const char* oldname, const char* newname)
 #endif
 }
 
+//----------------------------------------------------------------------------
+bool cmSystemTools::CloneFile(const std::string& source,
+                              const std::string& destination)
+{
+#if defined(CM_FICLONE)
+  int in = open(source.c_str(), O_RDONLY);
+  if(in < 0)
+    {
+    return false;
+    }
+  struct stat st;
+  if(fstat(in, &st) != 0)
+    {
+    close(in);
+    return false;
+    }
+  int out = open(destination.c_str(), O_WRONLY | O_CREAT | O_EXCL,
+                 st.st_mode & 07777);
+  if(out < 0)
+    {
+    close(in);
+    return false;
+    }
+  bool cloned = ioctl(out, CM_FICLONE, in) == 0;
+  close(out);
+  close(in);
+  if(!cloned)
+    {
+    unlink(destination.c_str());
+    }
+  return cloned;
+#else
+  (void)source;
+  (void)destination;
+  return false;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool cmSystemTools::CreateHardLink(const std::string& source,
+                                   const std::string& destination)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  return CreateHardLinkW(
+    SystemTools::ConvertToWindowsExtendedPath(destination).c_str(),
+    SystemTools::ConvertToWindowsExtendedPath(source).c_str(), 0) != 0;
+#else
+  return link(source.c_str(), destination.c_str()) == 0;
+#endif
+}
+
+//----------------------------------------------------------------------------
+bool cmSystemTools::BreakHardLink(const std::string& file)
+{
+#if defined(_WIN32) && !defined(__CYGWIN__)
+  HANDLE h = CreateFileW(
+    SystemTools::ConvertToWindowsExtendedPath(file).c_str(),
+    FILE_READ_ATTRIBUTES,
+    FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, 0,
+    OPEN_EXISTING, FILE_FLAG_BACKUP_SEMANTICS | FILE_FLAG_OPEN_REPARSE_POINT,
+    0);
+  if(h == INVALID_HANDLE_VALUE)
+    {
+    return true;
+    }
+  BY_HANDLE_FILE_INFORMATION info;
+  BOOL haveInfo = GetFileInformationByHandle(h, &info);
+  CloseHandle(h);
+  if(!haveInfo || info.nNumberOfLinks < 2 ||
+     (info.dwFileAttributes & (FILE_ATTRIBUTE_DIRECTORY |
+                               FILE_ATTRIBUTE_REPARSE_POINT)))
+    {
+    return true;
+    }
+#else
+  struct stat st;
+  if(lstat(file.c_str(), &st) != 0 || !S_ISREG(st.st_mode) ||
+     st.st_nlink < 2)
+    {
+    return true;
+    }
+#endif
+  // Replace the name with a copy.  The other names keep the old data.
+  std::string tmp = file + ".cmake-unlink";
+  cmSystemTools::RemoveFile(tmp);
+  if(!cmSystemTools::CloneFile(file, tmp) &&
+     !cmSystemTools::CopyFileAlways(file, tmp))
+    {
+    cmSystemTools::RemoveFile(tmp);
+    return false;
+    }
+  if(!cmSystemTools::CopyFileTime(file.c_str(), tmp.c_str()) ||
+     !cmSystemTools::RenameFile(tmp.c_str(), file.c_str()))
+    {
+    cmSystemTools::RemoveFile(tmp);
+    return false;
+    }
+  return true;
+}
+
 bool cmSystemTools::ComputeFileMD5(const std::string& source, char* md5out)
 {
 #if defined(CMAKE_BUILD_WITH_CMAKE)
@@ -1551,7 +1665,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
                               const std::vector<std::string>& files,
                               cmTarCompression compressType,
                               bool verbose, std::string const& mtime,
-                              std::string const& format)
+                              std::string const& format, int threads)
 {
 #if defined(CMAKE_BUILD_WITH_CMAKE)
   std::string cwd = cmSystemTools::GetCurrentWorkingDirectory();
@@ -1583,7 +1697,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
     }
 
   cmArchiveWrite a(fout, compress,
-    format.empty() ? "paxr" : format);
+    format.empty() ? "paxr" : format, threads);
 
   a.SetMTime(mtime);
   a.SetVerbose(verbose);
@@ -1601,7 +1715,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
       break;
       }
     }
-  if(!a)
+  if(!a.Close())
     {
     cmSystemTools::Error(a.GetError().c_str());
     return false;
@@ -1611,6 +1725,7 @@ bool cmSystemTools::CreateTar(const char* outFileName,
   (void)outFileName;
   (void)files;
   (void)verbose;
+  (void)threads;
   return false;
 #endif
 }
@@ -1771,8 +1886,201 @@ long copy_data(struct archive *ar, struct archive *aw)
 #endif
 }
 
+// Write one regular file read from an archive to disk on a pool thread.
+class cmTarExtractJob: public cmWorkerPool::Job
+{
+public:
+  cmTarExtractJob(struct archive_entry* entry):
+    Entry(archive_entry_clone(entry)), Disk(0), Size(0) {}
+  ~cmTarExtractJob()
+    {
+    if(this->Disk)
+      {
+      archive_write_free(this->Disk);
+      }
+    archive_entry_free(this->Entry);
+    }
+
+  // Create the file on disk.  Called on the reading thread, because
+  // libarchive changes the process umask while it creates a disk writer
+  // and while it writes a header.
+  bool WriteHeader()
+    {
+    this->Disk = archive_write_disk_new();
+    int r = archive_write_disk_set_options(this->Disk, ARCHIVE_EXTRACT_TIME);
+    if(r == ARCHIVE_OK)
+      {
+      r = archive_write_header(this->Disk, this->Entry);
+      }
+    if(r != ARCHIVE_OK)
+      {
+      this->Error = archive_error_string(this->Disk);
+      return false;
+      }
+    return true;
+    }
+
+  // Read the data of the current entry.  Called on the reading thread.
+  bool ReadData(struct archive* ar)
+    {
+    for(;;)
+      {
+      const void* buff;
+      size_t size;
+#if defined(ARCHIVE_VERSION_NUMBER) && ARCHIVE_VERSION_NUMBER >= 3000000
+      __LA_INT64_T offset;
+#else
+      off_t offset;
+#endif
+      int r = archive_read_data_block(ar, &buff, &size, &offset);
+      if(r == ARCHIVE_EOF)
+        {
+        return true;
+        }
+      if(r != ARCHIVE_OK)
+        {
+        this->Error = archive_error_string(ar);
+        return false;
+        }
+      this->Blocks.push_back(std::make_pair(
+        static_cast<__LA_INT64_T>(offset),
+        std::string(static_cast<const char*>(buff), size)));
+      this->Size += size;
+      }
+    }
+
+  // Write the data and close the file created by WriteHeader.
+  virtual void Run()
+    {
+    int r = ARCHIVE_OK;
+    for(std::vector<Block>::const_iterator i = this->Blocks.begin();
+        r == ARCHIVE_OK && i != this->Blocks.end(); ++i)
+      {
+      r = static_cast<int>(archive_write_data_block(
+        this->Disk, i->second.data(), i->second.size(), i->first));
+      }
+    if(r == ARCHIVE_OK)
+      {
+      r = archive_write_finish_entry(this->Disk);
+      }
+    if(r != ARCHIVE_OK)
+      {
+      this->Error = archive_error_string(this->Disk);
+      }
+    archive_write_free(this->Disk);
+    this->Disk = 0;
+    this->Blocks.clear();
+    }
+
+  std::string GetPath() const
+    { return cm_archive_entry_pathname(this->Entry); }
+  size_t GetSize() const { return this->Size; }
+  std::string const& GetError() const { return this->Error; }
+
+private:
+  typedef std::pair<__LA_INT64_T, std::string> Block;
+  struct archive_entry* Entry;
+  struct archive* Disk;
+  std::vector<Block> Blocks;
+  size_t Size;
+  std::string Error;
+};
+
+// Hand regular files read from an archive to a pool of writer threads
+// while the calling thread keeps decompressing.  The amount of data
+// waiting to be written is bounded.
+class cmTarExtractPool
+{
+public:
+  cmTarExtractPool(unsigned int threads): Pool(threads), Bytes(0) {}
+  ~cmTarExtractPool() { this->Drain(); }
+
+  // Whether the entry may be written by the pool.  Anything else is
+  // written by the caller after draining the pool, except directories,
+  // which never conflict with files still being written.
+  bool Accepts(struct archive_entry* entry) const
+    {
+    return archive_entry_filetype(entry) == AE_IFREG &&
+      !archive_entry_hardlink(entry) &&
+      archive_entry_size(entry) <= MaxFileSize &&
+      this->Paths.find(cm_archive_entry_pathname(entry)) ==
+      this->Paths.end();
+    }
+
+  bool Queue(struct archive* ar, struct archive_entry* entry)
+    {
+    cmTarExtractJob* job = new cmTarExtractJob(entry);
+    if(!job->WriteHeader())
+      {
+      cmSystemTools::Error("Problem with archive_write_header(): ",
+                           job->GetError().c_str());
+      cmSystemTools::Error("Current file: ", job->GetPath().c_str());
+      delete job;
+      return false;
+      }
+    if(!job->ReadData(ar))
+      {
+      cmSystemTools::Error("Problem with archive_read_data_block(): ",
+                           job->GetError().c_str());
+      delete job;
+      return false;
+      }
+    this->Paths.insert(job->GetPath());
+    this->Bytes += job->GetSize();
+    this->InFlight.push_back(job);
+    this->Pool.Submit(job);
+    while(this->Bytes > MaxBytesInFlight ||
+          this->InFlight.size() > 4 * this->Pool.GetNumberOfThreads())
+      {
+      if(!this->WaitFront())
+        {
+        return false;
+        }
+      }
+    return true;
+    }
+
+  // Wait for all queued files and report the first failure.
+  bool Drain()
+    {
+    bool okay = true;
+    while(!this->InFlight.empty())
+      {
+      okay = this->WaitFront() && okay;
+      }
+    return okay;
+    }
+
+private:
+  bool WaitFront()
+    {
+    cmTarExtractJob* job = this->InFlight.front();
+    this->InFlight.pop_front();
+    this->Pool.Wait(job);
+    this->Paths.erase(job->GetPath());
+    this->Bytes -= job->GetSize();
+    bool okay = job->GetError().empty();
+    if(!okay)
+      {
+      cmSystemTools::Error("Problem writing extracted file ",
+                           job->GetPath().c_str(), ": ",
+                           job->GetError().c_str());
+      }
+    delete job;
+    return okay;
+    }
+
+  static const __LA_INT64_T MaxFileSize = 8 << 20;
+  static const size_t MaxBytesInFlight = 64 << 20;
+
+  cmWorkerPool Pool;
+  std::deque<cmTarExtractJob*> InFlight;
+  std::set<std::string> Paths;
+  size_t Bytes;
+};
+
 bool extract_tar(const char* outFileName, bool verbose,
-                 bool extract)
+                 bool extract, int threads = 1)
 {
   cmLocaleRAII localeRAII;
   static_cast<void>(localeRAII);
@@ -1790,6 +2098,12 @@ bool extract_tar(const char* outFileName, bool verbose,
     archive_read_close(a);
     return false;
     }
+  cmsys::auto_ptr<cmTarExtractPool> pool;
+  if(extract && threads != 1)
+    {
+    pool.reset(new cmTarExtractPool(
+      cmWorkerPool::NormalizeThreadCount(threads)));
+    }
   for (;;)
     {
     r = archive_read_next_header(a, &entry);
@@ -1821,6 +2135,21 @@ bool extract_tar(const char* outFileName, bool verbose,
       cmSystemTools::Stdout(cm_archive_entry_pathname(entry).c_str());
       cmSystemTools::Stdout("\n");
       }
+    if(pool.get() && pool->Accepts(entry))
+      {
+      if(!pool->Queue(a, entry))
+        {
+        r = ARCHIVE_FATAL;
+        break;
+        }
+      continue;
+      }
+    if(pool.get() && archive_entry_filetype(entry) != AE_IFDIR &&
+       !pool->Drain())
+      {
+      r = ARCHIVE_FATAL;
+      break;
+      }
     if(extract)
       {
       r = archive_write_disk_set_options(ext, ARCHIVE_EXTRACT_TIME);
@@ -1863,6 +2192,11 @@ bool extract_tar(const char* outFileName, bool verbose,
         }
       }
     }
+  // Finish writing files before the directory times are restored.
+  if(pool.get() && !pool->Drain())
+    {
+    r = ARCHIVE_FATAL;
+    }
   archive_write_free(ext);
   archive_read_close(a);
   archive_read_free(a);
@@ -1872,13 +2206,14 @@ bool extract_tar(const char* outFileName, bool verbose,
 #endif
 
 bool cmSystemTools::ExtractTar(const char* outFileName,
-                               bool verbose)
+                               bool verbose, int threads)
 {
 #if defined(CMAKE_BUILD_WITH_CMAKE)
-  return extract_tar(outFileName, verbose, true);
+  return extract_tar(outFileName, verbose, true, threads);
 #else
   (void)outFileName;
   (void)verbose;
+  (void)threads;
   return false;
 #endif
 }
@@ -2211,6 +2546,7 @@ static std::string cmSystemToolsCPackCommand;
 static std::string cmSystemToolsCMakeCursesCommand;
 static std::string cmSystemToolsCMakeGUICommand;
 static std::string cmSystemToolsCMClDepsCommand;
+static std::string cmSystemToolsCMEchoCommand;
 static std::string cmSystemToolsCMakeRoot;
 void cmSystemTools::FindCMakeResources(const char* argv0)
 {
@@ -2310,6 +2646,13 @@ void cmSystemTools::FindCMakeResources(const char* argv0)
     {
     cmSystemToolsCMClDepsCommand = "";
     }
+  cmSystemToolsCMEchoCommand = exe_dir;
+  cmSystemToolsCMEchoCommand += "/cmecho";
+  cmSystemToolsCMEchoCommand += cmSystemTools::GetExecutableExtension();
+  if(!cmSystemTools::FileExists(cmSystemToolsCMEchoCommand.c_str()))
+    {
+    cmSystemToolsCMEchoCommand = "";
+    }
 
 #ifdef CMAKE_BUILD_WITH_CMAKE
   // Install tree has "<prefix>/bin/cmake" and "<prefix><CMAKE_DATA_DIR>".
@@ -2382,6 +2725,12 @@ std::string const& cmSystemTools::GetCMClDepsCommand()
   return cmSystemToolsCMClDepsCommand;
 }
 
+//----------------------------------------------------------------------------
+std::string const& cmSystemTools::GetCMEchoCommand()
+{
+  return cmSystemToolsCMEchoCommand;
+}
+
 //----------------------------------------------------------------------------
 std::string const& cmSystemTools::GetCMakeRoot()
 {
@@ -2392,37 +2741,7 @@ std::string const& cmSystemTools::GetCMakeRoot()
 void cmSystemTools::MakefileColorEcho(int color, const char* message,
                                       bool newline, bool enabled)
 {
-  // On some platforms (an MSYS prompt) cmsysTerminal may not be able
-  // to determine whether the stream is displayed on a tty.  In this
-  // case it assumes no unless we tell it otherwise.  Since we want
-  // color messages to be displayed for users we will assume yes.
-  // However, we can test for some situations when the answer is most
-  // likely no.
-  int assumeTTY = cmsysTerminal_Color_AssumeTTY;
-  if(cmSystemTools::GetEnv("DART_TEST_FROM_DART") ||
-     cmSystemTools::GetEnv("DASHBOARD_TEST_FROM_CTEST") ||
-     cmSystemTools::GetEnv("CTEST_INTERACTIVE_DEBUG_MODE"))
-    {
-    // Avoid printing color escapes during dashboard builds.
-    assumeTTY = 0;
-    }
-
-  if(enabled && color != cmsysTerminal_Color_Normal)
-    {
-    // Print with color.  Delay the newline until later so that
-    // all color restore sequences appear before it.
-    cmsysTerminal_cfprintf(color | assumeTTY, stdout, "%s", message);
-    }
-  else
-    {
-    // Color is disabled.  Print without color.
-    fprintf(stdout, "%s", message);
-    }
-
-  if(newline)
-    {
-    fprintf(stdout, "\n");
-    }
+  cmEchoColor::Echo(color, message, newline, enabled);
 }
 
 //----------------------------------------------------------------------------
@@ -2545,7 +2864,8 @@ bool cmSystemTools::ChangeRPath(std::string const& file,
                                 std::string const& oldRPath,
                                 std::string const& newRPath,
                                 std::string* emsg,
-                                bool* changed)
+                                bool* changed,
+                                bool unshare)
 {
 #if defined(CMAKE_USE_ELF_PARSER)
   if(changed)
@@ -2683,10 +3003,20 @@ bool cmSystemTools::ChangeRPath(std::string const& file,
   // If the resulting rpath is empty, just remove the entire entry instead.
   if (remove_rpath)
     {
-    return cmSystemTools::RemoveRPath(file, emsg, changed);
+    return cmSystemTools::RemoveRPath(file, emsg, changed, unshare);
     }
 
   {
+  // Do not write through a hard link shared with another file.
+  if(unshare && !cmSystemTools::BreakHardLink(file))
+    {
+    if(emsg)
+      {
+      *emsg = "Error breaking hard link before update.";
+      }
+    return false;
+    }
+
   // Open the file for update.
   cmsys::ofstream f(file.c_str(),
                   std::ios::in | std::ios::out | std::ios::binary);
@@ -2748,6 +3078,7 @@ bool cmSystemTools::ChangeRPath(std::string const& file,
   (void)newRPath;
   (void)emsg;
   (void)changed;
+  (void)unshare;
   return false;
 #endif
 }
@@ -2810,7 +3141,7 @@ bool cmSystemTools::VersionCompareGreater(std::string const& lhs,
 
 //----------------------------------------------------------------------------
 bool cmSystemTools::RemoveRPath(std::string const& file, std::string* emsg,
-                                bool* removed)
+                                bool* removed, bool unshare)
 {
 #if defined(CMAKE_USE_ELF_PARSER)
   if(removed)
@@ -2909,6 +3240,16 @@ bool cmSystemTools::RemoveRPath(std::string const& file, std::string* emsg,
     }
   }
 
+  // Do not write through a hard link shared with another file.
+  if(unshare && !cmSystemTools::BreakHardLink(file))
+    {
+    if(emsg)
+      {
+      *emsg = "Error breaking hard link before update.";
+      }
+    return false;
+    }
+
   // Open the file for update.
   cmsys::ofstream f(file.c_str(),
                   std::ios::in | std::ios::out | std::ios::binary);
@@ -2974,6 +3315,7 @@ bool cmSystemTools::RemoveRPath(std::string const& file, std::string* emsg,
   (void)file;
   (void)emsg;
   (void)removed;
+  (void)unshare;
   return false;
 #endif
 }
@@ -188,6 +188,21 @@ public:
       if possible).  */
   static bool RenameFile(const char* oldname, const char* newname);
 
+  /** Create "destination" as a copy-on-write clone of "source" (a
+      reflink).  Fails if the file system or platform does not support
+      it, e.g. when the files are on different volumes.  */
+  static bool CloneFile(const std::string& source,
+                        const std::string& destination);
+
+  /** Create "destination" as a hard link to "source".  */
+  static bool CreateHardLink(const std::string& source,
+                             const std::string& destination);
+
+  /** If "file" has more than one hard link, replace it with a private
+      copy so that it can be modified in place without affecting the
+      other names.  */
+  static bool BreakHardLink(const std::string& file);
+
   ///! Compute the md5sum of a file
   static bool ComputeFileMD5(const std::string& source, char* md5out);
 
@@ -395,12 +410,19 @@ public:
   };
   static bool ListTar(const char* outFileName,
                       bool verbose);
+  /**
+   * Create or extract a tar or zip archive.  A thread count other than
+   * one compresses a new archive, or writes the extracted files, on that
+   * many threads (zero means one per processor).
+   */
   static bool CreateTar(const char* outFileName,
                         const std::vector<std::string>& files,
                         cmTarCompression compressType, bool verbose,
                         std::string const& mtime = std::string(),
-                        std::string const& format = std::string());
-  static bool ExtractTar(const char* inFileName, bool verbose);
+                        std::string const& format = std::string(),
+                        int threads = 1);
+  static bool ExtractTar(const char* inFileName, bool verbose,
+                         int threads = 1);
   // This should be called first thing in main
   // it will keep child processes from inheriting the
   // stdin and stdout of this process.  This is important
@@ -431,6 +453,7 @@ public:
   static std::string const& GetCMakeGUICommand();
   static std::string const& GetCMakeCursesCommand();
   static std::string const& GetCMClDepsCommand();
+  static std::string const& GetCMEchoCommand();
   static std::string const& GetCMakeRoot();
 
   /** Echo a message in color using KWSys's Terminal cprintf.  */
@@ -445,16 +468,19 @@ public:
   static bool GuessLibraryInstallName(std::string const& fullPath,
                                  std::string& soname);
 
-  /** Try to set the RPATH in an ELF binary.  */
+  /** Try to set the RPATH in an ELF binary.  If "unshare" is true a
+      file with more than one hard link is replaced with a private copy
+      before it is modified.  */
   static bool ChangeRPath(std::string const& file,
                           std::string const& oldRPath,
                           std::string const& newRPath,
                           std::string* emsg = 0,
-                          bool* changed = 0);
+                          bool* changed = 0,
+                          bool unshare = false);
 
   /** Try to remove the RPATH from an ELF binary.  */
   static bool RemoveRPath(std::string const& file, std::string* emsg = 0,
-                          bool* removed = 0);
+                          bool* removed = 0, bool unshare = false);
 
   /** Check whether the RPATH in an ELF binary contains the path
       given.  */
@@ -11,7 +11,10 @@
 ============================================================================*/
 #include "cmTestGenerator.h"
 
+#include "cmAlgorithms.h"
+#include "cmComputeLinkInformation.h"
 #include "cmGeneratorExpression.h"
+#include "cmGeneratorTarget.h"
 #include "cmOutputConverter.h"
 #include "cmLocalGenerator.h"
 #include "cmSystemTools.h"
@@ -134,6 +137,18 @@ void cmTestGenerator::GenerateScriptForConfig(std::ostream& os,
 
   // Output properties for the test.
   cmPropertyMap& pm = this->Test->GetProperties();
+
+  // Resolve the files whose content decides the test result.  Only
+  // the INPUTS property names them: a test may also read files that its
+  // command line does not show.
+  std::vector<std::string> inputs;
+  cmPropertyMap::const_iterator inputsProp = pm.find("INPUTS");
+  if(inputsProp != pm.end())
+    {
+    this->ComputeInputs(ge.Parse(inputsProp->second.GetValue())
+                          ->Evaluate(this->LG, config), config, inputs);
+    }
+
   if(!pm.empty())
     {
     os << indent << "set_tests_properties(" << this->Test->GetName()
@@ -141,15 +156,103 @@ void cmTestGenerator::GenerateScriptForConfig(std::ostream& os,
     for(cmPropertyMap::const_iterator i = pm.begin();
         i != pm.end(); ++i)
       {
+      if(i == inputsProp)
+        {
+        continue;
+        }
       os << " " << i->first
          << " " << cmOutputConverter::EscapeForCMake(
            ge.Parse(i->second.GetValue())->Evaluate(this->LG,
                                                     config));
       }
+    if(inputsProp != pm.end())
+      {
+      os << " INPUTS " << cmOutputConverter::EscapeForCMake(
+        cmJoin(inputs, ";"));
+      }
     os << ")" << std::endl;
     }
 }
 
+//----------------------------------------------------------------------------
+void cmTestGenerator::ComputeInputs(std::string const& value,
+                                    std::string const& config,
+                                    std::vector<std::string>& inputs)
+{
+  std::set<cmGeneratorTarget const*> emitted;
+  std::vector<std::string> items;
+  cmSystemTools::ExpandListArgument(value, items);
+  for(std::vector<std::string>::const_iterator i = items.begin();
+      i != items.end(); ++i)
+    {
+    if(cmGeneratorTarget* target = this->LG->FindGeneratorTargetToUse(*i))
+      {
+      this->AddTargetInputs(target, config, emitted, inputs);
+      }
+    else
+      {
+      inputs.push_back(cmSystemTools::CollapseFullPath(
+        *i, this->LG->GetCurrentSourceDirectory()));
+      }
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmTestGenerator
+::AddTargetInputs(cmGeneratorTarget const* target, std::string const& config,
+                  std::set<cmGeneratorTarget const*>& emitted,
+                  std::vector<std::string>& inputs)
+{
+  if(!emitted.insert(target).second)
+    {
+    return;
+    }
+  switch(target->GetType())
+    {
+    case cmState::EXECUTABLE:
+    case cmState::SHARED_LIBRARY:
+    case cmState::MODULE_LIBRARY:
+      break;
+    case cmState::STATIC_LIBRARY:
+    case cmState::UNKNOWN_LIBRARY:
+      inputs.push_back(target->GetFullPath(config));
+      return;
+    default:
+      return;
+    }
+  inputs.push_back(target->GetFullPath(config));
+
+  // Follow the shared libraries loaded at runtime.  Static libraries
+  // are part of the file already.  Imported targets list their own
+  // dependencies in the link line of their consumers.
+  if(target->IsImported())
+    {
+    return;
+    }
+  cmComputeLinkInformation* cli = target->GetLinkInformation(config);
+  if(!cli)
+    {
+    return;
+    }
+  cmComputeLinkInformation::ItemVector const& items = cli->GetItems();
+  for(cmComputeLinkInformation::ItemVector::const_iterator i = items.begin();
+      i != items.end(); ++i)
+    {
+    if(i->Target)
+      {
+      if(i->Target->GetType() == cmState::SHARED_LIBRARY ||
+         i->Target->GetType() == cmState::MODULE_LIBRARY)
+        {
+        this->AddTargetInputs(i->Target, config, emitted, inputs);
+        }
+      }
+    else if(i->IsPath && cmSystemTools::FileIsFullPath(i->Value.c_str()))
+      {
+      inputs.push_back(i->Value);
+      }
+    }
+}
+
 //----------------------------------------------------------------------------
 void cmTestGenerator::GenerateScriptNoConfig(std::ostream& os,
                                              Indent const& indent)
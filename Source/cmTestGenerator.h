@@ -16,6 +16,7 @@
 
 class cmTest;
 class cmLocalGenerator;
+class cmGeneratorTarget;
 
 /** \class cmTestGenerator
  * \brief Support class for generating install scripts.
@@ -41,6 +42,15 @@ protected:
   virtual bool NeedsScriptNoConfig() const;
   void GenerateOldStyle(std::ostream& os, Indent const& indent);
 
+  // Resolve a list of files and target names to the files whose content
+  // the test result depends on.
+  void ComputeInputs(std::string const& value, std::string const& config,
+                     std::vector<std::string>& inputs);
+  void AddTargetInputs(cmGeneratorTarget const* target,
+                       std::string const& config,
+                       std::set<cmGeneratorTarget const*>& emitted,
+                       std::vector<std::string>& inputs);
+
   cmLocalGenerator* LG;
   cmTest* Test;
   bool TestGenerated;
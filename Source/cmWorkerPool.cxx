@@ -0,0 +1,130 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmWorkerPool.h"
+
+#include <cmsys/SystemInformation.hxx>
+
+// Common implementation
+
+//----------------------------------------------------------------------------
+cmWorkerPool::cmWorkerPool(unsigned int threads):
+  Internal(0),
+  NumberOfThreads(threads? threads : GetNumberOfProcessors()),
+  Pending(0),
+  Stopping(false)
+{
+  this->StartThreads();
+}
+
+//----------------------------------------------------------------------------
+cmWorkerPool::~cmWorkerPool()
+{
+  this->WaitAll();
+  this->Lock();
+  this->Stopping = true;
+  this->SignalWork(true);
+  this->Unlock();
+  this->JoinThreads();
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::Submit(Job* job)
+{
+  if(this->NumberOfThreads == 0)
+    {
+    // No thread could be started.  Run the job synchronously.
+    job->Run();
+    job->Done = true;
+    return;
+    }
+  this->Lock();
+  job->Done = false;
+  this->Queue.push_back(job);
+  ++this->Pending;
+  this->SignalWork(false);
+  this->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::Wait(Job* job)
+{
+  this->Lock();
+  while(!job->Done)
+    {
+    this->WaitForDone();
+    }
+  this->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::WaitAll()
+{
+  this->Lock();
+  while(this->Pending > 0)
+    {
+    this->WaitForDone();
+    }
+  this->Unlock();
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::ThreadLoop()
+{
+  this->Lock();
+  for(;;)
+    {
+    while(this->Queue.empty() && !this->Stopping)
+      {
+      this->WaitForWork();
+      }
+    if(this->Queue.empty())
+      {
+      break;
+      }
+    Job* job = this->Queue.front();
+    this->Queue.pop_front();
+    this->Unlock();
+    job->Run();
+    this->Lock();
+    job->Done = true;
+    --this->Pending;
+    this->SignalDone();
+    }
+  this->Unlock();
+}
+
+//----------------------------------------------------------------------------
+unsigned int cmWorkerPool::GetNumberOfProcessors()
+{
+  cmsys::SystemInformation info;
+  info.RunCPUCheck();
+  unsigned int n = info.GetNumberOfLogicalCPU();
+  return n > 0? n : 1;
+}
+
+//----------------------------------------------------------------------------
+unsigned int cmWorkerPool::NormalizeThreadCount(int threads)
+{
+  // More threads than processors would only add contention.
+  unsigned int processors = GetNumberOfProcessors();
+  if(threads <= 0 || static_cast<unsigned int>(threads) > processors)
+    {
+    return processors;
+    }
+  return static_cast<unsigned int>(threads);
+}
+
+#if defined(_WIN32)
+# include "cmWorkerPoolWin32.cxx"
+#else
+# include "cmWorkerPoolUnix.cxx"
+#endif
@@ -0,0 +1,101 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#ifndef cmWorkerPool_h
+#define cmWorkerPool_h
+
+#include "cmStandardIncludes.h"
+
+#include <deque>
+
+#if !defined(CMAKE_BUILD_WITH_CMAKE)
+# error "cmWorkerPool not allowed during bootstrap build!"
+#endif
+
+/** \class cmWorkerPool
+ * \brief Run independent jobs on a fixed set of threads.
+ *
+ * Under the hood this class uses pthreads on Unix-like platforms and
+ * native threads on Win32.  Jobs are started in submission order.
+ * The pool never takes ownership of a job; the caller must keep it
+ * alive until Wait() or WaitAll() reports it as done.
+ */
+class cmWorkerPool
+{
+public:
+  /** Unit of work run by one of the pool threads.  */
+  class Job
+  {
+  public:
+    Job(): Done(false) {}
+    virtual ~Job() {}
+    virtual void Run() = 0;
+  private:
+    friend class cmWorkerPool;
+    bool Done;
+  };
+
+  /**
+   * Start the given number of threads.  A value of zero selects one
+   * thread per logical processor.
+   */
+  explicit cmWorkerPool(unsigned int threads);
+
+  /** Wait for all queued jobs and join the threads.  */
+  ~cmWorkerPool();
+
+  /** Number of threads actually running.  */
+  unsigned int GetNumberOfThreads() const { return this->NumberOfThreads; }
+
+  /** Queue a job to run on the next free thread.  */
+  void Submit(Job* job);
+
+  /** Block until the given job has finished running.  */
+  void Wait(Job* job);
+
+  /** Block until every submitted job has finished running.  */
+  void WaitAll();
+
+  /** Number of logical processors on this host, at least one.  */
+  static unsigned int GetNumberOfProcessors();
+
+  /**
+   * Map a user-provided thread count to a usable one.  Zero, a
+   * negative value or a value larger than the number of logical
+   * processors selects one thread per logical processor.
+   */
+  static unsigned int NormalizeThreadCount(int threads);
+
+private:
+  cmWorkerPool(cmWorkerPool const&);
+  cmWorkerPool& operator=(cmWorkerPool const&);
+
+  void ThreadLoop();
+
+  // Platform-specific parts.
+  struct Internals;
+  void StartThreads();
+  void JoinThreads();
+  void Lock();
+  void Unlock();
+  void WaitForWork();
+  void SignalWork(bool all);
+  void WaitForDone();
+  void SignalDone();
+
+  Internals* Internal;
+  unsigned int NumberOfThreads;
+  std::deque<Job*> Queue;
+  unsigned int Pending;
+  bool Stopping;
+};
+
+#endif
@@ -0,0 +1,107 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+
+#include "cmWorkerPool.h"
+
+#include <pthread.h>
+
+struct cmWorkerPool::Internals
+{
+  pthread_mutex_t Mutex;
+  pthread_cond_t WorkCondition;
+  pthread_cond_t DoneCondition;
+  std::vector<pthread_t> Threads;
+
+  static void* ThreadMain(void* arg)
+    {
+    static_cast<cmWorkerPool*>(arg)->ThreadLoop();
+    return 0;
+    }
+};
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::StartThreads()
+{
+  this->Internal = new Internals;
+  pthread_mutex_init(&this->Internal->Mutex, 0);
+  pthread_cond_init(&this->Internal->WorkCondition, 0);
+  pthread_cond_init(&this->Internal->DoneCondition, 0);
+  for(unsigned int i = 0; i < this->NumberOfThreads; ++i)
+    {
+    pthread_t thread;
+    if(pthread_create(&thread, 0, &Internals::ThreadMain, this) != 0)
+      {
+      break;
+      }
+    this->Internal->Threads.push_back(thread);
+    }
+  this->NumberOfThreads =
+    static_cast<unsigned int>(this->Internal->Threads.size());
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::JoinThreads()
+{
+  for(std::vector<pthread_t>::iterator i = this->Internal->Threads.begin();
+      i != this->Internal->Threads.end(); ++i)
+    {
+    pthread_join(*i, 0);
+    }
+  pthread_cond_destroy(&this->Internal->DoneCondition);
+  pthread_cond_destroy(&this->Internal->WorkCondition);
+  pthread_mutex_destroy(&this->Internal->Mutex);
+  delete this->Internal;
+  this->Internal = 0;
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::Lock()
+{
+  pthread_mutex_lock(&this->Internal->Mutex);
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::Unlock()
+{
+  pthread_mutex_unlock(&this->Internal->Mutex);
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::WaitForWork()
+{
+  pthread_cond_wait(&this->Internal->WorkCondition, &this->Internal->Mutex);
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::SignalWork(bool all)
+{
+  if(all)
+    {
+    pthread_cond_broadcast(&this->Internal->WorkCondition);
+    }
+  else
+    {
+    pthread_cond_signal(&this->Internal->WorkCondition);
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::WaitForDone()
+{
+  pthread_cond_wait(&this->Internal->DoneCondition, &this->Internal->Mutex);
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::SignalDone()
+{
+  pthread_cond_broadcast(&this->Internal->DoneCondition);
+}
@@ -0,0 +1,123 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+
+#include "cmWorkerPool.h"
+
+#include <windows.h>
+#include <process.h>
+
+// Condition variables need Windows Vista or above.  Emulate the two
+// conditions used by the pool with a semaphore and an event so that XP
+// keeps working.
+struct cmWorkerPool::Internals
+{
+  CRITICAL_SECTION Mutex;
+  HANDLE WorkSemaphore;
+  HANDLE DoneEvent;
+  unsigned int Waiting;
+  std::vector<HANDLE> Threads;
+
+  static unsigned int __stdcall ThreadMain(void* arg)
+    {
+    static_cast<cmWorkerPool*>(arg)->ThreadLoop();
+    return 0;
+    }
+};
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::StartThreads()
+{
+  this->Internal = new Internals;
+  InitializeCriticalSection(&this->Internal->Mutex);
+  this->Internal->WorkSemaphore = CreateSemaphoreW(0, 0, 0x7fffffff, 0);
+  this->Internal->DoneEvent = CreateEventW(0, TRUE, FALSE, 0);
+  this->Internal->Waiting = 0;
+  for(unsigned int i = 0; i < this->NumberOfThreads; ++i)
+    {
+    uintptr_t thread =
+      _beginthreadex(0, 0, &Internals::ThreadMain, this, 0, 0);
+    if(thread == 0)
+      {
+      break;
+      }
+    this->Internal->Threads.push_back(reinterpret_cast<HANDLE>(thread));
+    }
+  this->NumberOfThreads =
+    static_cast<unsigned int>(this->Internal->Threads.size());
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::JoinThreads()
+{
+  for(std::vector<HANDLE>::iterator i = this->Internal->Threads.begin();
+      i != this->Internal->Threads.end(); ++i)
+    {
+    WaitForSingleObject(*i, INFINITE);
+    CloseHandle(*i);
+    }
+  CloseHandle(this->Internal->DoneEvent);
+  CloseHandle(this->Internal->WorkSemaphore);
+  DeleteCriticalSection(&this->Internal->Mutex);
+  delete this->Internal;
+  this->Internal = 0;
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::Lock()
+{
+  EnterCriticalSection(&this->Internal->Mutex);
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::Unlock()
+{
+  LeaveCriticalSection(&this->Internal->Mutex);
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::WaitForWork()
+{
+  ++this->Internal->Waiting;
+  this->Unlock();
+  WaitForSingleObject(this->Internal->WorkSemaphore, INFINITE);
+  this->Lock();
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::SignalWork(bool all)
+{
+  LONG count = all? static_cast<LONG>(this->Internal->Waiting) : 1;
+  if(count > static_cast<LONG>(this->Internal->Waiting))
+    {
+    count = static_cast<LONG>(this->Internal->Waiting);
+    }
+  if(count > 0)
+    {
+    this->Internal->Waiting -= static_cast<unsigned int>(count);
+    ReleaseSemaphore(this->Internal->WorkSemaphore, count, 0);
+    }
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::WaitForDone()
+{
+  ResetEvent(this->Internal->DoneEvent);
+  this->Unlock();
+  WaitForSingleObject(this->Internal->DoneEvent, INFINITE);
+  this->Lock();
+}
+
+//----------------------------------------------------------------------------
+void cmWorkerPool::SignalDone()
+{
+  SetEvent(this->Internal->DoneEvent);
+}
@@ -113,6 +113,12 @@ void cmXMLWriter::FragmentFile(const char* fname)
   this->Output << fin.rdbuf();
 }
 
+void cmXMLWriter::Fragment(std::string const& fragment)
+{
+  this->CloseStartElement();
+  this->Output << fragment;
+}
+
 void cmXMLWriter::ConditionalLineBreak(bool condition, std::size_t indent)
 {
   if (condition)
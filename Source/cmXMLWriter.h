@@ -68,6 +68,8 @@ public:
 
   void FragmentFile(const char* fname);
 
+  void Fragment(std::string const& fragment);
+
 private:
   cmXMLWriter(const cmXMLWriter&);
   cmXMLWriter& operator=(const cmXMLWriter&);
@@ -16,15 +16,15 @@
 #include "cmQtAutoGenerators.h"
 #include "cmVersion.h"
 #include "cmAlgorithms.h"
+#include "cmEchoColor.h"
 
 #if defined(CMAKE_BUILD_WITH_CMAKE)
 # include "cmDependsFortran.h" // For -E cmake_copy_f90_mod callback.
+# include "cmCryptoHash.h"
 #endif
 
-#include <cmsys/Directory.hxx>
 #include <cmsys/Process.h>
 #include <cmsys/FStream.hxx>
-#include <cmsys/Terminal.h>
 
 #if defined(CMAKE_HAVE_VS_GENERATORS)
 #include "cmCallVisualStudioMacro.h"
@@ -75,6 +75,11 @@ void CMakeCommandUsage(const char* program)
     << "  remove_directory dir      - remove a directory and its contents\n"
     << "  rename oldname newname    - rename a file or directory "
        "(on one volume)\n"
+    << "  sha1sum <file>...         - compute sha1sum of files\n"
+    << "  sha224sum <file>...       - compute sha224sum of files\n"
+    << "  sha256sum <file>...       - compute sha256sum of files\n"
+    << "  sha384sum <file>...       - compute sha384sum of files\n"
+    << "  sha512sum <file>...       - compute sha512sum of files\n"
     << "  tar [cxt][vf][zjJ] file.tar [file/dir1 file/dir2 ...]\n"
     << "                            - create or extract a tar or zip archive\n"
     << "  sleep <number>...         - sleep for given number of seconds\n"
@@ -98,6 +103,50 @@ void CMakeCommandUsage(const char* program)
   cmSystemTools::Error(errorStream.str().c_str());
 }
 
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+static int HashSumFiles(std::vector<std::string> const& args,
+                        const char* algo)
+{
+  // Hash all regular files at once, then report in argument order.
+  std::vector<std::string> files;
+  for (std::string::size_type cc = 2; cc < args.size(); cc ++)
+    {
+    if(!cmSystemTools::FileIsDirectory(args[cc]))
+      {
+      files.push_back(args[cc]);
+      }
+    }
+  std::vector<std::string> hashes;
+  cmCryptoHash::HashFiles(algo, files, hashes);
+
+  int retval = 0;
+  std::vector<std::string>::const_iterator hash = hashes.begin();
+  for (std::string::size_type cc = 2; cc < args.size(); cc ++)
+    {
+    const char *filename = args[cc].c_str();
+    // Cannot compute hash of a directory
+    if(cmSystemTools::FileIsDirectory(filename))
+      {
+      std::cerr << "Error: " << filename << " is a directory" << std::endl;
+      retval++;
+      }
+    else if(hash->empty())
+      {
+      // To mimic the sum tools' behavior in a shell:
+      std::cerr << filename << ": No such file or directory" << std::endl;
+      retval++;
+      ++hash;
+      }
+    else
+      {
+      std::cout << *hash << "  " << filename << std::endl;
+      ++hash;
+      }
+    }
+  return retval;
+}
+#endif
+
 static bool cmTarFilesFrom(std::string const& file,
                            std::vector<std::string>& files)
 {
@@ -641,6 +690,28 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
         }
       return retval;
       }
+#if defined(CMAKE_BUILD_WITH_CMAKE)
+    else if (args[1] == "sha1sum" && args.size() >= 3)
+      {
+      return HashSumFiles(args, "SHA1");
+      }
+    else if (args[1] == "sha224sum" && args.size() >= 3)
+      {
+      return HashSumFiles(args, "SHA224");
+      }
+    else if (args[1] == "sha256sum" && args.size() >= 3)
+      {
+      return HashSumFiles(args, "SHA256");
+      }
+    else if (args[1] == "sha384sum" && args.size() >= 3)
+      {
+      return HashSumFiles(args, "SHA384");
+      }
+    else if (args[1] == "sha512sum" && args.size() >= 3)
+      {
+      return HashSumFiles(args, "SHA512");
+      }
+#endif
 
     // Command to change directory and run a program.
     else if (args[1] == "chdir" && args.size() >= 4)
@@ -921,6 +992,7 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       std::vector<std::string> files;
       std::string mtime;
       std::string format;
+      int threads = 1;
       bool doing_options = true;
       for (std::string::size_type cc = 4; cc < args.size(); cc ++)
         {
@@ -943,6 +1015,18 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
               return 1;
               }
             }
+          else if (cmHasLiteralPrefix(arg, "--threads="))
+            {
+            long n;
+            if (!cmSystemTools::StringToLong(arg.substr(10).c_str(), &n) ||
+                n < 0)
+              {
+              cmSystemTools::Error("Invalid -E tar --threads= argument: ",
+                arg.substr(10).c_str());
+              return 1;
+              }
+            threads = static_cast<int>(n);
+            }
           else if (cmHasLiteralPrefix(arg, "--format="))
             {
             format = arg.substr(9);
@@ -1014,7 +1098,8 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       else if ( flags.find_first_of('c') != flags.npos )
         {
         if ( !cmSystemTools::CreateTar(
-               outFile.c_str(), files, compress, verbose, mtime, format) )
+               outFile.c_str(), files, compress, verbose, mtime, format,
+               threads) )
           {
           cmSystemTools::Error("Problem creating tar: ", outFile.c_str());
           return 1;
@@ -1023,7 +1108,7 @@ int cmcmd::ExecuteCMakeCommand(std::vector<std::string>& args)
       else if ( flags.find_first_of('x') != flags.npos )
         {
         if ( !cmSystemTools::ExtractTar(
-            outFile.c_str(), verbose) )
+            outFile.c_str(), verbose, threads) )
           {
           cmSystemTools::Error("Problem extracting tar: ", outFile.c_str());
           return 1;
@@ -1151,163 +1236,14 @@ bool cmcmd::SymlinkInternal(std::string const& file, std::string const& link)
 #endif
 }
 
-//----------------------------------------------------------------------------
-static void cmcmdProgressReport(std::string const& dir,
-                                std::string const& num)
-{
-  std::string dirName = dir;
-  dirName += "/Progress";
-  std::string fName;
-  FILE *progFile;
-
-  // read the count
-  fName = dirName;
-  fName += "/count.txt";
-  progFile = cmsys::SystemTools::Fopen(fName,"r");
-  int count = 0;
-  if (!progFile)
-    {
-    return;
-    }
-  else
-    {
-    if (1!=fscanf(progFile,"%i",&count))
-      {
-      cmSystemTools::Message("Could not read from progress file.");
-      }
-    fclose(progFile);
-    }
-  const char* last = num.c_str();
-  for(const char* c = last;; ++c)
-    {
-    if (*c == ',' || *c == '\0')
-      {
-      if (c != last)
-        {
-        fName = dirName;
-        fName += "/";
-        fName.append(last, c-last);
-        progFile = cmsys::SystemTools::Fopen(fName,"w");
-        if (progFile)
-          {
-          fprintf(progFile,"empty");
-          fclose(progFile);
-          }
-        }
-      if(*c == '\0')
-        {
-        break;
-        }
-      last = c + 1;
-      }
-    }
-  int fileNum = static_cast<int>
-    (cmsys::Directory::GetNumberOfFilesInDirectory(dirName));
-  if (count > 0)
-    {
-    // print the progress
-    fprintf(stdout,"[%3i%%] ",((fileNum-3)*100)/count);
-    }
-}
-
 //----------------------------------------------------------------------------
 int cmcmd::ExecuteEchoColor(std::vector<std::string>& args)
 {
   // The arguments are
   //   argv[0] == <cmake-executable>
   //   argv[1] == cmake_echo_color
-
-  bool enabled = true;
-  int color = cmsysTerminal_Color_Normal;
-  bool newline = true;
-  std::string progressDir;
-  for(unsigned int i=2; i < args.size(); ++i)
-    {
-    if(args[i].find("--switch=") == 0)
-      {
-      // Enable or disable color based on the switch value.
-      std::string value = args[i].substr(9);
-      if(!value.empty())
-        {
-        if(cmSystemTools::IsOn(value.c_str()))
-          {
-          enabled = true;
-          }
-        else
-          {
-          enabled = false;
-          }
-        }
-      }
-    else if(cmHasLiteralPrefix(args[i], "--progress-dir="))
-      {
-      progressDir = args[i].substr(15);
-      }
-    else if(cmHasLiteralPrefix(args[i], "--progress-num="))
-      {
-      if (!progressDir.empty())
-        {
-        std::string const& progressNum = args[i].substr(15);
-        cmcmdProgressReport(progressDir, progressNum);
-        }
-      }
-    else if(args[i] == "--normal")
-      {
-      color = cmsysTerminal_Color_Normal;
-      }
-    else if(args[i] == "--black")
-      {
-      color = cmsysTerminal_Color_ForegroundBlack;
-      }
-    else if(args[i] == "--red")
-      {
-      color = cmsysTerminal_Color_ForegroundRed;
-      }
-    else if(args[i] == "--green")
-      {
-      color = cmsysTerminal_Color_ForegroundGreen;
-      }
-    else if(args[i] == "--yellow")
-      {
-      color = cmsysTerminal_Color_ForegroundYellow;
-      }
-    else if(args[i] == "--blue")
-      {
-      color = cmsysTerminal_Color_ForegroundBlue;
-      }
-    else if(args[i] == "--magenta")
-      {
-      color = cmsysTerminal_Color_ForegroundMagenta;
-      }
-    else if(args[i] == "--cyan")
-      {
-      color = cmsysTerminal_Color_ForegroundCyan;
-      }
-    else if(args[i] == "--white")
-      {
-      color = cmsysTerminal_Color_ForegroundWhite;
-      }
-    else if(args[i] == "--bold")
-      {
-      color |= cmsysTerminal_Color_ForegroundBold;
-      }
-    else if(args[i] == "--no-newline")
-      {
-      newline = false;
-      }
-    else if(args[i] == "--newline")
-      {
-      newline = true;
-      }
-    else
-      {
-      // Color is enabled.  Print with the current color.
-      cmSystemTools::MakefileColorEcho(color, args[i].c_str(),
-                                       newline, enabled);
-      }
-    }
-
-  return 0;
+  std::vector<std::string> echoArgs(args.begin() + 2, args.end());
+  return cmEchoColor::Execute(echoArgs);
 }
 
 //----------------------------------------------------------------------------
@@ -0,0 +1,30 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2016 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+
+// Print build rule messages for the Makefile generators.  This takes the
+// same arguments as "cmake -E cmake_echo_color" but links only KWSys, so
+// it starts much faster than cmake for the one message per rule.
+
+#include "cmEchoColor.h"
+
+#include <cmsys/Encoding.hxx>
+
+int main(int ac, char const* const* av)
+{
+  cmsys::Encoding::CommandLineArguments args =
+    cmsys::Encoding::CommandLineArguments::Main(ac, av);
+  ac = args.argc();
+  av = args.argv();
+
+  std::vector<std::string> echoArgs(av + 1, av + ac);
+  return cmEchoColor::Execute(echoArgs);
+}
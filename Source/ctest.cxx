@@ -79,6 +79,12 @@ static const char * cmDocumentationOptions[][2] =
    "Run a specific number of tests by number."},
   {"-U, --union", "Take the Union of -I and -R"},
   {"--rerun-failed", "Run only the tests that failed previously"},
+  {"--cache-results", "Skip tests whose inputs did not change since they "
+   "last passed"},
+  {"--shard <index>/<count>", "Run one of <count> cost-balanced parts "
+   "of the selected tests"},
+  {"--merge-shards <dir>...", "Merge the test results of shards run in "
+   "other build trees"},
   {"--repeat-until-fail <n>", "Require each test to run <n> "
    "times without failing in order to pass"},
   {"--max-width <width>", "Set the max width for a test name to output"},
@@ -103,6 +109,10 @@ static const char * cmDocumentationOptions[][2] =
   {"--test-command", "The test to run with the --build-and-test option."},
   {"--test-timeout", "The time limit in seconds, internal use only."},
   {"--test-load", "CPU load threshold for starting new parallel tests."},
+  {"--resource-pool <name>=<n>[,...]",
+   "Amounts of resources parallel tests may take."},
+  {"--resource-pool-file <file>",
+   "Read resource pool amounts from a file."},
   {"--tomorrow-tag", "Nightly or experimental starts with next day tag."},
   {"--ctest-config", "The configuration file used to initialize CTest state "
    "when submitting dashboards."},
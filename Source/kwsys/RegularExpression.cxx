@@ -179,12 +179,12 @@ bool RegularExpression::deep_equal (const RegularExpression& rxp) const {
  *
  * Regstart and reganch permit very fast decisions on suitable starting points
  * for a match, cutting down the work a lot.  Regmust permits fast rejection
- * of lines that cannot possibly match.  The regmust tests are costly enough
- * that compile() supplies a regmust only if the r.e. contains something
- * potentially expensive (at present, the only such thing detected is * or +
- * at the start of the r.e., which can involve a lot of backup).  Regmlen is
- * supplied because the test in find() needs it and compile() is computing
- * it anyway.
+ * of lines that cannot possibly match.  The regmust test is a single
+ * strstr() pass, so compile() supplies a regmust whenever the r.e. is not
+ * anchored or contains something potentially expensive (* or + at the start
+ * of the r.e., which can involve a lot of backup).  When the regmust is the
+ * literal prefix of the r.e., find() tries matches only where it appears.
+ * Regmlen is supplied because compile() is computing it anyway.
  */
 
 /*
@@ -411,14 +411,14 @@ bool RegularExpression::compile (const char* exp) {
             this->reganch++;
 
          //
-         // If there's something expensive in the r.e., find the longest
-         // literal string that must appear and make it the regmust.  Resolve
-         // ties in favor of later strings, since the regstart check works
-         // with the beginning of the r.e. and avoiding duplication
-         // strengthens checking.  Not a strong reason, but sufficient in the
-         // absence of others.
+         // If there's something expensive in the r.e., or the match may
+         // start anywhere, find the longest literal string that must appear
+         // and make it the regmust.  Resolve ties in favor of later strings,
+         // since the regstart check works with the beginning of the r.e. and
+         // avoiding duplication strengthens checking.  Not a strong reason,
+         // but sufficient in the absence of others.
          //
-        if (flags & SPSTART) {
+        if ((flags & SPSTART) || !this->reganch) {
             longest = 0;
             len = 0;
             for (; scan != 0; scan = regnext(scan))
@@ -903,14 +903,10 @@ bool RegularExpression::find (const char* string) {
     }
 
     // If there is a "must appear" string, look for it.
+    const char* must = 0;
     if (this->regmust != 0) {
-        s = string;
-        while ((s = strchr(s, this->regmust[0])) != 0) {
-            if (strncmp(s, this->regmust, this->regmlen) == 0)
-                break;          // Found it.
-            s++;
-        }
-        if (s == 0)             // Not present.
+        must = strstr(string, this->regmust);
+        if (must == 0)          // Not present.
             return (0);
     }
 
@@ -923,7 +919,15 @@ bool RegularExpression::find (const char* string) {
 
     // Messy cases:  unanchored match.
     s = string;
-    if (this->regstart != '\0')
+    if (must != 0 && OPERAND(OPERAND(this->program + 1)) == this->regmust) {
+        // The "must appear" string is the literal prefix of the r.e.,
+        // so a match can only start where it appears.
+        for (s = must; s != 0; s = strstr(s + 1, this->regmust)) {
+            if (regtry(s, this->startp, this->endp, this->program))
+                return (1);
+        }
+    }
+    else if (this->regstart != '\0')
         // We know what char it must start with.
         while ((s = strchr(s, this->regstart)) != 0) {
             if (regtry(s, this->startp, this->endp, this->program))
@@ -0,0 +1,58 @@
+# Write a synthetic build log and a ctest script scanning it to ${DIR}.
+# See CMakeLists.txt in this directory for the parameters.
+foreach(var DIR LINES)
+  if(NOT DEFINED ${var})
+    message(FATAL_ERROR "${var} is not set")
+  endif()
+endforeach()
+
+file(REMOVE_RECURSE ${DIR})
+file(MAKE_DIRECTORY ${DIR})
+
+# Mostly compile and link lines with some warnings, like the output of
+# a large make build.  There are no errors because ctest -S would fail.
+set(flags "-DNDEBUG -DUSE_FEATURE_A=1 -I/usr/local/include -Isrc/include -O2 -fPIC")
+set(chunk "")
+math(EXPR last "${LINES} / 10 - 1")
+file(WRITE ${DIR}/build.log "")
+foreach(i RANGE ${last})
+  math(EXPR pct "${i} * 100 / (${last} + 1)")
+  math(EXPR dir "${i} % 37")
+  string(APPEND chunk
+    "[${pct}%] Building C object src/dir${dir}/CMakeFiles/lib${dir}.dir/file${i}.c.o\n"
+    "/usr/bin/cc ${flags} -o CMakeFiles/lib${dir}.dir/file${i}.c.o -c /home/user/project/src/dir${dir}/file${i}.c\n"
+    "/home/user/project/src/dir${dir}/file${i}.c: In function 'compute_${i}':\n"
+    "/home/user/project/src/dir${dir}/file${i}.c:${dir}:5: warning: unused variable 'tmp' [-Wunused-variable]\n"
+    "     int tmp = ${i};\n"
+    "         ^\n"
+    "[${pct}%] Linking C static library liblib${dir}.a\n"
+    "/usr/bin/ar qc liblib${dir}.a CMakeFiles/lib${dir}.dir/file${i}.c.o\n"
+    "/usr/bin/ranlib liblib${dir}.a\n"
+    "[${pct}%] Built target lib${dir}\n"
+    )
+  math(EXPR flush "${i} % 500")
+  if(flush EQUAL 0)
+    file(APPEND ${DIR}/build.log "${chunk}")
+    set(chunk "")
+  endif()
+endforeach()
+file(APPEND ${DIR}/build.log "${chunk}")
+
+# The build command prints the log.  ctest_build then matches every line
+# against its error and warning expressions.
+file(WRITE ${DIR}/print.cmake "
+file(READ \"${DIR}/build.log\" log)
+message(\"\${log}\")
+")
+file(WRITE ${DIR}/scan.cmake "
+set(CTEST_SITE benchmark)
+set(CTEST_BUILD_NAME regex)
+set(CTEST_SOURCE_DIRECTORY \"${DIR}\")
+set(CTEST_BINARY_DIRECTORY \"${DIR}\")
+set(CTEST_BUILD_COMMAND \"\\\"${CMAKE_COMMAND}\\\" -P \\\"${DIR}/print.cmake\\\"\")
+ctest_start(Experimental)
+ctest_build(NUMBER_ERRORS errors NUMBER_WARNINGS warnings)
+if(NOT errors EQUAL 0 OR NOT warnings GREATER 0)
+  message(FATAL_ERROR \"Found \${errors} errors and \${warnings} warnings\")
+endif()
+")
@@ -0,0 +1,103 @@
+# Write a synthetic project to ${DIR}/src and empty ${DIR}/build.
+# See CMakeLists.txt in this directory for the parameters.
+foreach(var DIR DIRS TARGETS SOURCES DEPTH PACKAGES)
+  if(NOT DEFINED ${var})
+    message(FATAL_ERROR "${var} is not set")
+  endif()
+endforeach()
+
+set(src ${DIR}/src)
+file(REMOVE_RECURSE ${DIR}/src ${DIR}/build)
+file(MAKE_DIRECTORY ${DIR}/build)
+
+# Packages found in config mode through CMAKE_PREFIX_PATH.
+set(packages "")
+if(PACKAGES GREATER 0)
+  math(EXPR last "${PACKAGES} - 1")
+  foreach(p RANGE ${last})
+    set(pkg ${src}/packages/Pkg${p})
+    file(WRITE ${pkg}/Pkg${p}Config.cmake "
+if(NOT TARGET Pkg${p}::pkg)
+  add_library(Pkg${p}::pkg INTERFACE IMPORTED)
+  set_target_properties(Pkg${p}::pkg PROPERTIES
+    INTERFACE_COMPILE_DEFINITIONS PKG${p}
+    INTERFACE_INCLUDE_DIRECTORIES \"\${CMAKE_CURRENT_LIST_DIR}/include\")
+endif()
+")
+    file(WRITE ${pkg}/Pkg${p}ConfigVersion.cmake "
+set(PACKAGE_VERSION 1.${p})
+if(PACKAGE_FIND_VERSION VERSION_GREATER PACKAGE_VERSION)
+  set(PACKAGE_VERSION_COMPATIBLE FALSE)
+else()
+  set(PACKAGE_VERSION_COMPATIBLE TRUE)
+endif()
+")
+    file(MAKE_DIRECTORY ${pkg}/include)
+    list(APPEND packages Pkg${p})
+  endforeach()
+endif()
+
+# Top-level project with the chain of INTERFACE libraries.
+set(top "cmake_minimum_required(VERSION 3.0)
+project(Benchmark C)
+list(APPEND CMAKE_PREFIX_PATH \"\${CMAKE_CURRENT_SOURCE_DIR}/packages\")
+")
+foreach(pkg IN LISTS packages)
+  set(top "${top}find_package(${pkg} 1.0 REQUIRED CONFIG)\n")
+endforeach()
+set(chain "")
+if(DEPTH GREATER 0)
+  math(EXPR last "${DEPTH} - 1")
+  foreach(c RANGE ${last})
+    file(MAKE_DIRECTORY ${src}/include/chain${c})
+    set(top "${top}add_library(chain${c} INTERFACE)
+target_compile_definitions(chain${c} INTERFACE CHAIN${c}=${c})
+target_include_directories(chain${c} INTERFACE
+  \"\${CMAKE_CURRENT_SOURCE_DIR}/include/chain${c}\")
+")
+    if(chain)
+      set(top "${top}target_link_libraries(chain${c} INTERFACE ${chain})\n")
+    endif()
+    set(chain chain${c})
+  endforeach()
+endif()
+
+# Subdirectories of libraries that link the chain, a package and the
+# previous library, plus one executable each.
+math(EXPR last_dir "${DIRS} - 1")
+math(EXPR last_target "${TARGETS} - 1")
+math(EXPR last_source "${SOURCES} - 1")
+list(LENGTH packages num_packages)
+foreach(d RANGE ${last_dir})
+  set(sub "")
+  set(previous "")
+  foreach(t RANGE ${last_target})
+    set(lib d${d}_t${t})
+    set(sources "")
+    foreach(s RANGE ${last_source})
+      file(WRITE ${src}/dir${d}/${lib}_s${s}.c
+        "int ${lib}_s${s}(void) { return ${s}; }\n")
+      list(APPEND sources ${lib}_s${s}.c)
+    endforeach()
+    string(REPLACE ";" " " sources "${sources}")
+    set(sub "${sub}add_library(${lib} STATIC ${sources})\n")
+    set(deps ${chain} ${previous})
+    if(num_packages GREATER 0)
+      math(EXPR p "(${d} * ${TARGETS} + ${t}) % ${num_packages}")
+      list(GET packages ${p} pkg)
+      list(APPEND deps ${pkg}::pkg)
+    endif()
+    if(deps)
+      string(REPLACE ";" " " deps "${deps}")
+      set(sub "${sub}target_link_libraries(${lib} PUBLIC ${deps})\n")
+    endif()
+    set(previous ${lib})
+  endforeach()
+  file(WRITE ${src}/dir${d}/main.c "int main(void) { return 0; }\n")
+  set(sub "${sub}add_executable(d${d}_exe main.c)
+target_link_libraries(d${d}_exe ${previous})
+")
+  file(WRITE ${src}/dir${d}/CMakeLists.txt "${sub}")
+  set(top "${top}add_subdirectory(dir${d})\n")
+endforeach()
+file(WRITE ${src}/CMakeLists.txt "${top}")
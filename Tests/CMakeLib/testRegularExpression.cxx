@@ -0,0 +1,66 @@
+/*============================================================================
+  CMake - Cross Platform Makefile Generator
+  Copyright 2000-2009 Kitware, Inc., Insight Software Consortium
+
+  Distributed under the OSI-approved BSD License (the "License");
+  see accompanying file Copyright.txt for details.
+
+  This software is distributed WITHOUT ANY WARRANTY; without even the
+  implied warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.
+  See the License for more information.
+============================================================================*/
+#include "cmStandardIncludes.h"
+
+#include <cmsys/RegularExpression.hxx>
+
+struct test_case
+{
+  const char* regex;
+  const char* input;
+  int start; // -1 if there is no match
+  int end;
+};
+
+// Cases for the literal that find() requires before trying a match.
+static test_case const cases[] = {
+  // The literal prefix occurs overlapping itself before the match.
+  {"abab(c)", "abababc", 2, 7},
+  {"aa(b)", "aaab", 1, 4},
+  {"aa(b)", "aaaa", -1, -1},
+  // The required literal is at the very end of the input.
+  {"foo(bar)", "xxfoobar", 2, 8},
+  {"([0-9]+)error", "x 12error", 2, 9},
+  {"x(y|z)*end", "xyzyend", 0, 7},
+  {"x(y|z)*end", "xyzyen", -1, -1},
+  // The required literal is not a prefix and occurs more than once.
+  {"[a-z]+:([0-9]+): error", "a b.c:1: note b.c:12: error", 16, 27},
+  {"([^ :]+):([0-9]+): error", "file.c:12: warning: x", -1, -1},
+  {"(foo|bar)baz", "foobarbaz", 3, 9},
+  // Anchored expressions still match only at the start or end.
+  {"^abc", "xabc", -1, -1},
+  {"^abc", "abcx", 0, 3},
+  {"^(ab)+c", "zababc", -1, -1},
+  {"^(ab)+c", "ababc", 0, 5},
+  {"abc$", "abcabc", 3, 6},
+  {"abc$", "abcab", -1, -1},
+  {0, 0, 0, 0}
+};
+
+int testRegularExpression(int, char*[])
+{
+  int result = 0;
+  for(test_case const* c = cases; c->regex; ++c)
+    {
+    cmsys::RegularExpression re(c->regex);
+    bool found = re.find(c->input);
+    int start = found? static_cast<int>(re.start()) : -1;
+    int end = found? static_cast<int>(re.end()) : -1;
+    if(start != c->start || end != c->end)
+      {
+      printf("\"%s\" on \"%s\": expected [%d,%d), got [%d,%d)\n",
+             c->regex, c->input, c->start, c->end, start, end);
+      result = 1;
+      }
+    }
+  return result;
+}
@@ -0,0 +1,2 @@
+#include <MakeDependsCompiler.h>
+int main(void) { return MakeDependsCompiler(); }
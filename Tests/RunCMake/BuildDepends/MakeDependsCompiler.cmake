@@ -0,0 +1,19 @@
+enable_language(C)
+set(CMAKE_DEPENDS_USE_COMPILER 1)
+include_directories(${CMAKE_CURRENT_BINARY_DIR})
+add_executable(MakeDependsCompiler MakeDependsCompiler.c)
+
+if(CMAKE_MAKE_DEPFILE_FLAGS_C)
+  set(depfile "${CMAKE_CURRENT_BINARY_DIR}/CMakeFiles/MakeDependsCompiler.dir/MakeDependsCompiler.c${CMAKE_C_OUTPUT_EXTENSION}.d")
+  set(check_depfile "\"${depfile}|${CMAKE_CURRENT_SOURCE_DIR}/MakeDependsCompiler.c\"")
+endif()
+
+file(GENERATE OUTPUT check-$<LOWER_CASE:$<CONFIG>>.cmake CONTENT "
+set(check_pairs
+  \"$<TARGET_FILE:MakeDependsCompiler>|${CMAKE_CURRENT_BINARY_DIR}/MakeDependsCompiler.h\"
+  ${check_depfile}
+  )
+set(check_exes
+  \"$<TARGET_FILE:MakeDependsCompiler>\"
+  )
+")
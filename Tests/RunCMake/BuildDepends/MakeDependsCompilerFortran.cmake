@@ -0,0 +1,18 @@
+enable_language(Fortran)
+set(CMAKE_DEPENDS_USE_COMPILER 1)
+
+# List the user of the module first so that only the module
+# dependencies found by the scanner order the objects.
+add_executable(MakeDependsCompilerFortran
+  MakeDependsCompilerFortran.f90
+  ${CMAKE_CURRENT_BINARY_DIR}/MakeDependsCompilerFortranMod.f90
+  )
+
+file(GENERATE OUTPUT check-$<LOWER_CASE:$<CONFIG>>.cmake CONTENT "
+set(check_pairs
+  \"$<TARGET_FILE:MakeDependsCompilerFortran>|${CMAKE_CURRENT_BINARY_DIR}/MakeDependsCompilerFortranMod.f90\"
+  )
+set(check_exes
+  \"$<TARGET_FILE:MakeDependsCompilerFortran>\"
+  )
+")
@@ -0,0 +1,4 @@
+program MakeDependsCompilerFortran
+  use MakeDependsCompilerFortranMod
+  stop MakeDependsCompilerFortranValue
+end program
@@ -0,0 +1,5 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeDependsCompilerFortranMod.f90" [[
+module MakeDependsCompilerFortranMod
+  integer, parameter :: MakeDependsCompilerFortranValue = 2
+end module
+]])
@@ -0,0 +1,3 @@
+if(actual_stdout MATCHES "(Generating|Building|Linking) [^\n]*")
+  set(RunCMake_TEST_FAILED "A build with nothing to do ran:\n  ${CMAKE_MATCH_0}")
+endif()
@@ -0,0 +1,14 @@
+set(makefile2 "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/Makefile2")
+file(READ "${makefile2}" content)
+foreach(target MakeFlat MakeFlatLib MakeFlatTool)
+  if(NOT content MATCHES "\ninclude CMakeFiles/${target}\\.dir/build\\.make\n")
+    set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}
+ '${makefile2}' does not include the rules of target ${target}
+")
+  endif()
+endforeach()
+if(content MATCHES "MAKE\\) -f CMakeFiles/MakeFlat")
+  set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}
+ '${makefile2}' builds target rules recursively
+")
+endif()
@@ -0,0 +1,4 @@
+#include <MakeFlat.h>
+#include <MakeFlatTool.h>
+extern int MakeFlatLib(void);
+int main(void) { return (MakeFlatLib() + MAKE_FLAT) / 2; }
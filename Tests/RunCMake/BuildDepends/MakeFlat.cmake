@@ -0,0 +1,33 @@
+enable_language(C)
+set(CMAKE_FLAT_MAKEFILES 1)
+
+add_custom_command(OUTPUT ${CMAKE_CURRENT_BINARY_DIR}/MakeFlat.h
+  COMMAND ${CMAKE_COMMAND} -E copy ${CMAKE_CURRENT_BINARY_DIR}/MakeFlat.h.in
+                                   ${CMAKE_CURRENT_BINARY_DIR}/MakeFlat.h
+  DEPENDS ${CMAKE_CURRENT_BINARY_DIR}/MakeFlat.h.in
+  )
+add_library(MakeFlatLib STATIC MakeFlatLib.c ${CMAKE_CURRENT_BINARY_DIR}/MakeFlat.h)
+target_include_directories(MakeFlatLib PUBLIC ${CMAKE_CURRENT_BINARY_DIR})
+
+add_custom_target(MakeFlatTool
+  COMMAND ${CMAKE_COMMAND} -E copy_if_different
+          ${CMAKE_CURRENT_BINARY_DIR}/MakeFlat.h.in
+          ${CMAKE_CURRENT_BINARY_DIR}/MakeFlatTool.h
+  BYPRODUCTS ${CMAKE_CURRENT_BINARY_DIR}/MakeFlatTool.h
+  )
+
+add_executable(MakeFlat MakeFlat.c)
+target_link_libraries(MakeFlat MakeFlatLib)
+add_dependencies(MakeFlat MakeFlatTool)
+
+file(GENERATE OUTPUT check-$<LOWER_CASE:$<CONFIG>>.cmake CONTENT "
+set(check_pairs
+  \"$<TARGET_FILE:MakeFlat>|${CMAKE_CURRENT_BINARY_DIR}/MakeFlat.h.in\"
+  \"$<TARGET_FILE:MakeFlat>|${CMAKE_CURRENT_BINARY_DIR}/MakeFlatTool.h\"
+  \"$<TARGET_FILE:MakeFlatLib>|${CMAKE_CURRENT_BINARY_DIR}/MakeFlat.h\"
+  )
+set(check_exes
+  \"$<TARGET_FILE:MakeFlat>\"
+  )
+set(check_stdout_exclude \"make\\\\[[2-9]\\\\]\")
+")
@@ -0,0 +1,3 @@
+file(WRITE "${RunCMake_TEST_BINARY_DIR}/MakeFlat.h.in" [[
+#define MAKE_FLAT 2
+]])
@@ -0,0 +1,2 @@
+#include <MakeFlat.h>
+int MakeFlatLib(void) { return MAKE_FLAT; }
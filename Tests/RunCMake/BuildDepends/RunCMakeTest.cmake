@@ -47,6 +47,19 @@ if(RunCMake_GENERATOR MATCHES "Make" AND
   run_BuildDepends(MakeInProjectOnly)
 endif()
 
+if(RunCMake_GENERATOR MATCHES "^(Unix|MSYS|MinGW) Makefiles$")
+  run_BuildDepends(MakeDependsCompiler)
+  if(CMake_TEST_Fortran)
+    run_BuildDepends(MakeDependsCompilerFortran)
+  endif()
+  run_BuildDepends(MakeFlat)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/MakeFlat-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  run_cmake_command(MakeFlat-build3 ${CMAKE_COMMAND} --build . --config Debug)
+  unset(RunCMake_TEST_BINARY_DIR)
+  unset(RunCMake_TEST_NO_CLEAN)
+endif()
+
 function(run_ReGeneration)
   # test re-generation of project even if CMakeLists.txt files disappeared
 
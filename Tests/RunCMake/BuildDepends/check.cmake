@@ -3,6 +3,11 @@ if(EXISTS ${RunCMake_TEST_BINARY_DIR}/check-debug.cmake)
   if(RunCMake_TEST_FAILED)
     return()
   endif()
+  if(check_stdout_exclude AND actual_stdout MATCHES "${check_stdout_exclude}")
+    set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}
+ build output contains '${CMAKE_MATCH_0}'
+")
+  endif()
   foreach(exe IN LISTS check_exes)
     execute_process(COMMAND ${exe} RESULT_VARIABLE res)
     if(NOT res EQUAL ${check_step})
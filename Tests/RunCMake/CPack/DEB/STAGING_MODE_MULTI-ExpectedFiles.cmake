@@ -0,0 +1,3 @@
+set(EXPECTED_FILES_COUNT "1")
+set(EXPECTED_FILE_1 "staging_mode_multi*.deb")
+set(EXPECTED_FILE_CONTENT_1 "^.*/usr/foo/appended.txt\n.*/usr/foo/plain.txt\n.*/usr/foo/staging_exe$")
@@ -0,0 +1,65 @@
+# TBZ2 reused the TGZ staging tree; DEB staged on its own.
+string(REGEX MATCHALL "Reuse staged install" reused "${output}")
+list(LENGTH reused reused_count)
+if(NOT reused_count EQUAL 1)
+  message(FATAL_ERROR "Expected one reused staging tree."
+    "${output_error_message}")
+endif()
+foreach(ext tar.gz tar.bz2)
+  file(GLOB archive "${bin_dir}/staging_mode_multi*.${ext}")
+  if(NOT archive)
+    message(FATAL_ERROR "No ${ext} package generated.${output_error_message}")
+  endif()
+endforeach()
+
+function(get_inode file var)
+  execute_process(COMMAND stat -c %i "${file}"
+    OUTPUT_VARIABLE inode OUTPUT_STRIP_TRAILING_WHITESPACE)
+  set(${var} "${inode}" PARENT_SCOPE)
+endfunction()
+
+set(packages "${bin_dir}/_CPack_Packages")
+file(GLOB_RECURSE staged_files "${packages}/*")
+list(FILTER staged_files INCLUDE REGEX "/foo/[^/]+$")
+if(NOT staged_files)
+  message(FATAL_ERROR "No staged files found in '${packages}'.")
+endif()
+
+# Files are hard linked unless the file system can clone them.
+get_inode("${bin_dir}/plain.txt" plain_inode)
+execute_process(COMMAND cp --reflink=always
+  "${bin_dir}/plain.txt" "${bin_dir}/reflink-probe.txt"
+  RESULT_VARIABLE reflink_result OUTPUT_QUIET ERROR_QUIET)
+file(REMOVE "${bin_dir}/reflink-probe.txt")
+foreach(staged IN LISTS staged_files)
+  get_filename_component(name "${staged}" NAME)
+  if(name STREQUAL "plain.txt")
+    get_inode("${staged}" staged_inode)
+    if(NOT reflink_result EQUAL 0 AND NOT staged_inode STREQUAL plain_inode)
+      message(FATAL_ERROR "'${staged}' is not a hard link to plain.txt.")
+    endif()
+  elseif(name STREQUAL "appended.txt")
+    file(READ "${staged}" content)
+    if(NOT content STREQUAL "original\nappended\n")
+      message(FATAL_ERROR "Unexpected content of '${staged}': '${content}'")
+    endif()
+  endif()
+endforeach()
+
+# Writes in the staging tree do not reach the build tree.
+file(READ "${bin_dir}/appended.txt" content)
+if(NOT content STREQUAL "original\n")
+  message(FATAL_ERROR "appended.txt in the build tree was modified: '${content}'")
+endif()
+file(READ "${bin_dir}/exe_inode.txt" exe_inode)
+string(STRIP "${exe_inode}" exe_inode)
+get_inode("${bin_dir}/staging_exe" inode)
+if(NOT inode STREQUAL exe_inode)
+  message(FATAL_ERROR "staging_exe in the build tree was replaced.")
+endif()
+file(READ "${bin_dir}/exe_md5.txt" exe_md5)
+string(REGEX REPLACE " .*" "" exe_md5 "${exe_md5}")
+file(MD5 "${bin_dir}/staging_exe" md5)
+if(NOT md5 STREQUAL exe_md5)
+  message(FATAL_ERROR "staging_exe in the build tree was modified.")
+endif()
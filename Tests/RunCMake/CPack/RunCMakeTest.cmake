@@ -12,3 +12,6 @@ run_cpack_test(EMPTY_DIR "RPM;DEB;TGZ" true)
 run_cpack_test(COMPONENTS_EMPTY_DIR "RPM;DEB;TGZ" true)
 run_cpack_test(PER_COMPONENT_FIELDS "RPM;DEB" false)
 run_cpack_test(INSTALL_SCRIPTS "RPM" false)
+run_cpack_test(THREADED "TGZ;TBZ2;TXZ" false)
+run_cpack_test(STAGING_MODE "TGZ" false)
+run_cpack_test(STAGING_MODE_MULTI "DEB" true)
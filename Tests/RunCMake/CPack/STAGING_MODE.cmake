@@ -0,0 +1,4 @@
+install(FILES CMakeLists.txt DESTINATION foo COMPONENT test)
+
+set(CPACK_PACKAGE_NAME "staging_mode")
+set(CPACK_STAGING_MODE LINK)
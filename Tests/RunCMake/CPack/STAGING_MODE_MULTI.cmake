@@ -0,0 +1,34 @@
+# Several generators in one cpack run with hard-link staging.  TBZ2
+# reuses the staging tree of TGZ while DEB, which installs to another
+# prefix, stages on its own.
+set(CPACK_GENERATOR "TGZ;TBZ2;DEB")
+
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/plain.txt" "plain\n")
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/appended.txt" "original\n")
+install(FILES
+  "${CMAKE_CURRENT_BINARY_DIR}/plain.txt"
+  "${CMAKE_CURRENT_BINARY_DIR}/appended.txt"
+  DESTINATION foo COMPONENT test)
+install(CODE [[
+file(APPEND "$ENV{DESTDIR}${CMAKE_INSTALL_PREFIX}/foo/appended.txt" "appended\n")
+]] COMPONENT test)
+
+# The executable's RPATH is rewritten when it is installed.  Record its
+# inode and hash after linking to check that the build tree keeps them.
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/lib.cpp" "int lib() { return 0; }\n")
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/main.cpp"
+  "int lib();\nint main() { return lib(); }\n")
+add_library(staging_lib SHARED "${CMAKE_CURRENT_BINARY_DIR}/lib.cpp")
+add_executable(staging_exe "${CMAKE_CURRENT_BINARY_DIR}/main.cpp")
+target_link_libraries(staging_exe staging_lib)
+set_property(TARGET staging_exe PROPERTY INSTALL_RPATH "/opt/staging/lib")
+add_custom_command(TARGET staging_exe POST_BUILD
+  COMMAND stat -c %i $<TARGET_FILE:staging_exe> > exe_inode.txt
+  COMMAND ${CMAKE_COMMAND} -E md5sum $<TARGET_FILE:staging_exe> > exe_md5.txt
+  WORKING_DIRECTORY "${CMAKE_CURRENT_BINARY_DIR}"
+  )
+install(TARGETS staging_exe DESTINATION foo COMPONENT test)
+
+set(CPACK_PACKAGE_NAME "staging_mode_multi")
+set(CPACK_STAGING_MODE LINK)
+set(CPACK_PACKAGE_CONTACT "someone")
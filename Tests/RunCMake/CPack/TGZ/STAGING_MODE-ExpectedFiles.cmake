@@ -0,0 +1,3 @@
+set(EXPECTED_FILES_COUNT "1")
+set(EXPECTED_FILE_1 "staging_mode*.tar.gz")
+set(EXPECTED_FILE_CONTENT_1 "^[^\n]*staging_mode-0.1.1-[^\n]*/foo/\n[^\n]*staging_mode-0.1.1-[^\n]*/foo/CMakeLists.txt$")
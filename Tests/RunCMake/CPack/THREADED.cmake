@@ -0,0 +1,18 @@
+install(FILES CMakeLists.txt DESTINATION foo COMPONENT test)
+
+# The file is larger than the biggest compression block (8 MiB for
+# xz) so that the archive spans several blocks.  It sorts before
+# CMakeLists.txt, whose header therefore lives in a later block.
+set(line "0123456789abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ\n")
+set(mib "${line}")
+foreach(i RANGE 1 14)
+  set(mib "${mib}${mib}")
+endforeach()
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/Big.txt"
+  "${mib}${mib}${mib}${mib}${mib}${mib}${mib}${mib}${mib}")
+unset(mib)
+install(FILES "${CMAKE_CURRENT_BINARY_DIR}/Big.txt"
+  DESTINATION foo COMPONENT test)
+
+set(CPACK_PACKAGE_NAME "threaded")
+set(CPACK_THREADS 2)
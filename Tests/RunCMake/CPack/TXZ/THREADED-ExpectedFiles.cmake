@@ -0,0 +1,3 @@
+set(EXPECTED_FILES_COUNT "1")
+set(EXPECTED_FILE_1 "threaded*.tar.xz")
+set(EXPECTED_FILE_CONTENT_1 "^[^\n]*threaded-0.1.1-[^\n]*/foo/\n[^\n]* 9289728 [^\n]*threaded-0.1.1-[^\n]*/foo/Big.txt\n[^\n]*threaded-0.1.1-[^\n]*/foo/CMakeLists.txt$")
@@ -0,0 +1,19 @@
+# "make -j2" has one token beyond the slot ctest runs in, so no more
+# than two of the tests may run at once although ctest was given -j4.
+# Two should, to show that ctest takes the token.
+file(GLOB counts "${RunCMake_TEST_BINARY_DIR}/count-*")
+list(LENGTH counts n)
+if(NOT n EQUAL 6)
+  set(RunCMake_TEST_FAILED "Expected 6 count files, found ${n}.")
+  return()
+endif()
+set(max 0)
+foreach(f IN LISTS counts)
+  file(READ "${f}" count)
+  if(count GREATER max)
+    set(max ${count})
+  endif()
+endforeach()
+if(NOT max EQUAL 2)
+  set(RunCMake_TEST_FAILED "Expected 2 tests to run at once, but up to ${max} did.")
+endif()
@@ -0,0 +1,9 @@
+enable_testing()
+
+# Each test records how many tests were running while it ran.
+foreach(t 1 2 3 4 5 6)
+  add_test(NAME Jobserver${t} COMMAND ${CMAKE_COMMAND}
+    -DDIR=${CMAKE_CURRENT_BINARY_DIR}/running -DNAME=${t}
+    -P ${CMAKE_CURRENT_SOURCE_DIR}/Jobserver-test.cmake
+    )
+endforeach()
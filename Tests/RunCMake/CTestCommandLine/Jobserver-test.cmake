@@ -0,0 +1,7 @@
+file(WRITE "${DIR}/${NAME}" "")
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+file(GLOB running "${DIR}/*")
+list(LENGTH running count)
+file(WRITE "${DIR}/../count-${NAME}" "${count}")
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+file(REMOVE "${DIR}/${NAME}")
@@ -0,0 +1,7 @@
+# Fail if another test taking the same resources is running.
+if(EXISTS running)
+  message(FATAL_ERROR "tests sharing a resource pool ran at once")
+endif()
+file(WRITE running "")
+execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+file(REMOVE running)
@@ -140,3 +140,174 @@ function(run_TestOutputSize)
     )
 endfunction()
 run_TestOutputSize()
+
+run_cmake_command(resource-pool-bad
+  ${CMAKE_CTEST_COMMAND} --resource-pool memory_gb
+  )
+
+function(run_ResourcePool)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ResourcePool)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  add_test(ResourcePool1 \"${CMAKE_COMMAND}\" -P \"${RunCMake_SOURCE_DIR}/ResourcePool.cmake\")
+  add_test(ResourcePool2 \"${CMAKE_COMMAND}\" -P \"${RunCMake_SOURCE_DIR}/ResourcePool.cmake\")
+  set_tests_properties(ResourcePool1 ResourcePool2 PROPERTIES RESOURCES \"memory_gb:6\")
+")
+  run_cmake_command(ResourcePool
+    ${CMAKE_CTEST_COMMAND} -j2 --resource-pool memory_gb=8
+    )
+endfunction()
+run_ResourcePool()
+
+function(run_CriticalPath)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/CriticalPath)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  add_test(Big1 \"${CMAKE_COMMAND}\" -E echo Big1)
+  add_test(Big2 \"${CMAKE_COMMAND}\" -E echo Big2)
+  add_test(ChainA \"${CMAKE_COMMAND}\" -E echo ChainA)
+  add_test(ChainB \"${CMAKE_COMMAND}\" -E echo ChainB)
+  add_test(ChainC \"${CMAKE_COMMAND}\" -E echo ChainC)
+  set_tests_properties(ChainB PROPERTIES DEPENDS ChainA)
+  set_tests_properties(ChainC PROPERTIES DEPENDS ChainB)
+")
+  # The chain head is the cheapest test but heads the longest chain.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt" "Big1 1 3
+Big2 1 3
+ChainA 1 1
+ChainB 1 3
+ChainC 1 3
+---
+")
+  run_cmake_command(CriticalPath ${CMAKE_CTEST_COMMAND} -j2 -V)
+endfunction()
+run_CriticalPath()
+
+function(run_Jobserver)
+  # The test target of the Makefile generators passes the jobserver of
+  # an enclosing GNU make to ctest.
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Jobserver-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+
+  run_cmake(Jobserver-cmake)
+  run_cmake_command(Jobserver ${CMAKE_COMMAND} --build . --target test
+    -- -j2 "ARGS=-j4 -V"
+    )
+endfunction()
+if(RunCMake_GENERATOR MATCHES "^(Unix|MSYS|MinGW) Makefiles$")
+  run_Jobserver()
+endif()
+
+function(run_TestOutputSpill)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestOutputSpill)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  add_test(SpillTest \"${CMAKE_COMMAND}\" -P \"${RunCMake_SOURCE_DIR}/TestOutputSpill.cmake\")
+  set_tests_properties(SpillTest PROPERTIES FAIL_REGULAR_EXPRESSION \"MiddleMarker\")
+")
+  run_cmake_command(TestOutputSpill
+    ${CMAKE_CTEST_COMMAND} -M Experimental -T Test --output-on-failure
+                           --test-output-size-passed 100
+                           --test-output-size-failed 200
+    )
+endfunction()
+run_TestOutputSpill()
+
+function(run_TestOutputSpillMatch)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/TestOutputSpillMatch)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  # A CDash version of 1.6 or later turns on output compression.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/DartConfiguration.tcl" "
+CDashVersion: 1.6
+")
+  # The pass expression spans two lines written after the output spilled
+  # and the anchored fail expression matches no line but the first.
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  add_test(SpillMatch \"${CMAKE_COMMAND}\" -P \"${RunCMake_SOURCE_DIR}/TestOutputSpillMatch.cmake\")
+  set_tests_properties(SpillMatch PROPERTIES
+    PASS_REGULAR_EXPRESSION \"Line 40 [^\\n]*\\nLine 41 \"
+    FAIL_REGULAR_EXPRESSION \"^Line 50\")
+")
+  run_cmake_command(TestOutputSpillMatch
+    ${CMAKE_CTEST_COMMAND} -M Experimental -T Test
+                           --test-output-size-passed 100
+                           --test-output-size-failed 200
+    )
+endfunction()
+run_TestOutputSpillMatch()
+
+run_cmake_command(shard-bad
+  ${CMAKE_CTEST_COMMAND} --shard 3/2
+  )
+
+function(run_Shard)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  foreach(dir Shard1 Shard2 ShardMerge)
+    set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/${dir})
+    file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+    file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+    file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  add_test(A \"${CMAKE_COMMAND}\" -E echo A)
+  add_test(B \"${CMAKE_COMMAND}\" -E echo B)
+  add_test(C \"${CMAKE_COMMAND}\" -E echo C)
+  add_test(D \"${CMAKE_COMMAND}\" -E echo D)
+  add_test(E \"${CMAKE_COMMAND}\" -E no_such_command)
+  add_test(F \"${CMAKE_COMMAND}\" -E echo F)
+")
+    # Both shards see the same costs and agree on A,D,E and B,C,F.
+    file(WRITE "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt" "A 1 5
+B 1 4
+C 1 3
+D 1 3
+E 1 1
+F 1 2
+---
+")
+  endforeach()
+
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Shard1)
+  run_cmake_command(Shard1 ${CMAKE_CTEST_COMMAND} -T Test --shard 1/2)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/Shard2)
+  run_cmake_command(Shard2 ${CMAKE_CTEST_COMMAND} -T Test --shard 2/2)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/ShardMerge)
+  file(REMOVE "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt")
+  run_cmake_command(ShardMerge ${CMAKE_CTEST_COMMAND} --merge-shards
+    ${RunCMake_BINARY_DIR}/Shard1 ${RunCMake_BINARY_DIR}/Shard2
+    )
+  run_cmake_command(ShardMergeDuplicate ${CMAKE_CTEST_COMMAND} --merge-shards
+    ${RunCMake_BINARY_DIR}/Shard1 ${RunCMake_BINARY_DIR}/Shard1
+    )
+endfunction()
+run_Shard()
+
+function(run_CacheResults)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/CacheResults)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/input.txt" "1")
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" "
+  add_test(A \"${CMAKE_COMMAND}\" -E echo A)
+  set_tests_properties(A PROPERTIES INPUTS \"${RunCMake_TEST_BINARY_DIR}/input.txt\")
+  add_test(B \"${CMAKE_COMMAND}\" -E echo B)
+  set_tests_properties(B PROPERTIES INPUTS \"${RunCMake_TEST_BINARY_DIR}/input.txt;${CMAKE_COMMAND}\")
+  add_test(C \"${CMAKE_COMMAND}\" -E echo C)
+  add_test(D \"${CMAKE_COMMAND}\" -E no_such_command)
+  set_tests_properties(D PROPERTIES INPUTS \"${RunCMake_TEST_BINARY_DIR}/input.txt\")
+")
+  run_cmake_command(CacheResults1 ${CMAKE_CTEST_COMMAND} --cache-results)
+  run_cmake_command(CacheResults2 ${CMAKE_CTEST_COMMAND} --cache-results)
+  file(WRITE "${RunCMake_TEST_BINARY_DIR}/input.txt" "2")
+  run_cmake_command(CacheResults3 ${CMAKE_CTEST_COMMAND} --cache-results)
+endfunction()
+run_CacheResults()
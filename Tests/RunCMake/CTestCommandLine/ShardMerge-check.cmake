@@ -0,0 +1,15 @@
+file(GLOB test_xml_file "${RunCMake_TEST_BINARY_DIR}/Testing/*/Test.xml")
+if(test_xml_file)
+  file(READ "${test_xml_file}" test_xml)
+  string(REGEX MATCHALL "<Test Status=\"[a-z]+\">[\n\t]*<Name>[A-Z]</Name>" tests "${test_xml}")
+  string(REGEX REPLACE "<Test Status=\"([a-z]+)\">[\n\t]*<Name>([A-Z])</Name>" "\\2:\\1" tests "${tests}")
+  if(NOT "${tests}" STREQUAL "A:passed;D:passed;E:failed;B:passed;C:passed;F:passed")
+    set(RunCMake_TEST_FAILED "Test.xml does not contain the results of both shards:\n ${tests}")
+  endif()
+else()
+  set(RunCMake_TEST_FAILED "Test.xml not found")
+endif()
+file(READ "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestCostData.txt" cost_data)
+if(NOT cost_data MATCHES "^A 2 [^\n]*\nB 2 [^\n]*\nC 2 [^\n]*\nD 2 [^\n]*\nE 1 [^\n]*\nF 2 [^\n]*\n---\nE\n$")
+  set(RunCMake_TEST_FAILED "${RunCMake_TEST_FAILED}\nCost data not merged:\n${cost_data}")
+endif()
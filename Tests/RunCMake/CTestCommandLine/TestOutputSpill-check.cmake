@@ -0,0 +1,15 @@
+set(spill_file "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/TestOutput_1.log")
+file(GLOB test_log "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/LastTest_*.log")
+if(NOT EXISTS "${spill_file}")
+  set(RunCMake_TEST_FAILED "Spilled test output not kept:\n ${spill_file}")
+elseif(NOT test_log)
+  set(RunCMake_TEST_FAILED "LastTest log not found")
+else()
+  file(READ "${spill_file}" spill)
+  file(READ "${test_log}" log)
+  foreach(text spill log)
+    if(NOT "${${text}}" MATCHES "Line 29 [^\n]*\nMiddleMarker\nLine 30 .*Line 60 ")
+      set(RunCMake_TEST_FAILED "Full output not found in ${text}:\n ${${text}}")
+    endif()
+  endforeach()
+endif()
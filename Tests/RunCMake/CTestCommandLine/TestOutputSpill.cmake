@@ -0,0 +1,6 @@
+foreach(i RANGE 1 60)
+  if(i EQUAL 30)
+    message("MiddleMarker")
+  endif()
+  message("Line ${i} of output that is long enough to spill to a file")
+endforeach()
@@ -0,0 +1,13 @@
+file(GLOB test_xml_file "${RunCMake_TEST_BINARY_DIR}/Testing/*/Test.xml")
+if(test_xml_file)
+  file(READ "${test_xml_file}" test_xml)
+  if(NOT test_xml MATCHES "<Test Status=\"passed\">[\n\t]*<Name>SpillMatch</Name>")
+    set(RunCMake_TEST_FAILED "Test.xml does not contain a passed test:\n ${test_xml}")
+  elseif(NOT test_xml MATCHES "<Value encoding=\"base64\" compression=\"gzip\">")
+    set(RunCMake_TEST_FAILED "Test.xml output is not compressed:\n ${test_xml}")
+  elseif(NOT test_xml MATCHES "<NamedMeasurement type=\"numeric/double\" name=\"SpillMeasure\">[\n\t]*<Value>42</Value>")
+    set(RunCMake_TEST_FAILED "Test.xml does not contain the spilled measurement:\n ${test_xml}")
+  endif()
+else()
+  set(RunCMake_TEST_FAILED "Test.xml not found")
+endif()
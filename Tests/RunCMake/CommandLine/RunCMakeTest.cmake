@@ -126,6 +126,10 @@ run_cmake_command(E_copy_if_different-three-source-files-target-is-directory
   ${CMAKE_COMMAND} -E copy_if_different ${in}/f1.txt ${in}/f2.txt ${in}/f3.txt ${out})
 run_cmake_command(E_copy_if_different-three-source-files-target-is-file
   ${CMAKE_COMMAND} -E copy_if_different ${in}/f1.txt ${in}/f2.txt ${in}/f3.txt ${out}/f1.txt)
+run_cmake_command(E_sha256sum
+  ${CMAKE_COMMAND} -E sha256sum ${in}/f1.txt ${in}/f2.txt)
+run_cmake_command(E_sha512sum-bad
+  ${CMAKE_COMMAND} -E sha512sum ${in}/f1.txt ${in}/d1 ${in}/not_existing_file.bad)
 unset(in)
 unset(out)
 
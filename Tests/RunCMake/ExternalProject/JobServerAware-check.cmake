@@ -0,0 +1,30 @@
+# Only the Makefile generators driving a GNU-compatible make mark
+# jobserver-aware steps in the generated build files.
+if(NOT RunCMake_GENERATOR MATCHES "^(Unix|MSYS|MinGW) Makefiles$")
+  return()
+endif()
+
+macro(CheckMakeStep _target _command _require)
+  set(_build_file
+    "${RunCMake_TEST_BINARY_DIR}/CMakeFiles/${_target}.dir/build.make")
+  if(NOT EXISTS "${_build_file}")
+    set(RunCMake_TEST_FAILED "${_build_file} not created")
+    return()
+  endif()
+  file(READ "${_build_file}" _build)
+  if("${_build}" MATCHES "\n\t\\+[^\n]* -E echo ${_command}\n")
+    if(NOT ${_require})
+      set(RunCMake_TEST_FAILED "${_target} ${_command} step is jobserver-aware")
+      return()
+    endif()
+  else()
+    if(${_require})
+      set(RunCMake_TEST_FAILED "${_target} ${_command} step not jobserver-aware")
+      return()
+    endif()
+  endif()
+endmacro()
+
+CheckMakeStep(JobServerTest1 build 1)
+CheckMakeStep(JobServerTest2 build 0)
+CheckMakeStep(JobServerTest2 extra 1)
@@ -0,0 +1,21 @@
+include(ExternalProject)
+
+ExternalProject_Add(JobServerTest1
+  DOWNLOAD_COMMAND ""
+  CONFIGURE_COMMAND ""
+  BUILD_COMMAND "${CMAKE_COMMAND}" -E echo "build"
+  INSTALL_COMMAND ""
+  BUILD_JOB_SERVER_AWARE 1
+  )
+
+ExternalProject_Add(JobServerTest2
+  DOWNLOAD_COMMAND ""
+  CONFIGURE_COMMAND ""
+  BUILD_COMMAND "${CMAKE_COMMAND}" -E echo "build"
+  INSTALL_COMMAND ""
+  )
+ExternalProject_Add_Step(JobServerTest2 extra
+  COMMAND "${CMAKE_COMMAND}" -E echo "extra"
+  DEPENDEES build
+  JOB_SERVER_AWARE 1
+  )
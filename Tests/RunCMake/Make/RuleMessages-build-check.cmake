@@ -0,0 +1,35 @@
+set(dir "${RunCMake_TEST_BINARY_DIR}/CMakeFiles")
+
+# The rule messages use the cmecho helper when it is next to cmake.
+get_filename_component(bin "${CMAKE_COMMAND}" DIRECTORY)
+if(EXISTS "${bin}/cmecho${CMAKE_EXECUTABLE_SUFFIX}")
+  set(echo "\\$\\(CMAKE_ECHO_COMMAND\\) --switch=\\$\\(COLOR\\)")
+else()
+  set(echo "\\$\\(CMAKE_COMMAND\\) -E cmake_echo_color --switch=\\$\\(COLOR\\)")
+endif()
+file(READ "${dir}/RuleMessages.dir/build.make" build_make)
+if(NOT build_make MATCHES "${echo} --blue --bold --progress-dir=[^\n]* --progress-num=[^ ]+ \"Generating the main source\"")
+  set(RunCMake_TEST_FAILED "build.make does not echo rule messages with:\n  ${echo}")
+  return()
+endif()
+
+# The progress directory is removed when the build finishes.
+if(EXISTS "${dir}/Progress")
+  set(RunCMake_TEST_FAILED "Progress directory left behind:\n  ${dir}/Progress")
+  return()
+endif()
+
+# Percentages never go backwards.
+set(last 0)
+string(REGEX MATCHALL "\\[ *[0-9]+%\\]" percents "${actual_stdout}")
+foreach(p IN LISTS percents)
+  string(REGEX REPLACE "[^0-9]" "" p "${p}")
+  if(p LESS last)
+    set(RunCMake_TEST_FAILED "Progress went from ${last}% to ${p}%:\n${actual_stdout}")
+    return()
+  endif()
+  set(last ${p})
+endforeach()
+if(NOT last EQUAL 100)
+  set(RunCMake_TEST_FAILED "Progress did not reach 100%:\n${actual_stdout}")
+endif()
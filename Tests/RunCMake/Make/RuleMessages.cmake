@@ -0,0 +1,7 @@
+enable_language(C)
+add_custom_command(
+  OUTPUT RuleMessages.c
+  COMMAND ${CMAKE_COMMAND} -E copy ${CMAKE_CURRENT_SOURCE_DIR}/RuleMessages.c.in RuleMessages.c
+  COMMENT "Generating the main source"
+  )
+add_executable(RuleMessages RuleMessages.c)
@@ -15,3 +15,14 @@ run_TargetMessages(OFF)
 
 run_TargetMessages(VAR-ON -DCMAKE_TARGET_MESSAGES=ON)
 run_TargetMessages(VAR-OFF -DCMAKE_TARGET_MESSAGES=OFF)
+
+function(run_RuleMessages)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/RuleMessages-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  set(RunCMake_TEST_OPTIONS -DCMAKE_COLOR_MAKEFILE=ON)
+  run_cmake(RuleMessages)
+  run_cmake_command(RuleMessages-build ${CMAKE_COMMAND} --build .)
+endfunction()
+run_RuleMessages()
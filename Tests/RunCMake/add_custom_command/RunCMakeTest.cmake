@@ -9,4 +9,5 @@ run_cmake(OutputAndTarget)
 run_cmake(SourceByproducts)
 run_cmake(SourceUsesTerminal)
 run_cmake(TargetImported)
+run_cmake(TargetJobServerAware)
 run_cmake(TargetNotInDir)
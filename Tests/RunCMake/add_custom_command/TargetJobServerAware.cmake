@@ -0,0 +1,2 @@
+add_custom_target(t)
+add_custom_command(TARGET t POST_BUILD COMMAND t JOB_SERVER_AWARE)
@@ -40,3 +40,27 @@ function(run_BuildChangeId)
   run_ctest(BuildChangeId)
 endfunction()
 run_BuildChangeId()
+
+function(run_BuildScrape)
+  set(CASE_CMAKELISTS_SUFFIX_CODE [[
+add_custom_target(BuildScrape ALL
+  COMMAND ${CMAKE_COMMAND} -E echo "src/a.c:10: warning: unused variable"
+  COMMAND ${CMAKE_COMMAND} -E echo "src/b.c:20: error: bad thing"
+  COMMAND ${CMAKE_COMMAND} -E echo "src/c.c:30: note: see declaration"
+  COMMAND ${CMAKE_COMMAND} -E echo "Everything is fine here"
+  COMMAND ${CMAKE_COMMAND} -E echo "OOPS42 went wrong"
+  COMMAND ${CMAKE_COMMAND} -E echo "Oops: something else"
+  )
+]])
+  set(CASE_TEST_SUFFIX_CODE [[
+file(WRITE "${CTEST_BINARY_DIRECTORY}/CTestCustom.cmake" "
+set(CTEST_CUSTOM_ERROR_MATCH \"^(OOPS|Oops)[0-9]+\")
+set(CTEST_CUSTOM_WARNING_MATCH \"^Oops: some\")
+")
+ctest_read_custom_files("${CTEST_BINARY_DIRECTORY}")
+ctest_build(NUMBER_ERRORS errors NUMBER_WARNINGS warnings)
+message("errors=${errors} warnings=${warnings}")
+]])
+  run_ctest(BuildScrape)
+endfunction()
+run_BuildScrape()
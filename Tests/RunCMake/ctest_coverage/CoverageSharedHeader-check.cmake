@@ -0,0 +1,42 @@
+file(GLOB log_xml "${RunCMake_TEST_BINARY_DIR}/Testing/*/CoverageLog-*.xml")
+set(log "")
+foreach(f ${log_xml})
+  file(READ "${f}" content)
+  set(log "${log}${content}")
+endforeach()
+file(GLOB coverage_xml "${RunCMake_TEST_BINARY_DIR}/Testing/*/Coverage.xml")
+set(coverage "")
+if(coverage_xml)
+  file(READ "${coverage_xml}" coverage)
+endif()
+
+# Every line of the three files runs.  Each file is listed once.
+foreach(file_loc "one.c:2" "two.c:2" "shared.h:5")
+  string(REPLACE ":" ";" file_loc "${file_loc}")
+  list(GET file_loc 0 file)
+  list(GET file_loc 1 loc)
+  string(REPLACE "." "\\." file_re "${file}")
+  string(REGEX MATCHALL "<File Name=\"${file_re}\"" entries "${coverage}")
+  list(LENGTH entries count)
+  if(NOT count EQUAL 1)
+    set(RunCMake_TEST_FAILED "${file} listed ${count} times in Coverage.xml:\n ${coverage}")
+    return()
+  endif()
+  if(NOT coverage MATCHES "<File Name=\"${file_re}\"[^>]*>[ \t\r\n]*<LOCTested>${loc}</LOCTested>[ \t\r\n]*<LOCUnTested>0</LOCUnTested>")
+    set(RunCMake_TEST_FAILED "${file} does not have ${loc} tested and 0 untested lines:\n ${coverage}")
+    return()
+  endif()
+endforeach()
+if(NOT coverage MATCHES "<LOCTested>9</LOCTested>[ \t\r\n]*<LOCUntested>0</LOCUntested>")
+  set(RunCMake_TEST_FAILED "Coverage.xml totals are not 9 tested and 0 untested lines:\n ${coverage}")
+elseif(NOT log MATCHES [[<File Name="shared\.h"]])
+  set(RunCMake_TEST_FAILED "shared.h not found in coverage log:\n ${log}")
+elseif(NOT log MATCHES [[<Line Number="6" Count="5">    total \+= i;</Line>]])
+  set(RunCMake_TEST_FAILED "shared.h loop body count is not the sum over both objects:\n ${log}")
+elseif(RunCMake_TEST_BINARY_DIR MATCHES "Serial-build$")
+  if(IS_DIRECTORY "${RunCMake_TEST_BINARY_DIR}/Testing/CoverageInfo/gcov1")
+    set(RunCMake_TEST_FAILED "serial gcov run used per-process directories")
+  endif()
+elseif(NOT IS_DIRECTORY "${RunCMake_TEST_BINARY_DIR}/Testing/CoverageInfo/gcov2")
+  set(RunCMake_TEST_FAILED "gcov did not run in per-process directories")
+endif()
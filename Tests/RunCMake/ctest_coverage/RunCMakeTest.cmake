@@ -8,3 +8,24 @@ function(run_ctest_coverage CASE_NAME)
 endfunction()
 
 run_ctest_coverage(CoverageQuiet QUIET)
+# Two objects use the same header.  Their gcov runs happen in separate
+# directories and the header's line counts are added together.  The
+# serial and parallel runs must give the same per-file results.
+function(run_CoverageSharedHeader CASE_NAME PARALLEL_LEVEL)
+  file(REMOVE_RECURSE ${RunCMake_BINARY_DIR}/${CASE_NAME})
+  file(COPY ${RunCMake_SOURCE_DIR}/SharedHeader/
+    DESTINATION ${RunCMake_BINARY_DIR}/${CASE_NAME})
+  set(CASE_CMAKELISTS_SUFFIX_CODE [[
+enable_language(C)
+set(CMAKE_C_FLAGS "${CMAKE_C_FLAGS} --coverage")
+set(CMAKE_EXE_LINKER_FLAGS "${CMAKE_EXE_LINKER_FLAGS} --coverage")
+add_executable(shared one.c two.c)
+add_test(NAME shared COMMAND shared)
+]])
+  set(RunCMake-check-file CoverageSharedHeader-check.cmake)
+  run_ctest_coverage(${CASE_NAME} PARALLEL_LEVEL ${PARALLEL_LEVEL})
+endfunction()
+if(CMake_TEST_GCOV)
+  run_CoverageSharedHeader(CoverageSharedHeader 2)
+  run_CoverageSharedHeader(CoverageSharedHeaderSerial 1)
+endif()
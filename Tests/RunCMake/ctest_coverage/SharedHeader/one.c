@@ -0,0 +1,6 @@
+#include "shared.h"
+
+int one(void)
+{
+  return shared_sum(2);
+}
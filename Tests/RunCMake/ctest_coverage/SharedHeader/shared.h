@@ -0,0 +1,10 @@
+static int shared_sum(int n)
+{
+  int i;
+  int total = 0;
+  for (i = 0; i < n; ++i)
+    {
+    total += i;
+    }
+  return total;
+}
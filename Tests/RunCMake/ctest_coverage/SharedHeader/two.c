@@ -0,0 +1,8 @@
+#include "shared.h"
+
+extern int one(void);
+
+int main(void)
+{
+  return one() + shared_sum(3) == 4 ? 0 : 1;
+}
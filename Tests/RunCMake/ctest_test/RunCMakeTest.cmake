@@ -75,3 +75,17 @@ add_test(NAME FailingTest COMMAND ${CMAKE_COMMAND} -E no_such_command)
   run_ctest(TestOutputSize)
 endfunction()
 run_TestOutputSize()
+
+function(run_TestCacheResults)
+  set(CASE_CTEST_TEST_ARGS CACHE_RESULTS ON)
+  set(CASE_CMAKELISTS_SUFFIX_CODE [[
+file(WRITE "${CMAKE_CURRENT_SOURCE_DIR}/input.txt" "1")
+add_test(NAME InputTest COMMAND ${CMAKE_COMMAND} -E echo InputTest)
+set_tests_properties(InputTest PROPERTIES INPUTS "$<1:input.txt>")
+add_executable(DefaultTool IMPORTED)
+set_property(TARGET DefaultTool PROPERTY IMPORTED_LOCATION ${CMAKE_COMMAND})
+add_test(NAME DefaultTest COMMAND DefaultTool -E echo DefaultTest)
+  ]])
+  run_ctest(TestCacheResults)
+endfunction()
+run_TestCacheResults()
@@ -0,0 +1,14 @@
+file(READ "${RunCMake_TEST_BINARY_DIR}/CTestTestfile.cmake" testfile)
+set(cache_file "${RunCMake_TEST_BINARY_DIR}/Testing/Temporary/CTestResultCache.txt")
+if(NOT testfile MATCHES "INPUTS \"[^\"]*/TestCacheResults/input.txt\"")
+  set(RunCMake_TEST_FAILED "CTestTestfile.cmake does not name the input file:\n ${testfile}")
+elseif(testfile MATCHES "set_tests_properties\\(DefaultTest")
+  set(RunCMake_TEST_FAILED "CTestTestfile.cmake names inputs of a test without INPUTS:\n ${testfile}")
+elseif(NOT EXISTS "${cache_file}")
+  set(RunCMake_TEST_FAILED "Result cache not found")
+else()
+  file(READ "${cache_file}" cache)
+  if(NOT cache MATCHES "^[0-9a-f]+ InputTest\n$")
+    set(RunCMake_TEST_FAILED "Result cache does not hold exactly InputTest:\n ${cache}")
+  endif()
+endif()
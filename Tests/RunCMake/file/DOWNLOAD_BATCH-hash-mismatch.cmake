@@ -0,0 +1,6 @@
+file(DOWNLOAD_BATCH
+  FILE "file://${CMAKE_CURRENT_SOURCE_DIR}/DOWNLOAD-hash-mismatch.txt"
+    ${CMAKE_CURRENT_BINARY_DIR}/hash-mismatch.txt
+    EXPECTED_HASH SHA1=0123456789abcdef0123456789abcdef01234567
+  STATUS status
+  )
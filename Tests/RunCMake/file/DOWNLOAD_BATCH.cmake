@@ -0,0 +1,26 @@
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(dst ${CMAKE_CURRENT_BINARY_DIR}/dst)
+set(CMAKE_DOWNLOAD_CACHE ${CMAKE_CURRENT_BINARY_DIR}/cache)
+file(WRITE ${src}/a.txt "a")
+file(WRITE ${src}/b.txt "b")
+
+file(DOWNLOAD_BATCH
+  FILE "file://${src}/a.txt" ${dst}/a.txt
+    EXPECTED_HASH SHA1=86f7e437faa5a7fce15d1ddcb9eaeaea377667b8
+  FILE "file://${src}/b.txt" ${dst}/b.txt
+  PARALLEL_LEVEL 2
+  STATUS status
+  )
+message("status='${status}'")
+file(GLOB_RECURSE cached RELATIVE ${CMAKE_DOWNLOAD_CACHE} ${CMAKE_DOWNLOAD_CACHE}/*)
+message("cached='${cached}'")
+
+# A file with a known hash no longer needs its source.
+file(REMOVE ${src}/a.txt ${dst}/a.txt)
+file(DOWNLOAD "file://${src}/a.txt" ${dst}/a.txt
+  EXPECTED_HASH SHA1=86f7e437faa5a7fce15d1ddcb9eaeaea377667b8
+  STATUS status
+  )
+message("status='${status}'")
+file(READ ${dst}/a.txt content)
+message("content='${content}'")
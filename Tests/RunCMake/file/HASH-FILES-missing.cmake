@@ -0,0 +1,5 @@
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/a.txt "a")
+file(SHA256 hashes FILES
+  ${CMAKE_CURRENT_BINARY_DIR}/a.txt
+  ${CMAKE_CURRENT_SOURCE_DIR}/does_not_exist/file.txt
+  )
@@ -0,0 +1,22 @@
+set(files)
+foreach(f a b c)
+  file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/${f}.txt "${f}")
+  list(APPEND files ${CMAKE_CURRENT_BINARY_DIR}/${f}.txt)
+endforeach()
+
+file(SHA1 hashes FILES ${files})
+foreach(f ${files})
+  file(SHA1 ${f} hash)
+  list(APPEND expect ${hash})
+endforeach()
+if(NOT "${hashes}" STREQUAL "${expect}")
+  message(FATAL_ERROR "file(SHA1 FILES) returned\n  ${hashes}\nbut expected\n  ${expect}")
+endif()
+
+file(MD5 hashes FILES ${CMAKE_CURRENT_BINARY_DIR}/a.txt)
+message("${hashes}")
+
+file(SHA256 hashes FILES)
+if(NOT "${hashes}" STREQUAL "")
+  message(FATAL_ERROR "file(SHA256 FILES) with no files returned\n  ${hashes}")
+endif()
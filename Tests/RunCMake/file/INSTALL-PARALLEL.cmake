@@ -0,0 +1,41 @@
+set(CMAKE_INSTALL_PARALLEL_LEVEL 4)
+set(src ${CMAKE_CURRENT_BINARY_DIR}/src)
+set(dst ${CMAKE_CURRENT_BINARY_DIR}/dst)
+file(REMOVE RECURSE ${src} ${dst})
+
+set(files)
+foreach(i RANGE 10 39)
+  file(WRITE ${src}/f${i}.txt "content ${i}\n")
+  list(APPEND files ${src}/f${i}.txt)
+endforeach()
+file(WRITE ${src}/ro/a.txt "a\n")
+file(WRITE ${src}/ro/b.txt "b\n")
+
+set(CMAKE_INSTALL_MANIFEST_FILES "")
+file(INSTALL ${files} DESTINATION ${dst})
+file(INSTALL ${src}/ro DESTINATION ${dst}
+  DIRECTORY_PERMISSIONS OWNER_READ OWNER_EXECUTE)
+file(INSTALL ${files} DESTINATION ${dst})
+
+foreach(i RANGE 10 39)
+  file(READ ${dst}/f${i}.txt content)
+  if(NOT content STREQUAL "content ${i}\n")
+    message(SEND_ERROR "f${i}.txt has wrong content:\n ${content}")
+  endif()
+endforeach()
+file(READ ${dst}/ro/b.txt content)
+if(NOT content STREQUAL "b\n")
+  message(SEND_ERROR "ro/b.txt has wrong content:\n ${content}")
+endif()
+
+list(LENGTH CMAKE_INSTALL_MANIFEST_FILES count)
+list(GET CMAKE_INSTALL_MANIFEST_FILES 0 first)
+list(GET CMAKE_INSTALL_MANIFEST_FILES 29 last)
+if(NOT count EQUAL 62 OR NOT first MATCHES "/f10.txt$"
+    OR NOT last MATCHES "/f39.txt$")
+  message(SEND_ERROR "Unexpected manifest:\n ${CMAKE_INSTALL_MANIFEST_FILES}")
+endif()
+
+if(UNIX)
+  execute_process(COMMAND chmod u+w ${dst}/ro)
+endif()
@@ -0,0 +1,19 @@
+set(script "${CMAKE_CURRENT_LIST_DIR}/shared-script.cmake")
+set(file_to_lock "${CMAKE_CURRENT_BINARY_DIR}/file-to-lock")
+
+file(LOCK "${file_to_lock}" SHARED WAIT_TIME_VARIABLE wait_time)
+if(NOT wait_time MATCHES "^[0-9]+\\.[0-9][0-9][0-9]$")
+  message(FATAL_ERROR "Unexpected wait time: ${wait_time}")
+endif()
+
+execute_process(
+    COMMAND "${CMAKE_COMMAND}" "-Dfile_to_lock=${file_to_lock}" -P "${script}"
+    RESULT_VARIABLE result
+    ERROR_VARIABLE error
+)
+
+message("${error}")
+
+if(NOT result EQUAL 0)
+  message(FATAL_ERROR "Result: ${result}")
+endif()
@@ -0,0 +1,33 @@
+enable_language(C)
+
+# Each library gets the build directory as its RPATH because it links
+# to the base library.  Reserve room for the replacement.
+file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/base.c" "int base(void) { return 0; }\n")
+add_library(base SHARED "${CMAKE_CURRENT_BINARY_DIR}/base.c")
+set(libs)
+foreach(n 1 2 3 4 5)
+  file(WRITE "${CMAKE_CURRENT_BINARY_DIR}/lib${n}.c"
+    "extern int base(void);\nint lib${n}(void) { return base(); }\n")
+  add_library(lib${n} SHARED "${CMAKE_CURRENT_BINARY_DIR}/lib${n}.c")
+  target_link_libraries(lib${n} base)
+  set_property(TARGET lib${n} PROPERTY INSTALL_RPATH "/new/rpath")
+  list(APPEND libs "$<TARGET_FILE:lib${n}>")
+endforeach()
+
+file(GENERATE OUTPUT "${CMAKE_CURRENT_BINARY_DIR}/change.cmake" CONTENT "
+set(files)
+foreach(lib ${libs})
+  get_filename_component(name \"\${lib}\" NAME)
+  file(COPY \"\${lib}\" DESTINATION \"${CMAKE_CURRENT_BINARY_DIR}/copy\")
+  list(APPEND files \"${CMAKE_CURRENT_BINARY_DIR}/copy/\${name}\")
+endforeach()
+file(RPATH_CHANGE FILES \${files}
+  OLD_RPATH \"${CMAKE_CURRENT_BINARY_DIR}\"
+  NEW_RPATH \"/new/rpath\")
+foreach(f \${files})
+  file(RPATH_CHECK FILE \"\${f}\" RPATH \"/new/rpath\")
+  if(NOT EXISTS \"\${f}\")
+    message(FATAL_ERROR \"RPATH of \${f} was not changed\")
+  endif()
+endforeach()
+")
@@ -1,9 +1,15 @@
 include(RunCMake)
 
 run_cmake(DOWNLOAD-hash-mismatch)
+run_cmake(DOWNLOAD_BATCH)
+run_cmake(DOWNLOAD_BATCH-hash-mismatch)
 run_cmake(INSTALL-DIRECTORY)
 run_cmake(INSTALL-MESSAGE-bad)
+run_cmake(INSTALL-PARALLEL)
 run_cmake(FileOpenFailRead)
+run_cmake(STRINGS-large)
+run_cmake(HASH-FILES)
+run_cmake(HASH-FILES-missing)
 run_cmake(LOCK)
 run_cmake(LOCK-error-file-create-fail)
 run_cmake(LOCK-error-guard-incorrect)
@@ -16,8 +22,10 @@ run_cmake(LOCK-error-no-guard)
 run_cmake(LOCK-error-no-path)
 run_cmake(LOCK-error-no-result-variable)
 run_cmake(LOCK-error-no-timeout)
+run_cmake(LOCK-error-no-wait-time-variable)
 run_cmake(LOCK-error-timeout)
 run_cmake(LOCK-error-unknown-option)
+run_cmake(LOCK-shared)
 run_cmake(GLOB)
 run_cmake(GLOB_RECURSE)
 # test is valid both for GLOB and GLOB_RECURSE
@@ -28,3 +36,16 @@ run_cmake(GLOB-error-LIST_DIRECTORIES-no-arg)
 if(NOT WIN32 OR CYGWIN)
   run_cmake(GLOB_RECURSE-cyclic-recursion)
 endif()
+
+if(CMake_TEST_ELF)
+  function(run_RPATH_CHANGE_FILES)
+    set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/RPATH_CHANGE-FILES-build)
+    set(RunCMake_TEST_NO_CLEAN 1)
+    file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+    file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+    run_cmake(RPATH_CHANGE-FILES)
+    run_cmake_command(RPATH_CHANGE-FILES-build ${CMAKE_COMMAND} --build .)
+    run_cmake_command(RPATH_CHANGE-FILES-change ${CMAKE_COMMAND} -P change.cmake)
+  endfunction()
+  run_RPATH_CHANGE_FILES()
+endif()
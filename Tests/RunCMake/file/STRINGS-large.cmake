@@ -0,0 +1,24 @@
+# Cover input larger than the block size used to scan the file.
+set(content "abcdefg\n")
+foreach(i RANGE 13)
+  set(content "${content}${content}")
+endforeach()
+set(f ${CMAKE_CURRENT_BINARY_DIR}/large.txt)
+file(WRITE ${f} "${content}")
+
+file(STRINGS ${f} out)
+list(LENGTH out n)
+message("all: ${n}")
+
+file(STRINGS ${f} out LIMIT_INPUT 65540)
+list(LENGTH out n)
+list(GET out -1 last)
+message("LIMIT_INPUT: ${n} ${last}")
+
+file(STRINGS ${f} out LENGTH_MAXIMUM 3)
+list(LENGTH out n)
+list(GET out -1 last)
+message("LENGTH_MAXIMUM: ${n} ${last}")
+
+file(STRINGS ${f} out LIMIT_COUNT 3)
+message("LIMIT_COUNT: ${out}")
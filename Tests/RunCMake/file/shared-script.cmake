@@ -0,0 +1,16 @@
+if(NOT file_to_lock)
+  message(FATAL_ERROR "file_to_lock is empty")
+endif()
+
+# Another reader gets the lock at once.
+file(LOCK "${file_to_lock}" SHARED TIMEOUT 0 RESULT_VARIABLE result)
+message("Shared: ${result}")
+file(LOCK "${file_to_lock}" RELEASE)
+
+# A writer waits for the reader until the timeout expires.
+file(LOCK "${file_to_lock}" TIMEOUT 1
+  RESULT_VARIABLE result WAIT_TIME_VARIABLE wait_time)
+message("Exclusive: ${result}")
+if(wait_time LESS 0.9)
+  message("Waited only ${wait_time} seconds")
+endif()
@@ -0,0 +1,9 @@
+file(READ ${RunCMake_TEST_BINARY_DIR}/root/share/data.txt data)
+if(NOT data STREQUAL "changed\n")
+  set(RunCMake_TEST_FAILED "Installed data.txt not updated:\n ${data}")
+endif()
+file(STRINGS ${RunCMake_TEST_BINARY_DIR}/install_hashes.txt hashes)
+list(LENGTH hashes count)
+if(NOT count EQUAL 3)
+  set(RunCMake_TEST_FAILED "install_hashes.txt does not have 3 lines:\n ${hashes}")
+endif()
@@ -0,0 +1,7 @@
+enable_language(C)
+set(CMAKE_INSTALL_HASH_MANIFEST ON)
+file(WRITE ${CMAKE_CURRENT_BINARY_DIR}/data.txt "data\n")
+install(FILES ${CMAKE_CURRENT_BINARY_DIR}/data.txt DESTINATION share)
+add_executable(myexe main.c)
+set_property(TARGET myexe PROPERTY INSTALL_RPATH "/opt/lib")
+install(TARGETS myexe DESTINATION bin)
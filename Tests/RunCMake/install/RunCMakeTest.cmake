@@ -41,6 +41,27 @@ in directory:
   endif()
 endfunction()
 
+# Install a project with content hashes, then again after touching the
+# files without changing them, and after changing one of them.
+function(run_install_hash_test case)
+  set(RunCMake_TEST_BINARY_DIR ${RunCMake_BINARY_DIR}/${case}-build)
+  set(RunCMake_TEST_NO_CLEAN 1)
+  file(REMOVE_RECURSE "${RunCMake_TEST_BINARY_DIR}")
+  file(MAKE_DIRECTORY "${RunCMake_TEST_BINARY_DIR}")
+  run_cmake(${case})
+  run_cmake_command(${case}-build ${CMAKE_COMMAND} --build . --config Debug)
+  set(install ${CMAKE_COMMAND} -DCMAKE_INSTALL_PREFIX=${RunCMake_TEST_BINARY_DIR}/root -DBUILD_TYPE=Debug -P cmake_install.cmake)
+  run_cmake_command(${case}-first ${install})
+  file(GLOB_RECURSE exe ${RunCMake_TEST_BINARY_DIR}/*myexe*)
+  list(FILTER exe EXCLUDE REGEX "/(root|CMakeFiles)/")
+  execute_process(COMMAND ${CMAKE_COMMAND} -E sleep 1)
+  file(WRITE ${RunCMake_TEST_BINARY_DIR}/data.txt "data\n")
+  execute_process(COMMAND ${CMAKE_COMMAND} -E touch ${exe})
+  run_cmake_command(${case}-same ${install})
+  file(WRITE ${RunCMake_TEST_BINARY_DIR}/data.txt "changed\n")
+  run_cmake_command(${case}-changed ${install})
+endfunction()
+
 run_cmake(DIRECTORY-MESSAGE_NEVER)
 run_cmake(DIRECTORY-PATTERN-MESSAGE_NEVER)
 run_cmake(DIRECTORY-message)
@@ -59,3 +80,4 @@ run_cmake(CMP0062-WARN)
 
 run_install_test(FILES-EXCLUDE_FROM_ALL)
 run_install_test(TARGETS-EXCLUDE_FROM_ALL)
+run_install_hash_test(HASH_MANIFEST)